@@ -0,0 +1,258 @@
+/*
+ * GuiarStr - Advanced C String Utilities Library
+ * 
+ * Author: GUIAR OQBA (c) 2025
+ * Email: techokba@gmail.com
+ * Website: https://okba14.github.io
+ * Repository: https://github.com/okba14/guiarstr
+ * 
+ * License: MIT License
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ */
+
+// Substring search throughput: guiarstr_find/guiarstr_count against the C library's strstr,
+// one-off view searches against a compiled GuiarStrPattern on short lines, and a keyword scrubber
+// looping over guiarstr_view_contains against a single GuiarStrMatcher pass per line, and
+// character-class scans against strcspn.
+// Build with optimizations (make bench, or CMAKE_BUILD_TYPE=Release) for meaningful numbers.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/guiarstr.h"
+
+#define HAYSTACK_SIZE (8u * 1024u * 1024u)
+#define ROUNDS 20
+
+static volatile size_t sink;
+
+static double seconds_since(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Log-like text: words from a small vocabulary, so first bytes of most needles are common
+static char* make_haystack(void) {
+    static const char* words[] = {
+        "GET", "POST", "/api/v1/users", "status=200", "latency_ms=12", "user_id=4821",
+        "INFO", "WARN", "request", "completed", "session", "token", "\n"
+    };
+    char* haystack = malloc(HAYSTACK_SIZE + 1);
+    if (!haystack) return NULL;
+    
+    unsigned int seed = 42;
+    size_t pos = 0;
+    while (pos < HAYSTACK_SIZE) {
+        seed = seed * 1103515245u + 12345u;
+        const char* word = words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+        size_t len = strlen(word);
+        if (pos + len + 1 > HAYSTACK_SIZE) break;
+        memcpy(haystack + pos, word, len);
+        pos += len;
+        haystack[pos++] = ' ';
+    }
+    memset(haystack + pos, ' ', HAYSTACK_SIZE - pos);
+    memcpy(haystack + HAYSTACK_SIZE - 10, "END-OF-LOG", 10);
+    haystack[HAYSTACK_SIZE] = '\0';
+    return haystack;
+}
+
+static size_t strstr_count(const char* haystack, const char* needle) {
+    size_t count = 0;
+    size_t len = strlen(needle);
+    for (const char* p = strstr(haystack, needle); p; p = strstr(p + len, needle)) {
+        count++;
+    }
+    return count;
+}
+
+static void bench_needle(const char* haystack, const char* label, const char* needle) {
+    double mib = (double)HAYSTACK_SIZE * ROUNDS / (1024.0 * 1024.0);
+    clock_t start;
+    
+    start = clock();
+    for (int i = 0; i < ROUNDS; i++) {
+        const char* found = strstr(haystack, needle);
+        sink += found ? (size_t)(found - haystack) : 0;
+    }
+    double libc_find = seconds_since(start);
+    
+    start = clock();
+    for (int i = 0; i < ROUNDS; i++) {
+        sink += guiarstr_find(haystack, needle);
+    }
+    double guiar_find = seconds_since(start);
+    
+    start = clock();
+    for (int i = 0; i < ROUNDS; i++) {
+        sink += strstr_count(haystack, needle);
+    }
+    double libc_count = seconds_since(start);
+    
+    start = clock();
+    for (int i = 0; i < ROUNDS; i++) {
+        sink += guiarstr_count(haystack, needle);
+    }
+    double guiar_count = seconds_since(start);
+    
+    printf("%-22s find: strstr %8.0f MiB/s  guiarstr %8.0f MiB/s | count: strstr %8.0f MiB/s  guiarstr %8.0f MiB/s\n",
+           label, mib / libc_find, mib / guiar_find, mib / libc_count, mib / guiar_count);
+}
+
+// Many short haystacks (one per log line): the per-call needle setup is what a pattern saves
+static void bench_lines(const char* haystack, const char* label, const char* needle) {
+    GuiarStrPattern* pattern = guiarstr_pattern_create(needle, 0);
+    GuiarStrView needle_view = guiarstr_view_from_cstr(needle);
+    GuiarStrView text = guiarstr_view_from(haystack, HAYSTACK_SIZE);
+    double mib = (double)HAYSTACK_SIZE * ROUNDS / (1024.0 * 1024.0);
+    clock_t start;
+    
+    start = clock();
+    for (int i = 0; i < ROUNDS; i++) {
+        GuiarStrTokenizer tok;
+        GuiarStrView line;
+        guiarstr_tokenizer_init(&tok, text.data, text.length, '\n');
+        while (guiarstr_tokenizer_next(&tok, &line)) {
+            sink += guiarstr_view_find(line, needle_view);
+        }
+    }
+    double one_off = seconds_since(start);
+    
+    start = clock();
+    for (int i = 0; i < ROUNDS; i++) {
+        GuiarStrTokenizer tok;
+        GuiarStrView line;
+        guiarstr_tokenizer_init(&tok, text.data, text.length, '\n');
+        while (guiarstr_tokenizer_next(&tok, &line)) {
+            sink += guiarstr_pattern_find(pattern, line);
+        }
+    }
+    double compiled = seconds_since(start);
+    
+    printf("%-22s per line: view_find %8.0f MiB/s  pattern_find %8.0f MiB/s\n", label, mib / one_off, mib / compiled);
+    guiarstr_pattern_free(pattern);
+}
+
+// A scrubber flagging lines that contain any of KEYWORDS patterns; the per-keyword loop only
+// gets a slice of the haystack since it costs one pass per keyword
+#define KEYWORDS 2000
+#define SCRUB_SLICE (256u * 1024u)
+
+static void bench_keywords(const char* haystack) {
+    static char storage[KEYWORDS][24];
+    GuiarStrView keywords[KEYWORDS];
+    for (int i = 0; i < KEYWORDS; i++) {
+        int len = snprintf(storage[i], sizeof(storage[i]), i % 2 ? "user_id=%d " : "token-%04d", i);
+        keywords[i] = guiarstr_view_from(storage[i], (size_t)len);
+    }
+    
+    GuiarStrMatcher* matcher = guiarstr_matcher_create(keywords, KEYWORDS, 0);
+    if (!matcher) return;
+    
+    GuiarStrTokenizer tok;
+    GuiarStrView line;
+    clock_t start;
+    
+    start = clock();
+    guiarstr_tokenizer_init(&tok, haystack, SCRUB_SLICE, '\n');
+    while (guiarstr_tokenizer_next(&tok, &line)) {
+        for (int i = 0; i < KEYWORDS; i++) {
+            if (guiarstr_view_contains(line, keywords[i])) {
+                sink++;
+                break;
+            }
+        }
+    }
+    double looped = seconds_since(start);
+    
+    start = clock();
+    for (int i = 0; i < ROUNDS; i++) {
+        guiarstr_tokenizer_init(&tok, haystack, HAYSTACK_SIZE, '\n');
+        while (guiarstr_tokenizer_next(&tok, &line)) {
+            sink += guiarstr_matcher_contains(matcher, line);
+        }
+    }
+    double automaton = seconds_since(start);
+    
+    printf("%-22s per line: contains loop %8.1f MiB/s  matcher %8.0f MiB/s\n", "2000 keywords",
+           (double)SCRUB_SLICE / (1024.0 * 1024.0) / looped,
+           (double)HAYSTACK_SIZE * ROUNDS / (1024.0 * 1024.0) / automaton);
+    guiarstr_matcher_free(matcher);
+}
+
+// Set sizes straddle the four-member compare path and the nibble-table path
+static void bench_charset(const char* haystack, const char* label, const char* chars) {
+    GuiarStrCharSet set;
+    guiarstr_charset_init(&set, chars);
+    double mib = (double)HAYSTACK_SIZE * ROUNDS / (1024.0 * 1024.0);
+    clock_t start;
+    
+    start = clock();
+    for (int i = 0; i < ROUNDS; i++) {
+        for (const char* p = haystack; *p; p++) {
+            p += strcspn(p, chars);
+            if (!*p) break;
+            sink++;
+        }
+    }
+    double libc = seconds_since(start);
+    
+    start = clock();
+    for (int i = 0; i < ROUNDS; i++) {
+        GuiarStrView rest = guiarstr_view_from(haystack, HAYSTACK_SIZE);
+        size_t pos = guiarstr_view_find_any_set(rest, &set);
+        while (pos != (size_t)-1) {
+            sink++;
+            rest = guiarstr_view_slice(rest, pos + 1, rest.length);
+            pos = guiarstr_view_find_any_set(rest, &set);
+        }
+    }
+    double compiled = seconds_since(start);
+    
+    printf("%-22s strcspn %8.0f MiB/s  charset %8.0f MiB/s\n", label, mib / libc, mib / compiled);
+}
+
+int main(void) {
+    char* haystack = make_haystack();
+    if (!haystack) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    
+    printf("Haystack: %u MiB, %d rounds per measurement\n", HAYSTACK_SIZE / (1024u * 1024u), ROUNDS);
+    bench_needle(haystack, "2 bytes (absent)", "q!");
+    bench_needle(haystack, "6 bytes (frequent)", "status");
+    bench_needle(haystack, "10 bytes (at the end)", "END-OF-LOG");
+    bench_needle(haystack, "9 bytes (absent)", "status=50");
+    bench_needle(haystack, "16 bytes (absent)", "completed token?");
+    bench_needle(haystack, "31 bytes (rare)", "user_id=4821 status=200 INFO\n ");
+    bench_needle(haystack, "64 bytes (absent)",
+                 "GET /api/v1/users status=200 latency_ms=12 user_id=4821 INFO!!!");
+    bench_needle(haystack, "200 bytes (absent)",
+                 "request completed session token request completed session token request completed session "
+                 "token request completed session token request completed session token request completed token?");
+    
+    printf("\nLine by line (tokenizer over the same haystack)\n");
+    bench_lines(haystack, "16 bytes", "completed token?");
+    bench_lines(haystack, "100 bytes", "GET /api/v1/users status=200 latency_ms=12 user_id=4821 INFO request completed "
+                                       "session token WARN!");
+    bench_keywords(haystack);
+    
+    printf("\nCharacter sets (every occurrence)\n");
+    bench_charset(haystack, "3 chars (absent)", "{}|");
+    bench_charset(haystack, "12 chars (absent)", "{}[]<>|~^`;!");
+    bench_charset(haystack, "12 chars (digits)", "0123456789{}");
+    
+    free(haystack);
+    return 0;
+}
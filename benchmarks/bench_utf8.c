@@ -0,0 +1,152 @@
+/*
+ * GuiarStr - Advanced C String Utilities Library
+ *
+ * Author: GUIAR OQBA (c) 2025
+ * Email: techokba@gmail.com
+ * Website: https://okba14.github.io
+ * Repository: https://github.com/okba14/guiarstr
+ *
+ * License: MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ */
+
+// UTF-8 validation throughput: guiarstr_utf8_error_offset and guiarstr_utf8_validate against a
+// byte-at-a-time strict validator, on text ranging from pure ASCII to four-byte emoji.
+// Build with optimizations (make bench, or CMAKE_BUILD_TYPE=Release) for meaningful numbers.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/guiarstr.h"
+
+#define TEXT_SIZE (8u * 1024u * 1024u)
+#define ROUNDS 20
+
+static volatile size_t sink;
+
+static double seconds_since(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Repeats words picked at random from the vocabulary until the buffer is full
+static char* make_text(const char* const* words, size_t word_count) {
+    char* text = malloc(TEXT_SIZE + 1);
+    if (!text) return NULL;
+
+    unsigned int seed = 42;
+    size_t pos = 0;
+    while (pos < TEXT_SIZE) {
+        seed = seed * 1103515245u + 12345u;
+        const char* word = words[(seed >> 16) % word_count];
+        size_t len = strlen(word);
+        if (pos + len + 1 > TEXT_SIZE) break;
+        memcpy(text + pos, word, len);
+        pos += len;
+        text[pos++] = ' ';
+    }
+    memset(text + pos, ' ', TEXT_SIZE - pos);
+    text[TEXT_SIZE] = '\0';
+    return text;
+}
+
+// One sequence per iteration with explicit range checks on the second byte
+static size_t bytewise_error(const unsigned char* s, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        unsigned char c = s[i];
+        if (c < 0x80) {
+            i++;
+            continue;
+        }
+
+        size_t need;
+        unsigned char lo = 0x80, hi = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF) {
+            need = 1;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            need = 2;
+            if (c == 0xE0) lo = 0xA0;
+            if (c == 0xED) hi = 0x9F;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            need = 3;
+            if (c == 0xF0) lo = 0x90;
+            if (c == 0xF4) hi = 0x8F;
+        } else {
+            return i;
+        }
+
+        if (need > len - i - 1 || s[i + 1] < lo || s[i + 1] > hi) return i;
+        for (size_t k = 2; k <= need; k++) {
+            if ((s[i + k] & 0xC0) != 0x80) return i;
+        }
+        i += need + 1;
+    }
+    return (size_t)-1;
+}
+
+static void bench_text(const char* label, const char* const* words, size_t word_count) {
+    char* text = make_text(words, word_count);
+    if (!text) return;
+
+    double mib = (double)TEXT_SIZE * ROUNDS / (1024.0 * 1024.0);
+    clock_t start;
+
+    start = clock();
+    for (int i = 0; i < ROUNDS; i++) {
+        sink += bytewise_error((const unsigned char*)text, TEXT_SIZE);
+    }
+    double bytewise = seconds_since(start);
+
+    start = clock();
+    for (int i = 0; i < ROUNDS; i++) {
+        sink += guiarstr_utf8_error_offset(text, TEXT_SIZE);
+    }
+    double offset = seconds_since(start);
+
+    start = clock();
+    for (int i = 0; i < ROUNDS; i++) {
+        sink += guiarstr_utf8_validate(text);
+    }
+    double validate = seconds_since(start);
+
+    printf("%-18s bytewise %8.0f MiB/s  error_offset %8.0f MiB/s  validate (strlen) %8.0f MiB/s\n", label,
+           mib / bytewise, mib / offset, mib / validate);
+    free(text);
+}
+
+int main(void) {
+    static const char* ascii[] = {
+        "GET", "/api/v1/users", "status=200", "latency_ms=12", "INFO", "request", "completed", "\n"
+    };
+    static const char* latin[] = {
+        "caf\xC3\xA9", "na\xC3\xAFve", "r\xC3\xA9sum\xC3\xA9", "stra\xC3\x9F" "e", "the", "and", "with", "\n"
+    };
+    static const char* arabic[] = {
+        "\xD9\x85\xD8\xB1\xD8\xAD\xD8\xA8\xD8\xA7", "\xD8\xB3\xD9\x84\xD8\xA7\xD9\x85", "\xD9\x83\xD8\xAA\xD8\xA7\xD8\xA8"
+    };
+    static const char* cjk[] = {
+        "\xE4\xBD\xA0\xE5\xA5\xBD", "\xE4\xB8\x96\xE7\x95\x8C", "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E", "\xE3\x81\x82"
+    };
+    static const char* emoji[] = {
+        "\xF0\x9F\x98\x8A", "\xF0\x9F\x9A\x80\xF0\x9F\x94\xA5", "ok", "\xE2\x9C\x93", "\xC3\xA9"
+    };
+
+    printf("Text: %u MiB, %d rounds per measurement\n", TEXT_SIZE / (1024u * 1024u), ROUNDS);
+    bench_text("ASCII", ascii, sizeof(ascii) / sizeof(ascii[0]));
+    bench_text("Latin (2-byte)", latin, sizeof(latin) / sizeof(latin[0]));
+    bench_text("Arabic (2-byte)", arabic, sizeof(arabic) / sizeof(arabic[0]));
+    bench_text("CJK (3-byte)", cjk, sizeof(cjk) / sizeof(cjk[0]));
+    bench_text("Emoji (mixed)", emoji, sizeof(emoji) / sizeof(emoji[0]));
+    return 0;
+}
@@ -32,6 +32,7 @@ extern "C" {
 #include <stddef.h>  // for size_t
 #include <stdbool.h> // for bool
 #include <stdarg.h>  // for va_list
+#include <stdint.h>  // for uint64_t
 
 // Error codes
 typedef enum {
@@ -44,11 +45,69 @@ typedef enum {
     GUIARSTR_ERR_NOT_FOUND
 } GuiarStrError;
 
+// Allocator hooks (ctx is passed back to every callback)
+
+typedef struct {
+    void* (*alloc)(void* ctx, size_t size);
+    void* (*realloc)(void* ctx, void* ptr, size_t old_size, size_t new_size);
+    void (*free)(void* ctx, void* ptr);
+    void* ctx;
+} GuiarStrAllocator;
+
+// Growth policy (capacities from page_size up are rounded to whole pages; buffers of at least
+// mmap_threshold bytes are mapped directly and grown with mremap where available; 0 disables)
+
+typedef struct {
+    double growth_factor;
+    size_t page_size;
+    size_t mmap_threshold;
+    bool huge_pages;
+} GuiarStrGrowthPolicy;
+
+// Pool statistics (for the calling thread)
+
+typedef struct {
+    size_t hits;
+    size_t misses;
+    size_t remote_frees;
+    size_t cached_blocks;
+    size_t cached_bytes;
+} GuiarStrPoolStats;
+
+// Arena allocator structure (bump allocation, memory is released all at once)
+
+typedef struct GuiarStrArenaBlock GuiarStrArenaBlock;
+
+typedef struct {
+    GuiarStrArenaBlock* first;
+    GuiarStrArenaBlock* current;
+    size_t block_size;
+    const GuiarStrAllocator* backing;
+    GuiarStrAllocator allocator;
+} GuiarStrArena;
+
+typedef struct {
+    GuiarStrArenaBlock* block;
+    size_t used;
+} GuiarStrArenaMark;
+
 // Dynamic string structure
+// Strings of up to 31 bytes are stored inline, in the same allocation as the header,
+// and move to their own buffer transparently when they grow.
+
+#define GUIARSTR_FLAG_INLINE   0x1u // data lives in the header allocation
+#define GUIARSTR_FLAG_BORROWED 0x2u // data is a caller-provided buffer
+#define GUIARSTR_FLAG_EMBEDDED 0x4u // the header itself is owned by the caller
+#define GUIARSTR_FLAG_SHARED   0x8u // data is reference-counted and copied on write
+#define GUIARSTR_FLAG_MAPPED   0x10u // data is an anonymous memory mapping
+
 typedef struct {
     char* data;
     size_t length;
     size_t capacity;
+    const GuiarStrAllocator* allocator;
+    const GuiarStrGrowthPolicy* policy; // NULL: the global policy
+    unsigned int flags;
 } GuiarStr;
 
 // String view structure (non-owning reference)
@@ -65,8 +124,100 @@ typedef struct {
     size_t parts_count;
     size_t parts_capacity;
     GuiarStrView* parts;
+    const GuiarStrAllocator* allocator;
 } GuiarStrBuilder;
 
+// Chunked builder structure (appends into fixed-size chunks that never move)
+
+typedef struct GuiarStrChunk GuiarStrChunk;
+
+typedef struct {
+    GuiarStrChunk* first;
+    GuiarStrChunk* last;
+    size_t chunk_size;
+    size_t length;
+    const GuiarStrAllocator* allocator;
+} GuiarStrChunkBuilder;
+
+// Rope structure (balanced tree of text chunks for cheap mid-text edits)
+
+typedef struct GuiarStrRopeNode GuiarStrRopeNode;
+
+typedef struct {
+    GuiarStrRopeNode* root;
+    unsigned int seed;
+    const GuiarStrAllocator* allocator;
+} GuiarStrRope;
+
+// Gap buffer structure (text is data[0, gap_start) followed by data[gap_end, capacity))
+
+typedef struct {
+    char* data;
+    size_t capacity;
+    size_t gap_start;
+    size_t gap_end;
+    const GuiarStrAllocator* allocator;
+} GuiarStrGap;
+
+// Search pattern structure (a needle preprocessed once and reused across haystacks)
+// Candidates are positions where needle[0] and needle[filter_offset] both match; the kernels
+// broadcast filter_bytes and OR the haystack with filter_fold (0x20 for case-folded letters).
+
+#define GUIARSTR_PATTERN_IGNORE_CASE 0x1 // ASCII letters match either case
+
+typedef struct {
+    char* needle; // lowercase copy under GUIARSTR_PATTERN_IGNORE_CASE
+    size_t length;
+    unsigned int options;
+    size_t filter_offset;
+    unsigned char filter_bytes[2];
+    unsigned char filter_fold[2];
+    size_t shift[256]; // byte-pair skip table for needles too long for the byte filter
+    size_t mismatch_shift;
+    const GuiarStrAllocator* allocator;
+} GuiarStrPattern;
+
+// Multi-pattern matcher (Aho-Corasick automaton stored as a dense DFA over byte classes)
+typedef struct GuiarStrMatcher GuiarStrMatcher;
+
+typedef struct {
+    size_t pattern; // index into the array the matcher was built from
+    size_t offset;
+    size_t length;
+} GuiarStrMatch;
+
+// Character set structure (256-bit membership bitmap plus the tables of the SIMD classifier)
+
+typedef struct {
+    uint8_t bits[32];      // bit c % 8 of bits[c / 8]
+    uint8_t rows[2][16];   // bit (c >> 4) & 7 of rows[c >> 7][c & 15], looked up by low nibble
+    unsigned char members[4]; // the first four members, repeated to fill the array
+    size_t count;
+} GuiarStrCharSet;
+
+// Tokenizer structure (the delimiter strings and pattern are borrowed, delimiter sets are copied)
+
+typedef enum {
+    GUIARSTR_TOKENIZE_CHAR,
+    GUIARSTR_TOKENIZE_STR,
+    GUIARSTR_TOKENIZE_ANY,
+    GUIARSTR_TOKENIZE_LINES,
+    GUIARSTR_TOKENIZE_PATTERN
+} GuiarStrTokenizeMode;
+
+typedef struct {
+    const char* data;
+    size_t length;
+    size_t pos;
+    const char* delimiter;
+    size_t delimiter_length;
+    char delimiter_char;
+    const GuiarStrPattern* pattern;
+    GuiarStrCharSet delimiter_set; // compiled delimiters of GUIARSTR_TOKENIZE_ANY
+    GuiarStrTokenizeMode mode;
+    bool done;
+} GuiarStrTokenizer;
+
 // Memory management
 
 GuiarStr* guiarstr_create(const char* str);
@@ -79,12 +230,93 @@ GuiarStrError guiarstr_reserve(GuiarStr* str, size_t new_capacity);
 GuiarStrError guiarstr_resize(GuiarStr* str, size_t new_length, char fill_char);
 GuiarStrError guiarstr_shrink_to_fit(GuiarStr* str);
 
+// Embedded strings (header on the stack or inside another struct)
+// Release with guiarstr_deinit(). A buffer-backed string moves to the heap only when it
+// outgrows the buffer; the buffer must outlive the string until then.
+
+GuiarStrError guiarstr_init(GuiarStr* str, const char* init);
+GuiarStrError guiarstr_init_empty(GuiarStr* str, size_t initial_capacity);
+GuiarStrError guiarstr_init_with_buffer(GuiarStr* str, char* buffer, size_t capacity);
+void guiarstr_deinit(GuiarStr* str);
+
+// Shared (copy-on-write) strings
+// guiarstr_copy() of a shared string only takes a reference (atomic, safe across threads);
+// the mutating functions clone the data first while other references exist.
+
+GuiarStr* guiarstr_create_shared(const char* str);
+GuiarStrError guiarstr_share(GuiarStr* str);
+bool guiarstr_is_shared(const GuiarStr* str);
+
+// Allocator hooks
+// Objects keep the allocator they were created with. Plain char* results and split arrays
+// come from the global allocator: release them with guiarstr_dealloc() (or free() when the
+// default allocator is in use).
+
+void guiarstr_set_allocator(const GuiarStrAllocator* allocator);
+const GuiarStrAllocator* guiarstr_get_allocator(void);
+void guiarstr_dealloc(void* ptr);
+GuiarStr* guiarstr_create_with_allocator(const char* str, const GuiarStrAllocator* allocator);
+GuiarStr* guiarstr_create_empty_with_allocator(size_t initial_capacity, const GuiarStrAllocator* allocator);
+
+// Size-class pool
+// Opt in with guiarstr_set_allocator(guiarstr_pool_allocator()): allocations of up to 256 bytes
+// are served from per-thread free lists, and may be freed from any thread. Trim and stats apply
+// to the calling thread's cache.
+
+const GuiarStrAllocator* guiarstr_pool_allocator(void);
+void guiarstr_pool_trim(void);
+void guiarstr_pool_stats(GuiarStrPoolStats* stats);
+
+// Growth policy
+// Policies are referenced, not copied, and must outlive the strings using them.
+
+GuiarStrError guiarstr_set_growth_policy(const GuiarStrGrowthPolicy* policy);
+const GuiarStrGrowthPolicy* guiarstr_get_growth_policy(void);
+GuiarStrError guiarstr_set_str_growth_policy(GuiarStr* str, const GuiarStrGrowthPolicy* policy);
+
+// Arena allocation
+// Strings created from an arena are owned by it: guiarstr_free() is a no-op for them
+// and they become invalid after guiarstr_arena_reset() or a rewind past their creation.
+
+GuiarStrArena* guiarstr_arena_create(size_t block_size);
+void guiarstr_arena_free(GuiarStrArena* arena);
+void* guiarstr_arena_alloc(GuiarStrArena* arena, size_t size);
+GuiarStrArenaMark guiarstr_arena_mark(const GuiarStrArena* arena);
+void guiarstr_arena_rewind(GuiarStrArena* arena, GuiarStrArenaMark mark);
+void guiarstr_arena_reset(GuiarStrArena* arena);
+const GuiarStrAllocator* guiarstr_arena_allocator(GuiarStrArena* arena);
+
+GuiarStr* guiarstr_create_arena(GuiarStrArena* arena, const char* str);
+GuiarStr* guiarstr_create_len_arena(GuiarStrArena* arena, const char* str, size_t len);
+GuiarStr* guiarstr_create_empty_arena(GuiarStrArena* arena, size_t initial_capacity);
+GuiarStr* guiarstr_copy_arena(GuiarStrArena* arena, const GuiarStr* str);
+char* guiarstr_replace_arena(GuiarStrArena* arena, const char* str, const char* from, const char* to);
+char* guiarstr_replace_n_arena(GuiarStrArena* arena, const char* str, const char* from, const char* to, size_t max_replacements);
+char** guiarstr_split_arena(GuiarStrArena* arena, const char* str, char delimiter, size_t* count);
+char** guiarstr_split_str_arena(GuiarStrArena* arena, const char* str, const char* delimiter, size_t* count);
+char** guiarstr_split_any_arena(GuiarStrArena* arena, const char* str, const char* delimiters, size_t* count);
+char** guiarstr_split_lines_arena(GuiarStrArena* arena, const char* str, size_t* count);
+char* guiarstr_printf_arena(GuiarStrArena* arena, const char* fmt, ...);
+char* guiarstr_vprintf_arena(GuiarStrArena* arena, const char* fmt, va_list args);
+char* guiarstr_from_int_arena(GuiarStrArena* arena, int value);
+char* guiarstr_from_long_arena(GuiarStrArena* arena, long value);
+char* guiarstr_from_long_long_arena(GuiarStrArena* arena, long long value);
+char* guiarstr_from_uint_arena(GuiarStrArena* arena, unsigned int value);
+char* guiarstr_from_ulong_arena(GuiarStrArena* arena, unsigned long value);
+char* guiarstr_from_ulong_long_arena(GuiarStrArena* arena, unsigned long long value);
+char* guiarstr_from_float_arena(GuiarStrArena* arena, float value, int precision);
+char* guiarstr_from_double_arena(GuiarStrArena* arena, double value, int precision);
+
 // Basic operations (existing)
+// Trimming, case mapping and the *i comparisons use ASCII rules regardless of the C locale:
+// bytes >= 0x80 are never changed or folded, so UTF-8 text passes through intact.
 
 char* guiarstr_trim(char* str);
 char* guiarstr_strip(char* str, const char* chars_to_remove);
 void guiarstr_tolower(char* str);
 void guiarstr_toupper(char* str);
+void guiarstr_tolower_len(char* data, size_t len);
+void guiarstr_toupper_len(char* data, size_t len);
 
 // Dynamic string operations
 
@@ -92,8 +324,10 @@ GuiarStrError guiarstr_append(GuiarStr* str, const char* append);
 GuiarStrError guiarstr_append_len(GuiarStr* str, const char* append, size_t len);
 GuiarStrError guiarstr_append_char(GuiarStr* str, char c);
 GuiarStrError guiarstr_append_view(GuiarStr* str, const GuiarStrView* view);
+GuiarStrError guiarstr_append_str(GuiarStr* str, const GuiarStr* append);
 GuiarStrError guiarstr_insert(GuiarStr* str, size_t pos, const char* insert);
 GuiarStrError guiarstr_insert_len(GuiarStr* str, size_t pos, const char* insert, size_t len);
+GuiarStrError guiarstr_insert_str(GuiarStr* str, size_t pos, const GuiarStr* insert);
 GuiarStrError guiarstr_insert_char(GuiarStr* str, size_t pos, char c);
 GuiarStrError guiarstr_remove(GuiarStr* str, size_t pos, size_t len);
 GuiarStrError guiarstr_clear(GuiarStr* str);
@@ -112,14 +346,38 @@ size_t guiarstr_count(const char* str, const char* substr);
 size_t guiarstr_find(const char* str, const char* substr);
 size_t guiarstr_find_from(const char* str, const char* substr, size_t from_pos);
 size_t guiarstr_rfind(const char* str, const char* substr);
+size_t guiarstr_rfind_from(const char* str, const char* substr, size_t from_pos);
 size_t guiarstr_find_char(const char* str, char c);
 size_t guiarstr_find_char_from(const char* str, char c, size_t from_pos);
 size_t guiarstr_rfind_char(const char* str, char c);
 size_t guiarstr_find_any(const char* str, const char* chars);
+size_t guiarstr_rfind_any(const char* str, const char* chars);
 size_t guiarstr_find_any_from(const char* str, const char* chars, size_t from_pos);
 size_t guiarstr_find_not_any(const char* str, const char* chars);
 size_t guiarstr_find_not_any_from(const char* str, const char* chars, size_t from_pos);
 
+// Character sets
+// Compile the member bytes once, then classify 32 bytes per step regardless of the set size
+// (AVX2 nibble lookup; without it sets of up to four bytes use SSE2 byte compares). The
+// functions taking chars strings above compile a set on the stack. Searches return
+// (size_t)-1 when nothing matches.
+
+GuiarStrError guiarstr_charset_init(GuiarStrCharSet* set, const char* chars);
+GuiarStrError guiarstr_charset_init_len(GuiarStrCharSet* set, const char* chars, size_t len);
+void guiarstr_charset_add(GuiarStrCharSet* set, unsigned char c);
+bool guiarstr_charset_contains(const GuiarStrCharSet* set, unsigned char c);
+size_t guiarstr_find_any_from_set(const char* str, const GuiarStrCharSet* set, size_t from_pos);
+size_t guiarstr_find_not_any_from_set(const char* str, const GuiarStrCharSet* set, size_t from_pos);
+size_t guiarstr_rfind_any_set(const char* str, const GuiarStrCharSet* set);
+char* guiarstr_strip_set(char* str, const GuiarStrCharSet* set);
+char* guiarstr_remove_chars_set(const char* str, const GuiarStrCharSet* set);
+char** guiarstr_split_any_set(const char* str, const GuiarStrCharSet* set, size_t* count);
+GuiarStrView guiarstr_view_strip_set(GuiarStrView view, const GuiarStrCharSet* set);
+size_t guiarstr_view_find_any_set(GuiarStrView view, const GuiarStrCharSet* set);
+size_t guiarstr_view_find_not_any_set(GuiarStrView view, const GuiarStrCharSet* set);
+size_t guiarstr_view_rfind_any_set(GuiarStrView view, const GuiarStrCharSet* set);
+size_t guiarstr_view_split_any_set(GuiarStrView view, const GuiarStrCharSet* set, GuiarStrView* views, size_t max_views);
+
 // String modification (existing with improvements)
 
 char* guiarstr_reverse(const char* str);
@@ -136,20 +394,228 @@ char** guiarstr_split_any(const char* str, const char* delimiters, size_t* count
 char** guiarstr_split_lines(const char* str, size_t* count);
 void guiarstr_split_free(char** tokens, size_t count);
 char* guiarstr_join(char** strings, size_t count, const char* separator);
-char* guiarstr_join_views(GuiarStrView* views, size_t count, const char* separator);
+char* guiarstr_join_views(const GuiarStrView* views, size_t count, const char* separator);
+
+// Zero-copy split (views point into the source string)
+// The *_view functions fill at most max_views entries and return the total token count,
+// so passing NULL/0 only counts. The *_view_alloc functions use a single allocation.
+
+size_t guiarstr_split_view(const char* str, char delimiter, GuiarStrView* views, size_t max_views);
+size_t guiarstr_split_str_view(const char* str, const char* delimiter, GuiarStrView* views, size_t max_views);
+size_t guiarstr_split_any_view(const char* str, const char* delimiters, GuiarStrView* views, size_t max_views);
+size_t guiarstr_split_lines_view(const char* str, GuiarStrView* views, size_t max_views);
+GuiarStrView* guiarstr_split_view_alloc(const char* str, char delimiter, size_t* count);
+GuiarStrView* guiarstr_split_str_view_alloc(const char* str, const char* delimiter, size_t* count);
+GuiarStrView* guiarstr_split_any_view_alloc(const char* str, const char* delimiters, size_t* count);
+GuiarStrView* guiarstr_split_lines_view_alloc(const char* str, size_t* count);
+void guiarstr_split_view_free(GuiarStrView* views);
+
+// Streaming tokenizer (lazy, allocation-free split over a length-delimited buffer)
+
+GuiarStrError guiarstr_tokenizer_init(GuiarStrTokenizer* tok, const char* str, size_t len, char delimiter);
+GuiarStrError guiarstr_tokenizer_init_str(GuiarStrTokenizer* tok, const char* str, size_t len, const char* delimiter);
+GuiarStrError guiarstr_tokenizer_init_any(GuiarStrTokenizer* tok, const char* str, size_t len, const char* delimiters);
+GuiarStrError guiarstr_tokenizer_init_lines(GuiarStrTokenizer* tok, const char* str, size_t len);
+GuiarStrError guiarstr_tokenizer_init_set(GuiarStrTokenizer* tok, const char* str, size_t len, const GuiarStrCharSet* delimiters);
+GuiarStrError guiarstr_tokenizer_init_pattern(GuiarStrTokenizer* tok, const char* str, size_t len, const GuiarStrPattern* delimiter);
+bool guiarstr_tokenizer_next(GuiarStrTokenizer* tok, GuiarStrView* token);
+void guiarstr_tokenizer_reset(GuiarStrTokenizer* tok);
+
+// String views
+// Views are passed by value and never read past their length, so they work on slices that are
+// not NUL-terminated. Slicing clamps to the view; searches return (size_t)-1 when nothing matches.
+
+GuiarStrView guiarstr_view_from(const char* data, size_t length);
+GuiarStrView guiarstr_view_from_cstr(const char* str);
+GuiarStrView guiarstr_view_from_str(const GuiarStr* str);
+GuiarStrView guiarstr_view_slice(GuiarStrView view, size_t pos, size_t len);
+GuiarStrView guiarstr_view_trim(GuiarStrView view);
+GuiarStrView guiarstr_view_trim_left(GuiarStrView view);
+GuiarStrView guiarstr_view_trim_right(GuiarStrView view);
+GuiarStrView guiarstr_view_strip(GuiarStrView view, GuiarStrView chars);
+bool guiarstr_view_equals(GuiarStrView a, GuiarStrView b);
+int guiarstr_view_compare(GuiarStrView a, GuiarStrView b);
+bool guiarstr_view_startswith(GuiarStrView view, GuiarStrView prefix);
+bool guiarstr_view_endswith(GuiarStrView view, GuiarStrView suffix);
+bool guiarstr_view_equalsi(GuiarStrView a, GuiarStrView b);
+bool guiarstr_view_startswithi(GuiarStrView view, GuiarStrView prefix);
+bool guiarstr_view_endswithi(GuiarStrView view, GuiarStrView suffix);
+bool guiarstr_view_contains(GuiarStrView view, GuiarStrView needle);
+size_t guiarstr_view_count(GuiarStrView view, GuiarStrView needle);
+size_t guiarstr_view_find(GuiarStrView view, GuiarStrView needle);
+size_t guiarstr_view_find_from(GuiarStrView view, GuiarStrView needle, size_t from_pos);
+size_t guiarstr_view_rfind(GuiarStrView view, GuiarStrView needle);
+size_t guiarstr_view_rfind_from(GuiarStrView view, GuiarStrView needle, size_t from_pos);
+size_t guiarstr_view_find_char(GuiarStrView view, char c);
+size_t guiarstr_view_rfind_char(GuiarStrView view, char c);
+size_t guiarstr_view_find_any(GuiarStrView view, GuiarStrView chars);
+size_t guiarstr_view_rfind_any(GuiarStrView view, GuiarStrView chars);
+size_t guiarstr_view_find_not_any(GuiarStrView view, GuiarStrView chars);
+size_t guiarstr_view_split(GuiarStrView view, char delimiter, GuiarStrView* views, size_t max_views);
+size_t guiarstr_view_split_str(GuiarStrView view, GuiarStrView delimiter, GuiarStrView* views, size_t max_views);
+size_t guiarstr_view_split_any(GuiarStrView view, GuiarStrView delimiters, GuiarStrView* views, size_t max_views);
+size_t guiarstr_view_split_lines(GuiarStrView view, GuiarStrView* views, size_t max_views);
+size_t guiarstr_view_utf8_len(GuiarStrView view);
+size_t guiarstr_view_utf8_char_len(GuiarStrView view, size_t byte_pos);
+size_t guiarstr_view_utf8_byte_pos(GuiarStrView view, size_t char_pos);
+bool guiarstr_view_utf8_validate(GuiarStrView view);
+size_t guiarstr_view_utf8_error_offset(GuiarStrView view);
+GuiarStrView guiarstr_view_utf8_substring(GuiarStrView view, size_t char_pos, size_t char_len);
+uint64_t guiarstr_view_hash(GuiarStrView view);
+
+// Search patterns
+// Compile a needle once, then search any number of haystacks with no per-call setup. Matches
+// are non-overlapping; guiarstr_pattern_find_all() fills at most max_positions offsets and
+// returns the total match count.
+
+GuiarStrPattern* guiarstr_pattern_create(const char* needle, unsigned int options);
+GuiarStrPattern* guiarstr_pattern_create_len(const char* needle, size_t len, unsigned int options);
+void guiarstr_pattern_free(GuiarStrPattern* pattern);
+size_t guiarstr_pattern_find(const GuiarStrPattern* pattern, GuiarStrView haystack);
+size_t guiarstr_pattern_find_from(const GuiarStrPattern* pattern, GuiarStrView haystack, size_t from_pos);
+size_t guiarstr_pattern_rfind(const GuiarStrPattern* pattern, GuiarStrView haystack);
+size_t guiarstr_pattern_count(const GuiarStrPattern* pattern, GuiarStrView haystack);
+size_t guiarstr_pattern_find_all(const GuiarStrPattern* pattern, GuiarStrView haystack, size_t* positions, size_t max_positions);
+char* guiarstr_replace_n_pattern(const char* str, const GuiarStrPattern* from, const char* to, size_t max_replacements);
+char** guiarstr_split_str_pattern(const char* str, const GuiarStrPattern* delimiter, size_t* count);
+
+// Case-insensitive search
+// ASCII letters match either case; other bytes, including UTF-8 sequences, match exactly. Each
+// call folds the needle once and compares the haystack in place, without a lowercased copy;
+// reuse a GuiarStrPattern with GUIARSTR_PATTERN_IGNORE_CASE for repeated searches.
+
+size_t guiarstr_find_i(const char* str, const char* substr);
+size_t guiarstr_find_from_i(const char* str, const char* substr, size_t from_pos);
+size_t guiarstr_rfind_i(const char* str, const char* substr);
+bool guiarstr_contains_i(const char* str, const char* substr);
+size_t guiarstr_count_i(const char* str, const char* substr);
+char* guiarstr_replace_i(const char* str, const char* from, const char* to);
+char* guiarstr_replace_n_i(const char* str, const char* from, const char* to, size_t max_replacements);
+size_t guiarstr_view_find_i(GuiarStrView view, GuiarStrView needle);
+size_t guiarstr_view_rfind_i(GuiarStrView view, GuiarStrView needle);
+bool guiarstr_view_contains_i(GuiarStrView view, GuiarStrView needle);
+size_t guiarstr_view_count_i(GuiarStrView view, GuiarStrView needle);
+
+// Multi-pattern matching
+// One pass over the text checks every pattern at once. guiarstr_matcher_find() reports the
+// leftmost match (longest on ties), guiarstr_matcher_find_all() every overlapping match in end
+// order, and guiarstr_matcher_hits() sets bit i of a (pattern_count + 7) / 8 byte bitmap when
+// pattern i occurs. guiarstr_matcher_replace() substitutes replacements[i] for pattern i over
+// the same non-overlapping leftmost-longest matches in a single scan, and
+// guiarstr_matcher_replace_str() rewrites a GuiarStr, in place when no replacement is longer
+// than its pattern. guiarstr_replace_many() and guiarstr_str_replace_many() build a throwaway
+// matcher for a one-off from[i] -> to[i] set.
+// Empty patterns are rejected; identical patterns all report, with find() preferring the lowest index.
+
+GuiarStrMatcher* guiarstr_matcher_create(const GuiarStrView* patterns, size_t count, unsigned int options);
+GuiarStrMatcher* guiarstr_matcher_create_cstr(const char* const* patterns, size_t count, unsigned int options);
+void guiarstr_matcher_free(GuiarStrMatcher* matcher);
+size_t guiarstr_matcher_pattern_count(const GuiarStrMatcher* matcher);
+bool guiarstr_matcher_contains(const GuiarStrMatcher* matcher, GuiarStrView text);
+bool guiarstr_matcher_find(const GuiarStrMatcher* matcher, GuiarStrView text, GuiarStrMatch* match);
+bool guiarstr_matcher_find_from(const GuiarStrMatcher* matcher, GuiarStrView text, size_t from_pos, GuiarStrMatch* match);
+size_t guiarstr_matcher_find_all(const GuiarStrMatcher* matcher, GuiarStrView text, GuiarStrMatch* matches, size_t max_matches);
+size_t guiarstr_matcher_hits(const GuiarStrMatcher* matcher, GuiarStrView text, unsigned char* bitmap);
+char* guiarstr_matcher_replace(const GuiarStrMatcher* matcher, GuiarStrView text, const GuiarStrView* replacements);
+GuiarStrError guiarstr_matcher_replace_str(const GuiarStrMatcher* matcher, GuiarStr* str, const GuiarStrView* replacements);
+char* guiarstr_replace_many(const char* str, const GuiarStrView* from, const GuiarStrView* to, size_t n);
+
+// Binary-safe GuiarStr operations
+// These honor str->length, so embedded NUL bytes are ordinary data. A NULL string behaves
+// as empty; searches return (size_t)-1 when nothing matches.
+
+size_t guiarstr_str_find(const GuiarStr* str, GuiarStrView needle);
+size_t guiarstr_str_find_from(const GuiarStr* str, GuiarStrView needle, size_t from_pos);
+size_t guiarstr_str_rfind(const GuiarStr* str, GuiarStrView needle);
+size_t guiarstr_str_count(const GuiarStr* str, GuiarStrView needle);
+size_t guiarstr_str_find_i(const GuiarStr* str, GuiarStrView needle);
+size_t guiarstr_str_count_i(const GuiarStr* str, GuiarStrView needle);
+bool guiarstr_str_contains(const GuiarStr* str, GuiarStrView needle);
+GuiarStrError guiarstr_str_replace(GuiarStr* str, GuiarStrView from, GuiarStrView to, size_t max_replacements);
+GuiarStrError guiarstr_str_replace_i(GuiarStr* str, GuiarStrView from, GuiarStrView to, size_t max_replacements);
+GuiarStrError guiarstr_str_replace_many(GuiarStr* str, const GuiarStrView* from, const GuiarStrView* to, size_t n);
+size_t guiarstr_str_split(const GuiarStr* str, GuiarStrView delimiter, GuiarStrView* views, size_t max_views);
+int guiarstr_str_compare(const GuiarStr* a, const GuiarStr* b);
+bool guiarstr_str_equals(const GuiarStr* a, const GuiarStr* b);
+uint64_t guiarstr_str_hash(const GuiarStr* str);
+GuiarStrError guiarstr_str_tolower(GuiarStr* str);
+GuiarStrError guiarstr_str_toupper(GuiarStr* str);
+GuiarStrError guiarstr_str_trim(GuiarStr* str);
 
 // String builder
 
 GuiarStrBuilder* guiarstr_builder_create(size_t initial_capacity);
+GuiarStrBuilder* guiarstr_builder_create_with_allocator(size_t initial_capacity, const GuiarStrAllocator* allocator);
 void guiarstr_builder_free(GuiarStrBuilder* builder);
+GuiarStrError guiarstr_builder_init(GuiarStrBuilder* builder, size_t initial_capacity);
+void guiarstr_builder_deinit(GuiarStrBuilder* builder);
 GuiarStrError guiarstr_builder_append(GuiarStrBuilder* builder, const char* str);
 GuiarStrError guiarstr_builder_append_view(GuiarStrBuilder* builder, const GuiarStrView* view);
 GuiarStrError guiarstr_builder_append_char(GuiarStrBuilder* builder, char c);
 GuiarStrError guiarstr_builder_append_fmt(GuiarStrBuilder* builder, const char* fmt, ...);
 GuiarStrError guiarstr_builder_append_fmt_va(GuiarStrBuilder* builder, const char* fmt, va_list args);
 GuiarStr* guiarstr_builder_build(GuiarStrBuilder* builder);
+GuiarStr* guiarstr_builder_take(GuiarStrBuilder* builder, bool shrink);
 GuiarStrError guiarstr_builder_reset(GuiarStrBuilder* builder);
 
+// Chunked builder
+// guiarstr_chunk_builder_views() returns the chunk count and fills up to max_views spans
+// (scatter/gather input); the data stays valid until the next append, reset or free.
+
+GuiarStrChunkBuilder* guiarstr_chunk_builder_create(size_t chunk_size);
+GuiarStrChunkBuilder* guiarstr_chunk_builder_create_with_allocator(size_t chunk_size, const GuiarStrAllocator* allocator);
+void guiarstr_chunk_builder_free(GuiarStrChunkBuilder* builder);
+GuiarStrError guiarstr_chunk_builder_append(GuiarStrChunkBuilder* builder, const char* str);
+GuiarStrError guiarstr_chunk_builder_append_len(GuiarStrChunkBuilder* builder, const char* str, size_t len);
+GuiarStrError guiarstr_chunk_builder_append_view(GuiarStrChunkBuilder* builder, const GuiarStrView* view);
+GuiarStrError guiarstr_chunk_builder_append_char(GuiarStrChunkBuilder* builder, char c);
+GuiarStrError guiarstr_chunk_builder_append_fmt(GuiarStrChunkBuilder* builder, const char* fmt, ...);
+GuiarStrError guiarstr_chunk_builder_append_fmt_va(GuiarStrChunkBuilder* builder, const char* fmt, va_list args);
+size_t guiarstr_chunk_builder_length(const GuiarStrChunkBuilder* builder);
+size_t guiarstr_chunk_builder_views(const GuiarStrChunkBuilder* builder, GuiarStrView* views, size_t max_views);
+GuiarStr* guiarstr_chunk_builder_flatten(const GuiarStrChunkBuilder* builder);
+GuiarStrError guiarstr_chunk_builder_write_fd(const GuiarStrChunkBuilder* builder, int fd);
+void guiarstr_chunk_builder_reset(GuiarStrChunkBuilder* builder);
+
+// Rope
+// Positions are byte offsets unless the function name says utf8. guiarstr_rope_views() returns
+// the number of chunk spans covering [pos, pos + len) and fills up to max_views of them.
+
+GuiarStrRope* guiarstr_rope_create(const char* str);
+GuiarStrRope* guiarstr_rope_create_len(const char* str, size_t len);
+GuiarStrRope* guiarstr_rope_from_str(const GuiarStr* str);
+void guiarstr_rope_free(GuiarStrRope* rope);
+size_t guiarstr_rope_length(const GuiarStrRope* rope);
+size_t guiarstr_rope_utf8_len(const GuiarStrRope* rope);
+GuiarStrError guiarstr_rope_insert(GuiarStrRope* rope, size_t pos, const char* str);
+GuiarStrError guiarstr_rope_insert_len(GuiarStrRope* rope, size_t pos, const char* str, size_t len);
+GuiarStrError guiarstr_rope_remove(GuiarStrRope* rope, size_t pos, size_t len);
+size_t guiarstr_rope_utf8_byte_pos(const GuiarStrRope* rope, size_t char_pos);
+GuiarStrError guiarstr_rope_utf8_insert(GuiarStrRope* rope, size_t char_pos, const char* utf8_str);
+GuiarStrError guiarstr_rope_utf8_remove(GuiarStrRope* rope, size_t char_pos, size_t char_len);
+GuiarStr* guiarstr_rope_substring(const GuiarStrRope* rope, size_t pos, size_t len);
+GuiarStr* guiarstr_rope_to_str(const GuiarStrRope* rope);
+size_t guiarstr_rope_views(const GuiarStrRope* rope, size_t pos, size_t len, GuiarStrView* views, size_t max_views);
+
+// Gap buffer
+// Edits happen at the cursor (the start of the gap); moving it only shifts the text in between.
+// guiarstr_gap_views() fills up to two segments and returns how many are non-empty.
+
+GuiarStrGap* guiarstr_gap_create(const char* str);
+GuiarStrGap* guiarstr_gap_create_empty(size_t initial_capacity);
+void guiarstr_gap_free(GuiarStrGap* gap);
+size_t guiarstr_gap_length(const GuiarStrGap* gap);
+size_t guiarstr_gap_cursor(const GuiarStrGap* gap);
+GuiarStrError guiarstr_gap_move_cursor(GuiarStrGap* gap, size_t pos);
+GuiarStrError guiarstr_gap_insert(GuiarStrGap* gap, const char* str);
+GuiarStrError guiarstr_gap_insert_len(GuiarStrGap* gap, const char* str, size_t len);
+GuiarStrError guiarstr_gap_insert_char(GuiarStrGap* gap, char c);
+GuiarStrError guiarstr_gap_delete_before(GuiarStrGap* gap, size_t len);
+GuiarStrError guiarstr_gap_delete_after(GuiarStrGap* gap, size_t len);
+size_t guiarstr_gap_views(const GuiarStrGap* gap, GuiarStrView views[2]);
+size_t guiarstr_gap_find(const GuiarStrGap* gap, const char* substr);
+GuiarStr* guiarstr_gap_to_str(const GuiarStrGap* gap);
+
 // Formatting
 
 char* guiarstr_printf(const char* fmt, ...);
@@ -168,6 +634,7 @@ GuiarStrError guiarstr_utf8_remove(GuiarStr* str, size_t char_pos, size_t char_l
 char* guiarstr_utf8_substring(const char* str, size_t char_pos, size_t char_len);
 char* guiarstr_utf8_reverse(const char* str);
 bool guiarstr_utf8_validate(const char* str);
+size_t guiarstr_utf8_error_offset(const char* data, size_t len); // First invalid byte, (size_t)-1 when valid
 size_t guiarstr_utf8_width(const char* str); // Display width for monospace fonts
 
 // Conversion
@@ -194,6 +661,7 @@ char* guiarstr_from_double(double value, int precision);
 GuiarStr* guiarstr_read_file(const char* filename, GuiarStrError* error);
 GuiarStrError guiarstr_write_file(const char* filename, const char* str, bool append);
 GuiarStrError guiarstr_write_file_view(const char* filename, const GuiarStrView* view, bool append);
+GuiarStrError guiarstr_write_file_str(const char* filename, const GuiarStr* str, bool append);
 
 // Error handling
 
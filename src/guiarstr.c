@@ -20,9 +20,12 @@
  * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
  */
 
+// mremap() and MAP_ANONYMOUS are GNU/BSD extensions
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
 
 #include "guiarstr.h"
-#include <ctype.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -30,11 +33,71 @@
 #include <stdarg.h>
 #include <errno.h>
 #include <limits.h>
+#include <stdint.h>
 #include <math.h>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define GUIARSTR_HAVE_WRITEV 1
+#define GUIARSTR_HAVE_MMAP 1
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#if defined(__linux__)
+#define GUIARSTR_HAVE_MREMAP 1
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#include <pthread.h>
+#define GUIARSTR_HAVE_POOL 1
+#endif
+#elif defined(_WIN32)
+#include <io.h>
+#endif
+
+// SIMD search kernels: SSE2 is the x86-64 baseline, AVX2 is selected at run time
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#include <immintrin.h>
+#define GUIARSTR_HAVE_SSE2 1
+#define GUIARSTR_HAVE_AVX2 1
+// Terminator scans load whole aligned blocks, which may extend past the string's allocation
+#define GUIARSTR_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#endif
+
 // Constants
 #define GUIARSTR_MIN_CAPACITY 16
 #define GUIARSTR_GROWTH_FACTOR 1.5
+#define GUIARSTR_PAGE_SIZE 4096
+#define GUIARSTR_MMAP_THRESHOLD (16u * 1024u * 1024u)
+#define GUIARSTR_SSO_CAPACITY 32
+#define GUIARSTR_ARENA_DEFAULT_BLOCK 4096
+#define GUIARSTR_ARENA_ALIGNMENT 16
+#define GUIARSTR_CHUNK_DEFAULT_SIZE 65536
+#define GUIARSTR_IOV_BATCH 64
+#define GUIARSTR_ROPE_CHUNK 1024
+#define GUIARSTR_ROPE_FILL 768 // leaves room for in-place inserts
+#define GUIARSTR_POOL_CLASSES 8
+#define GUIARSTR_POOL_MAX_CACHED 256 // per size class and thread
+#define GUIARSTR_SEARCH_SIMD_MAX 64 // longer needles use Horspool skips instead of the byte filter
+#define GUIARSTR_SEARCH_WINDOW 4096 // first slice of a C string measured before searching it
+#define GUIARSTR_SEARCH_WINDOW_MAX (256u * 1024u)
+
+// Reference counts of shared strings
+#if defined(__GNUC__) || defined(__clang__)
+#define GUIARSTR_ATOMIC_INC(p) __atomic_add_fetch((p), 1, __ATOMIC_RELAXED)
+#define GUIARSTR_ATOMIC_DEC(p) __atomic_sub_fetch((p), 1, __ATOMIC_ACQ_REL)
+#define GUIARSTR_ATOMIC_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define GUIARSTR_ATOMIC_INC(p) _InterlockedIncrement((volatile long*)(p))
+#define GUIARSTR_ATOMIC_DEC(p) _InterlockedDecrement((volatile long*)(p))
+#define GUIARSTR_ATOMIC_LOAD(p) _InterlockedOr((volatile long*)(p), 0)
+#else
+#define GUIARSTR_ATOMIC_INC(p) (++*(p))
+#define GUIARSTR_ATOMIC_DEC(p) (--*(p))
+#define GUIARSTR_ATOMIC_LOAD(p) (*(p))
+#endif
 
 // Error messages
 static const char* error_messages[] = {
@@ -47,1134 +110,5956 @@ static const char* error_messages[] = {
     "Substring not found"                  // GUIARSTR_ERR_NOT_FOUND
 };
 
-// Helper functions
-static GuiarStrError guiarstr_ensure_capacity(GuiarStr* str, size_t required) {
-    if (str->capacity >= required) {
-        return GUIARSTR_OK;
-    }
+// Allocator hooks
+static void* guiarstr_default_alloc(void* ctx, size_t size) {
+    (void)ctx;
+    return malloc(size);
+}
+
+static void* guiarstr_default_realloc(void* ctx, void* ptr, size_t old_size, size_t new_size) {
+    (void)ctx;
+    (void)old_size;
+    return realloc(ptr, new_size);
+}
+
+static void guiarstr_default_free(void* ctx, void* ptr) {
+    (void)ctx;
+    free(ptr);
+}
+
+static const GuiarStrAllocator guiarstr_default_allocator = {
+    guiarstr_default_alloc,
+    guiarstr_default_realloc,
+    guiarstr_default_free,
+    NULL
+};
+
+static const GuiarStrAllocator* guiarstr_global_allocator = &guiarstr_default_allocator;
+
+void guiarstr_set_allocator(const GuiarStrAllocator* allocator) {
+    guiarstr_global_allocator = allocator ? allocator : &guiarstr_default_allocator;
+}
+
+const GuiarStrAllocator* guiarstr_get_allocator(void) {
+    return guiarstr_global_allocator;
+}
+
+static const GuiarStrAllocator* guiarstr_resolve_allocator(const GuiarStrAllocator* allocator) {
+    return allocator ? allocator : guiarstr_global_allocator;
+}
+
+static void* guiarstr_mem_alloc(const GuiarStrAllocator* allocator, size_t size) {
+    allocator = guiarstr_resolve_allocator(allocator);
+    return allocator->alloc(allocator->ctx, size);
+}
+
+static void* guiarstr_mem_realloc(const GuiarStrAllocator* allocator, void* ptr, size_t old_size, size_t new_size) {
+    allocator = guiarstr_resolve_allocator(allocator);
+    return allocator->realloc(allocator->ctx, ptr, old_size, new_size);
+}
+
+static void guiarstr_mem_free(const GuiarStrAllocator* allocator, void* ptr) {
+    if (!ptr) return;
     
-    size_t new_capacity = str->capacity;
-    while (new_capacity < required) {
-        new_capacity = (size_t)(new_capacity * GUIARSTR_GROWTH_FACTOR);
-        if (new_capacity < str->capacity) { // Overflow check
-            return GUIARSTR_ERR_OVERFLOW;
-        }
+    allocator = guiarstr_resolve_allocator(allocator);
+    allocator->free(allocator->ctx, ptr);
+}
+
+void guiarstr_dealloc(void* ptr) {
+    guiarstr_mem_free(NULL, ptr);
+}
+
+// Arena allocator
+struct GuiarStrArenaBlock {
+    GuiarStrArenaBlock* next;
+    size_t size;
+    size_t used;
+};
+
+static char* guiarstr_arena_block_data(GuiarStrArenaBlock* block) {
+    return (char*)(block + 1);
+}
+
+static GuiarStrArenaBlock* guiarstr_arena_next_block(GuiarStrArena* arena, size_t min_size) {
+    GuiarStrArenaBlock* next = arena->current ? arena->current->next : arena->first;
+    
+    // Blocks kept by reset/rewind are reused before allocating new ones
+    if (next && next->size >= min_size) {
+        next->used = 0;
+        arena->current = next;
+        return next;
     }
     
-    char* new_data = realloc(str->data, new_capacity);
-    if (!new_data) {
-        return GUIARSTR_ERR_MEMORY;
+    size_t size = arena->block_size > min_size ? arena->block_size : min_size;
+    if (size > (size_t)-1 - sizeof(GuiarStrArenaBlock)) return NULL;
+    
+    GuiarStrArenaBlock* block = guiarstr_mem_alloc(arena->backing, sizeof(GuiarStrArenaBlock) + size);
+    if (!block) return NULL;
+    
+    block->size = size;
+    block->used = 0;
+    block->next = next;
+    
+    if (arena->current) {
+        arena->current->next = block;
+    } else {
+        arena->first = block;
     }
     
-    str->data = new_data;
-    str->capacity = new_capacity;
-    return GUIARSTR_OK;
+    arena->current = block;
+    return block;
 }
 
-// Memory management
-GuiarStr* guiarstr_create(const char* str) {
-    if (!str) {
-        return NULL;
-    }
+static void* guiarstr_arena_bump(GuiarStrArenaBlock* block, size_t size, size_t align) {
+    uintptr_t base = (uintptr_t)guiarstr_arena_block_data(block);
+    uintptr_t ptr = (base + block->used + align - 1) & ~(uintptr_t)(align - 1);
+    size_t offset = (size_t)(ptr - base);
     
-    size_t len = strlen(str);
-    GuiarStr* result = malloc(sizeof(GuiarStr));
-    if (!result) {
-        return NULL;
-    }
+    if (offset > block->size || size > block->size - offset) return NULL;
     
-    size_t capacity = len + 1;
-    if (capacity < GUIARSTR_MIN_CAPACITY) {
-        capacity = GUIARSTR_MIN_CAPACITY;
-    }
+    block->used = offset + size;
+    return (void*)ptr;
+}
+
+static void* guiarstr_arena_alloc_aligned(GuiarStrArena* arena, size_t size, size_t align) {
+    if (size > (size_t)-1 - align) return NULL;
     
-    result->data = malloc(capacity);
-    if (!result->data) {
-        free(result);
-        return NULL;
+    if (arena->current) {
+        void* ptr = guiarstr_arena_bump(arena->current, size, align);
+        if (ptr) return ptr;
     }
     
-    memcpy(result->data, str, len + 1);
-    result->length = len;
-    result->capacity = capacity;
+    GuiarStrArenaBlock* block = guiarstr_arena_next_block(arena, size + align - 1);
+    if (!block) return NULL;
     
-    return result;
+    return guiarstr_arena_bump(block, size, align);
 }
 
-GuiarStr* guiarstr_create_len(const char* str, size_t len) {
-    if (!str) {
-        return NULL;
+// Grows in place when ptr is the most recent allocation, otherwise moves it
+static void* guiarstr_arena_realloc(GuiarStrArena* arena, void* ptr, size_t old_size, size_t new_size) {
+    if (!ptr) return guiarstr_arena_alloc_aligned(arena, new_size, 1);
+    
+    GuiarStrArenaBlock* block = arena->current;
+    if (block) {
+        char* base = guiarstr_arena_block_data(block);
+        char* p = ptr;
+        if (p >= base && p + old_size == base + block->used && new_size <= block->size - (size_t)(p - base)) {
+            block->used = (size_t)(p - base) + new_size;
+            return ptr;
+        }
     }
     
-    GuiarStr* result = malloc(sizeof(GuiarStr));
-    if (!result) {
-        return NULL;
-    }
+    if (new_size <= old_size) return ptr;
     
-    size_t capacity = len + 1;
-    if (capacity < GUIARSTR_MIN_CAPACITY) {
-        capacity = GUIARSTR_MIN_CAPACITY;
-    }
+    void* new_ptr = guiarstr_arena_alloc_aligned(arena, new_size, 1);
+    if (!new_ptr) return NULL;
     
-    result->data = malloc(capacity);
-    if (!result->data) {
-        free(result);
-        return NULL;
+    memcpy(new_ptr, ptr, old_size);
+    return new_ptr;
+}
+
+// Arena memory is only reclaimed by reset/rewind
+static void* guiarstr_arena_alloc_hook(void* ctx, size_t size) {
+    return guiarstr_arena_alloc_aligned(ctx, size, GUIARSTR_ARENA_ALIGNMENT);
+}
+
+static void* guiarstr_arena_realloc_hook(void* ctx, void* ptr, size_t old_size, size_t new_size) {
+    return guiarstr_arena_realloc(ctx, ptr, old_size, new_size);
+}
+
+static void guiarstr_arena_free_hook(void* ctx, void* ptr) {
+    (void)ctx;
+    (void)ptr;
+}
+
+GuiarStrArena* guiarstr_arena_create(size_t block_size) {
+    const GuiarStrAllocator* backing = guiarstr_global_allocator;
+    GuiarStrArena* arena = guiarstr_mem_alloc(backing, sizeof(GuiarStrArena));
+    if (!arena) return NULL;
+    
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->block_size = block_size ? block_size : GUIARSTR_ARENA_DEFAULT_BLOCK;
+    arena->backing = backing;
+    arena->allocator.alloc = guiarstr_arena_alloc_hook;
+    arena->allocator.realloc = guiarstr_arena_realloc_hook;
+    arena->allocator.free = guiarstr_arena_free_hook;
+    arena->allocator.ctx = arena;
+    
+    return arena;
+}
+
+void guiarstr_arena_free(GuiarStrArena* arena) {
+    if (!arena) return;
+    
+    GuiarStrArenaBlock* block = arena->first;
+    while (block) {
+        GuiarStrArenaBlock* next = block->next;
+        guiarstr_mem_free(arena->backing, block);
+        block = next;
     }
     
-    memcpy(result->data, str, len);
-    result->data[len] = '\0';
-    result->length = len;
-    result->capacity = capacity;
+    guiarstr_mem_free(arena->backing, arena);
+}
+
+void* guiarstr_arena_alloc(GuiarStrArena* arena, size_t size) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
     
-    return result;
+    return guiarstr_arena_alloc_aligned(arena, size, GUIARSTR_ARENA_ALIGNMENT);
 }
 
-GuiarStr* guiarstr_create_empty(size_t initial_capacity) {
-    GuiarStr* result = malloc(sizeof(GuiarStr));
-    if (!result) {
-        return NULL;
-    }
+const GuiarStrAllocator* guiarstr_arena_allocator(GuiarStrArena* arena) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
     
-    if (initial_capacity < GUIARSTR_MIN_CAPACITY) {
-        initial_capacity = GUIARSTR_MIN_CAPACITY;
+    return &arena->allocator;
+}
+
+GuiarStrArenaMark guiarstr_arena_mark(const GuiarStrArena* arena) {
+    GuiarStrArenaMark mark = {NULL, 0};
+    
+    if (arena && arena->current) {
+        mark.block = arena->current;
+        mark.used = arena->current->used;
     }
     
-    result->data = malloc(initial_capacity);
-    if (!result->data) {
-        free(result);
-        return NULL;
+    return mark;
+}
+
+void guiarstr_arena_rewind(GuiarStrArena* arena, GuiarStrArenaMark mark) {
+    if (!arena) return;
+    
+    if (!mark.block) {
+        guiarstr_arena_reset(arena);
+        return;
     }
     
-    result->data[0] = '\0';
-    result->length = 0;
-    result->capacity = initial_capacity;
+    arena->current = mark.block;
+    arena->current->used = mark.used;
+}
+
+void guiarstr_arena_reset(GuiarStrArena* arena) {
+    if (!arena) return;
     
-    return result;
+    arena->current = arena->first;
+    if (arena->current) {
+        arena->current->used = 0;
+    }
 }
 
-GuiarStr* guiarstr_copy(const GuiarStr* str) {
-    if (!str) {
-        return NULL;
+// Size-class pool
+// Each thread caches freed blocks per size class. A block freed on another thread is pushed
+// onto its owner's lock-free remote list and picked up by the owner on its next miss.
+#ifdef GUIARSTR_HAVE_POOL
+#define GUIARSTR_POOL_LARGE ((size_t)-1)
+
+static const size_t guiarstr_pool_class_sizes[GUIARSTR_POOL_CLASSES] = {16, 32, 48, 64, 96, 128, 192, 256};
+
+typedef struct GuiarStrPoolCache GuiarStrPoolCache;
+
+typedef struct {
+    GuiarStrPoolCache* owner;
+    size_t size_class;
+} GuiarStrPoolHeader;
+
+typedef struct GuiarStrPoolNode {
+    struct GuiarStrPoolNode* next;
+} GuiarStrPoolNode;
+
+struct GuiarStrPoolCache {
+    GuiarStrPoolNode* lists[GUIARSTR_POOL_CLASSES];
+    size_t counts[GUIARSTR_POOL_CLASSES];
+    GuiarStrPoolNode* remote;
+    GuiarStrPoolCache* next_orphan;
+    size_t hits;
+    size_t misses;
+    size_t remote_frees;
+};
+
+static __thread GuiarStrPoolCache* guiarstr_pool_cache;
+static pthread_key_t guiarstr_pool_key;
+static pthread_once_t guiarstr_pool_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t guiarstr_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static GuiarStrPoolCache* guiarstr_pool_orphans;
+
+static size_t guiarstr_pool_class_for(size_t size) {
+    for (size_t i = 0; i < GUIARSTR_POOL_CLASSES; i++) {
+        if (size <= guiarstr_pool_class_sizes[i]) {
+            return i;
+        }
     }
+    return GUIARSTR_POOL_LARGE;
+}
+
+static GuiarStrPoolHeader* guiarstr_pool_header(void* ptr) {
+    return (GuiarStrPoolHeader*)ptr - 1;
+}
+
+static void guiarstr_pool_push_local(GuiarStrPoolCache* cache, GuiarStrPoolNode* node) {
+    size_t size_class = guiarstr_pool_header(node)->size_class;
     
-    GuiarStr* result = malloc(sizeof(GuiarStr));
-    if (!result) {
-        return NULL;
+    if (cache->counts[size_class] >= GUIARSTR_POOL_MAX_CACHED) {
+        free(guiarstr_pool_header(node));
+        return;
     }
     
-    result->data = malloc(str->capacity);
-    if (!result->data) {
-        free(result);
-        return NULL;
+    node->next = cache->lists[size_class];
+    cache->lists[size_class] = node;
+    cache->counts[size_class]++;
+}
+
+static void guiarstr_pool_push_remote(GuiarStrPoolCache* owner, GuiarStrPoolNode* node) {
+    GuiarStrPoolNode* head = __atomic_load_n(&owner->remote, __ATOMIC_RELAXED);
+    do {
+        node->next = head;
+    } while (!__atomic_compare_exchange_n(&owner->remote, &head, node, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+static void guiarstr_pool_drain_remote(GuiarStrPoolCache* cache) {
+    GuiarStrPoolNode* node = __atomic_exchange_n(&cache->remote, NULL, __ATOMIC_ACQUIRE);
+    
+    while (node) {
+        GuiarStrPoolNode* next = node->next;
+        guiarstr_pool_push_local(cache, node);
+        cache->remote_frees++;
+        node = next;
     }
-    
-    memcpy(result->data, str->data, str->length + 1);
-    result->length = str->length;
-    result->capacity = str->capacity;
-    
-    return result;
 }
 
-GuiarStr* guiarstr_view_copy(const GuiarStrView* view) {
-    if (!view || !view->data) {
-        return NULL;
+static void guiarstr_pool_release_cached(GuiarStrPoolCache* cache) {
+    guiarstr_pool_drain_remote(cache);
+    
+    for (size_t i = 0; i < GUIARSTR_POOL_CLASSES; i++) {
+        GuiarStrPoolNode* node = cache->lists[i];
+        while (node) {
+            GuiarStrPoolNode* next = node->next;
+            free(guiarstr_pool_header(node));
+            node = next;
+        }
+        cache->lists[i] = NULL;
+        cache->counts[i] = 0;
     }
+}
+
+// Blocks can outlive their thread, so exited caches are parked for adoption rather than freed
+static void guiarstr_pool_thread_exit(void* ptr) {
+    GuiarStrPoolCache* cache = ptr;
     
-    return guiarstr_create_len(view->data, view->length);
+    guiarstr_pool_release_cached(cache);
+    guiarstr_pool_cache = NULL;
+    
+    pthread_mutex_lock(&guiarstr_pool_mutex);
+    cache->next_orphan = guiarstr_pool_orphans;
+    guiarstr_pool_orphans = cache;
+    pthread_mutex_unlock(&guiarstr_pool_mutex);
 }
 
-void guiarstr_free(GuiarStr* str) {
-    if (str) {
-        free(str->data);
-        free(str);
-    }
+static void guiarstr_pool_init_key(void) {
+    pthread_key_create(&guiarstr_pool_key, guiarstr_pool_thread_exit);
 }
 
-GuiarStrError guiarstr_reserve(GuiarStr* str, size_t new_capacity) {
-    GUIARSTR_CHECK_NULL(str);
+static GuiarStrPoolCache* guiarstr_pool_get_cache(void) {
+    if (guiarstr_pool_cache) {
+        return guiarstr_pool_cache;
+    }
     
-    if (new_capacity <= str->capacity) {
-        return GUIARSTR_OK;
+    pthread_once(&guiarstr_pool_once, guiarstr_pool_init_key);
+    
+    pthread_mutex_lock(&guiarstr_pool_mutex);
+    GuiarStrPoolCache* cache = guiarstr_pool_orphans;
+    if (cache) {
+        guiarstr_pool_orphans = cache->next_orphan;
     }
+    pthread_mutex_unlock(&guiarstr_pool_mutex);
     
-    char* new_data = realloc(str->data, new_capacity);
-    if (!new_data) {
-        return GUIARSTR_ERR_MEMORY;
+    if (!cache) {
+        cache = calloc(1, sizeof(GuiarStrPoolCache));
+        if (!cache) {
+            return NULL;
+        }
     }
     
-    str->data = new_data;
-    str->capacity = new_capacity;
-    return GUIARSTR_OK;
+    pthread_setspecific(guiarstr_pool_key, cache);
+    guiarstr_pool_cache = cache;
+    return cache;
 }
 
-GuiarStrError guiarstr_resize(GuiarStr* str, size_t new_length, char fill_char) {
-    GUIARSTR_CHECK_NULL(str);
+static void* guiarstr_pool_alloc_hook(void* ctx, size_t size) {
+    (void)ctx;
     
-    GuiarStrError err = guiarstr_ensure_capacity(str, new_length + 1);
-    if (err != GUIARSTR_OK) {
-        return err;
-    }
+    size_t size_class = guiarstr_pool_class_for(size);
+    GuiarStrPoolCache* cache = size_class != GUIARSTR_POOL_LARGE ? guiarstr_pool_get_cache() : NULL;
+    GuiarStrPoolHeader* header;
     
-    if (new_length > str->length) {
-        memset(str->data + str->length, fill_char, new_length - str->length);
+    if (!cache) {
+        header = malloc(sizeof(GuiarStrPoolHeader) + size);
+        if (!header) {
+            return NULL;
+        }
+        header->owner = NULL;
+        header->size_class = GUIARSTR_POOL_LARGE;
+        return header + 1;
     }
     
-    str->data[new_length] = '\0';
-    str->length = new_length;
-    return GUIARSTR_OK;
-}
-
-GuiarStrError guiarstr_shrink_to_fit(GuiarStr* str) {
-    GUIARSTR_CHECK_NULL(str);
+    if (!cache->lists[size_class]) {
+        guiarstr_pool_drain_remote(cache);
+    }
     
-    size_t min_capacity = str->length + 1;
-    if (min_capacity < GUIARSTR_MIN_CAPACITY) {
-        min_capacity = GUIARSTR_MIN_CAPACITY;
+    GuiarStrPoolNode* node = cache->lists[size_class];
+    if (node) {
+        cache->lists[size_class] = node->next;
+        cache->counts[size_class]--;
+        cache->hits++;
+        return node;
     }
     
-    if (str->capacity <= min_capacity) {
-        return GUIARSTR_OK;
+    cache->misses++;
+    header = malloc(sizeof(GuiarStrPoolHeader) + guiarstr_pool_class_sizes[size_class]);
+    if (!header) {
+        return NULL;
     }
     
-    char* new_data = realloc(str->data, min_capacity);
-    if (!new_data) {
-        return GUIARSTR_ERR_MEMORY;
+    header->owner = cache;
+    header->size_class = size_class;
+    return header + 1;
+}
+
+static void guiarstr_pool_free_hook(void* ctx, void* ptr) {
+    (void)ctx;
+    if (!ptr) return;
+    
+    GuiarStrPoolHeader* header = guiarstr_pool_header(ptr);
+    if (header->size_class == GUIARSTR_POOL_LARGE) {
+        free(header);
+        return;
     }
     
-    str->data = new_data;
-    str->capacity = min_capacity;
-    return GUIARSTR_OK;
+    if (header->owner == guiarstr_pool_cache) {
+        guiarstr_pool_push_local(header->owner, ptr);
+    } else {
+        guiarstr_pool_push_remote(header->owner, ptr);
+    }
 }
 
-// Basic string manipulation
-char* guiarstr_trim(char* str) {
-    if (!str) return NULL;
+static void* guiarstr_pool_realloc_hook(void* ctx, void* ptr, size_t old_size, size_t new_size) {
+    if (!ptr) {
+        return guiarstr_pool_alloc_hook(ctx, new_size);
+    }
     
-    while (isspace((unsigned char)*str)) str++;
+    GuiarStrPoolHeader* header = guiarstr_pool_header(ptr);
+    size_t new_class = guiarstr_pool_class_for(new_size);
     
-    if (*str == '\0') return str;
+    if (header->size_class == GUIARSTR_POOL_LARGE && new_class == GUIARSTR_POOL_LARGE) {
+        header = realloc(header, sizeof(GuiarStrPoolHeader) + new_size);
+        return header ? header + 1 : NULL;
+    }
     
-    char* end = str + strlen(str) - 1;
-    while (end > str && isspace((unsigned char)*end)) end--;
+    if (header->size_class == new_class) {
+        return ptr;
+    }
     
-    *(end + 1) = '\0';
-    return str;
+    void* result = guiarstr_pool_alloc_hook(ctx, new_size);
+    if (!result) {
+        return NULL;
+    }
+    
+    memcpy(result, ptr, old_size < new_size ? old_size : new_size);
+    guiarstr_pool_free_hook(ctx, ptr);
+    return result;
 }
 
-char* guiarstr_strip(char* str, const char* chars_to_remove) {
-    if (!str || !chars_to_remove) return str;
-    
-    while (*str && strchr(chars_to_remove, *str)) str++;
+static const GuiarStrAllocator guiarstr_pool = {
+    guiarstr_pool_alloc_hook,
+    guiarstr_pool_realloc_hook,
+    guiarstr_pool_free_hook,
+    NULL
+};
+
+const GuiarStrAllocator* guiarstr_pool_allocator(void) {
+    return &guiarstr_pool;
+}
+
+void guiarstr_pool_trim(void) {
+    if (guiarstr_pool_cache) {
+        guiarstr_pool_release_cached(guiarstr_pool_cache);
+    }
+}
+
+void guiarstr_pool_stats(GuiarStrPoolStats* stats) {
+    if (!stats) return;
     
-    if (*str == '\0') return str;
+    memset(stats, 0, sizeof(*stats));
     
-    char* end = str + strlen(str) - 1;
-    while (end > str && strchr(chars_to_remove, *end)) end--;
+    GuiarStrPoolCache* cache = guiarstr_pool_cache;
+    if (!cache) return;
     
-    *(end + 1) = '\0';
-    return str;
+    stats->hits = cache->hits;
+    stats->misses = cache->misses;
+    stats->remote_frees = cache->remote_frees;
+    for (size_t i = 0; i < GUIARSTR_POOL_CLASSES; i++) {
+        stats->cached_blocks += cache->counts[i];
+        stats->cached_bytes += cache->counts[i] * guiarstr_pool_class_sizes[i];
+    }
+}
+#else
+// Without thread-local storage the pool is the default allocator
+const GuiarStrAllocator* guiarstr_pool_allocator(void) {
+    return &guiarstr_default_allocator;
 }
 
-void guiarstr_tolower(char* str) {
-    if (!str) return;
-    
-    for (; *str; ++str) {
-        *str = tolower((unsigned char)*str);
-    }
+void guiarstr_pool_trim(void) {
 }
 
-void guiarstr_toupper(char* str) {
-    if (!str) return;
-    
-    for (; *str; ++str) {
-        *str = toupper((unsigned char)*str);
+void guiarstr_pool_stats(GuiarStrPoolStats* stats) {
+    if (stats) {
+        memset(stats, 0, sizeof(*stats));
     }
 }
+#endif
 
-// Dynamic string operations
-GuiarStrError guiarstr_append(GuiarStr* str, const char* append) {
-    if (!append) {
-        return GUIARSTR_ERR_NULL;
+// Growth policy
+static const GuiarStrGrowthPolicy guiarstr_default_growth_policy = {
+    GUIARSTR_GROWTH_FACTOR,
+    GUIARSTR_PAGE_SIZE,
+    GUIARSTR_MMAP_THRESHOLD,
+    false
+};
+
+static const GuiarStrGrowthPolicy* guiarstr_global_growth_policy = &guiarstr_default_growth_policy;
+
+static bool guiarstr_growth_policy_valid(const GuiarStrGrowthPolicy* policy) {
+    return policy->growth_factor > 1.0;
+}
+
+GuiarStrError guiarstr_set_growth_policy(const GuiarStrGrowthPolicy* policy) {
+    if (policy && !guiarstr_growth_policy_valid(policy)) {
+        return GUIARSTR_ERR_INVALID;
     }
     
-    return guiarstr_append_len(str, append, strlen(append));
+    guiarstr_global_growth_policy = policy ? policy : &guiarstr_default_growth_policy;
+    return GUIARSTR_OK;
 }
 
-GuiarStrError guiarstr_append_len(GuiarStr* str, const char* append, size_t len) {
+const GuiarStrGrowthPolicy* guiarstr_get_growth_policy(void) {
+    return guiarstr_global_growth_policy;
+}
+
+GuiarStrError guiarstr_set_str_growth_policy(GuiarStr* str, const GuiarStrGrowthPolicy* policy) {
     GUIARSTR_CHECK_NULL(str);
-    if (!append && len > 0) {
-        return GUIARSTR_ERR_NULL;
-    }
     
-    if (len == 0) {
-        return GUIARSTR_OK;
+    if (policy && !guiarstr_growth_policy_valid(policy)) {
+        return GUIARSTR_ERR_INVALID;
     }
     
-    GuiarStrError err = guiarstr_ensure_capacity(str, str->length + len + 1);
+    str->policy = policy;
+    return GUIARSTR_OK;
+}
+
+static const GuiarStrGrowthPolicy* guiarstr_str_policy(const GuiarStr* str) {
+    return str->policy ? str->policy : guiarstr_global_growth_policy;
+}
+
+// Shared payloads carry their reference count right in front of the characters
+typedef struct {
+    long refs;
+} GuiarStrSharedHeader;
+
+static GuiarStrSharedHeader* guiarstr_shared_header(const GuiarStr* str) {
+    return (GuiarStrSharedHeader*)str->data - 1;
+}
+
+static char* guiarstr_shared_alloc(const GuiarStrAllocator* allocator, size_t capacity) {
+    GuiarStrSharedHeader* header = guiarstr_mem_alloc(allocator, sizeof(GuiarStrSharedHeader) + capacity);
+    if (!header) {
+        return NULL;
+    }
+    
+    header->refs = 1;
+    return (char*)(header + 1);
+}
+
+// SIMD helpers are forced inline so kernels instantiated with constant arguments specialize
+#if defined(__GNUC__) || defined(__clang__)
+#define GUIARSTR_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define GUIARSTR_ALWAYS_INLINE inline
+#endif
+
+// Locale-free ASCII classes and case mapping
+// Only ASCII bytes carry a class, so every byte of a UTF-8 sequence (all >= 0x80) passes through
+// case mapping, trimming and case-insensitive comparison untouched, whatever LC_CTYPE says.
+#define GUIARSTR_CTYPE_SPACE 0x01
+#define GUIARSTR_CTYPE_UPPER 0x02
+#define GUIARSTR_CTYPE_LOWER 0x04
+
+#define GUIARSTR_CTYPE_OF(c) \
+    ((c) == ' ' || ((c) >= '\t' && (c) <= '\r') ? GUIARSTR_CTYPE_SPACE : \
+     (c) >= 'A' && (c) <= 'Z' ? GUIARSTR_CTYPE_UPPER : \
+     (c) >= 'a' && (c) <= 'z' ? GUIARSTR_CTYPE_LOWER : 0)
+#define GUIARSTR_CTYPE_ROW4(c) \
+    GUIARSTR_CTYPE_OF(c), GUIARSTR_CTYPE_OF((c) + 1), GUIARSTR_CTYPE_OF((c) + 2), GUIARSTR_CTYPE_OF((c) + 3)
+#define GUIARSTR_CTYPE_ROW16(c) \
+    GUIARSTR_CTYPE_ROW4(c), GUIARSTR_CTYPE_ROW4((c) + 4), GUIARSTR_CTYPE_ROW4((c) + 8), GUIARSTR_CTYPE_ROW4((c) + 12)
+
+static const unsigned char guiarstr_ctype_table[256] = {
+    GUIARSTR_CTYPE_ROW16(0x00), GUIARSTR_CTYPE_ROW16(0x10), GUIARSTR_CTYPE_ROW16(0x20), GUIARSTR_CTYPE_ROW16(0x30),
+    GUIARSTR_CTYPE_ROW16(0x40), GUIARSTR_CTYPE_ROW16(0x50), GUIARSTR_CTYPE_ROW16(0x60), GUIARSTR_CTYPE_ROW16(0x70)
+};
+
+static bool guiarstr_ascii_isspace(unsigned char c) {
+    return (guiarstr_ctype_table[c] & GUIARSTR_CTYPE_SPACE) != 0;
+}
+
+static unsigned char guiarstr_ascii_tolower(unsigned char c) {
+    return (guiarstr_ctype_table[c] & GUIARSTR_CTYPE_UPPER) ? (unsigned char)(c ^ 0x20) : c;
+}
+
+// Case mapping flips bit 0x20 of the letters of one case. Adding 0x80 - first moves that range to
+// [-128, -103], so a single signed compare selects it; eight-byte words do the same per byte on
+// the low seven bits and mask out bytes that are not ASCII.
+static void guiarstr_ascii_case_scalar(char* dst, const char* src, size_t len, bool upper) {
+    const uint64_t ones = 0x0101010101010101ull;
+    unsigned char first = upper ? 'a' : 'A';
+    unsigned char flag = upper ? GUIARSTR_CTYPE_LOWER : GUIARSTR_CTYPE_UPPER;
+    size_t i = 0;
+    
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        memcpy(&word, src + i, 8);
+        uint64_t low = word & (ones * 0x7F);
+        uint64_t at_first = low + ones * (0x80 - first);
+        uint64_t past_last = low + ones * (0x80 - first - 26);
+        uint64_t letters = (at_first ^ past_last) & ~word & (ones * 0x80);
+        word ^= letters >> 2;
+        memcpy(dst + i, &word, 8);
+    }
+    
+    for (; i < len; i++) {
+        unsigned char c = (unsigned char)src[i];
+        dst[i] = (char)((guiarstr_ctype_table[c] & flag) ? c ^ 0x20 : c);
+    }
+}
+
+static bool guiarstr_ascii_equalsi_scalar(const char* a, const char* b, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (guiarstr_ascii_tolower((unsigned char)a[i]) != guiarstr_ascii_tolower((unsigned char)b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef GUIARSTR_HAVE_SSE2
+static GUIARSTR_ALWAYS_INLINE __m128i guiarstr_ascii_case_block_sse2(__m128i block, char first) {
+    __m128i shifted = _mm_add_epi8(block, _mm_set1_epi8((char)(0x80 - first)));
+    __m128i letters = _mm_cmpgt_epi8(_mm_set1_epi8(-128 + 26), shifted);
+    return _mm_xor_si128(block, _mm_and_si128(letters, _mm_set1_epi8(0x20)));
+}
+
+static size_t guiarstr_ascii_case_sse2(char* dst, const char* src, size_t len, bool upper) {
+    char first = upper ? 'a' : 'A';
+    size_t i = 0;
+    
+    for (; i + 16 <= len; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), guiarstr_ascii_case_block_sse2(block, first));
+    }
+    return i;
+}
+
+// Stops at the first block that differs and leaves it to the scalar loop
+static size_t guiarstr_ascii_equalsi_sse2(const char* a, const char* b, size_t len) {
+    size_t i = 0;
+    
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = guiarstr_ascii_case_block_sse2(_mm_loadu_si128((const __m128i*)(a + i)), 'A');
+        __m128i y = guiarstr_ascii_case_block_sse2(_mm_loadu_si128((const __m128i*)(b + i)), 'A');
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF) {
+            break;
+        }
+    }
+    return i;
+}
+#endif
+
+#ifdef GUIARSTR_HAVE_AVX2
+__attribute__((target("avx2")))
+static GUIARSTR_ALWAYS_INLINE __m256i guiarstr_ascii_case_block_avx2(__m256i block, char first) {
+    __m256i shifted = _mm256_add_epi8(block, _mm256_set1_epi8((char)(0x80 - first)));
+    __m256i letters = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), shifted);
+    return _mm256_xor_si256(block, _mm256_and_si256(letters, _mm256_set1_epi8(0x20)));
+}
+
+__attribute__((target("avx2")))
+static size_t guiarstr_ascii_case_avx2(char* dst, const char* src, size_t len, bool upper) {
+    char first = upper ? 'a' : 'A';
+    size_t i = 0;
+    
+    for (; i + 32 <= len; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), guiarstr_ascii_case_block_avx2(block, first));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t guiarstr_ascii_equalsi_avx2(const char* a, const char* b, size_t len) {
+    size_t i = 0;
+    
+    for (; i + 32 <= len; i += 32) {
+        __m256i x = guiarstr_ascii_case_block_avx2(_mm256_loadu_si256((const __m256i*)(a + i)), 'A');
+        __m256i y = guiarstr_ascii_case_block_avx2(_mm256_loadu_si256((const __m256i*)(b + i)), 'A');
+        if ((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) != 0xFFFFFFFFu) {
+            break;
+        }
+    }
+    return i;
+}
+#endif
+
+// dst may equal src; AVX2 takes 32-byte blocks, SSE2 at most one more 16-byte block
+static void guiarstr_ascii_case(char* dst, const char* src, size_t len, bool upper) {
+    size_t done = 0;
+    
+#ifdef GUIARSTR_HAVE_AVX2
+    if (len >= 32 && __builtin_cpu_supports("avx2")) {
+        done = guiarstr_ascii_case_avx2(dst, src, len, upper);
+    }
+#endif
+#ifdef GUIARSTR_HAVE_SSE2
+    done += guiarstr_ascii_case_sse2(dst + done, src + done, len - done, upper);
+#endif
+    guiarstr_ascii_case_scalar(dst + done, src + done, len - done, upper);
+}
+
+static bool guiarstr_ascii_equalsi(const char* a, const char* b, size_t len) {
+    size_t done = 0;
+    
+#ifdef GUIARSTR_HAVE_AVX2
+    if (len >= 32 && __builtin_cpu_supports("avx2")) {
+        done = guiarstr_ascii_equalsi_avx2(a, b, len);
+    }
+#endif
+#ifdef GUIARSTR_HAVE_SSE2
+    done += guiarstr_ascii_equalsi_sse2(a + done, b + done, len - done);
+#endif
+    return guiarstr_ascii_equalsi_scalar(a + done, b + done, len - done);
+}
+
+// Terminator scan
+// Offset of the first NUL in str[0, max), or max when there is none. The SSE2 scan loads aligned
+// 16-byte blocks: a block holding a byte of the string lies in the same page as that byte, so the
+// scan never faults, and it stops at the block holding the terminator. memchr() is not used for
+// this: C99 does not promise it stops at the first match, so a bound past the end is undefined.
+#ifdef GUIARSTR_HAVE_SSE2
+GUIARSTR_NO_SANITIZE_ADDRESS
+static size_t guiarstr_nul_offset(const char* str, size_t max) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t misalign = (uintptr_t)str & 15;
+    const char* block = str - misalign;
+    
+    unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)block), zero)) >> misalign;
+    size_t base = 0;
+    size_t next = 16 - misalign;
+    while (!mask && next < max) {
+        base = next;
+        mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)(str + next)), zero));
+        next += 16;
+    }
+    if (!mask) return max;
+    
+    size_t at = base + (size_t)__builtin_ctz(mask);
+    return at < max ? at : max;
+}
+#else
+static size_t guiarstr_nul_offset(const char* str, size_t max) {
+    size_t i = 0;
+    while (i < max && str[i]) i++;
+    return i;
+}
+#endif
+
+// Substring search engine
+// Every search runs on a GuiarStrPattern: short needles through a two-byte filter (16 or 64
+// candidate positions per branch), long ones through Horspool on byte pairs. guiarstr_memmem()
+// compiles a throwaway pattern on the stack for one-off searches.
+#define GUIARSTR_PAIR_HASH(a, b) ((((size_t)(b)) - ((size_t)(a) << 3)) % 256)
+
+static unsigned char guiarstr_fold_byte(unsigned char c) {
+    return c >= 'A' && c <= 'Z' ? (unsigned char)(c + ('a' - 'A')) : c;
+}
+
+static bool guiarstr_pattern_ignores_case(const GuiarStrPattern* pattern) {
+    return (pattern->options & GUIARSTR_PATTERN_IGNORE_CASE) != 0;
+}
+
+// Fills in the filter and skip table; needle, length and options must already be set, with
+// the needle lowercased when case is ignored
+static void guiarstr_pattern_prepare(GuiarStrPattern* pattern) {
+    const unsigned char* needle = (const unsigned char*)pattern->needle;
+    size_t len = pattern->length;
+    bool fold = guiarstr_pattern_ignores_case(pattern);
+    
+    pattern->filter_offset = 0;
+    pattern->filter_bytes[0] = pattern->filter_bytes[1] = 0;
+    pattern->filter_fold[0] = pattern->filter_fold[1] = 0;
+    pattern->mismatch_shift = 0;
+    if (len == 0) return;
+    
+    // A second filter byte equal to the first filters nothing on runs of that byte
+    size_t offset = len - 1;
+    while (offset > 0 && needle[offset] == needle[0]) offset--;
+    if (offset == 0) offset = len - 1;
+    
+    pattern->filter_offset = offset;
+    pattern->filter_bytes[0] = needle[0];
+    pattern->filter_bytes[1] = needle[offset];
+    pattern->filter_fold[0] = fold && needle[0] >= 'a' && needle[0] <= 'z' ? 0x20 : 0;
+    pattern->filter_fold[1] = fold && needle[offset] >= 'a' && needle[offset] <= 'z' ? 0x20 : 0;
+    
+    // Slot value 0 marks the needle's final byte pair: a candidate to verify
+    if (len > GUIARSTR_SEARCH_SIMD_MAX) {
+        size_t m1 = len - 1;
+        for (size_t i = 0; i < 256; i++) {
+            pattern->shift[i] = m1;
+        }
+        for (size_t i = 1; i < m1; i++) {
+            pattern->shift[GUIARSTR_PAIR_HASH(needle[i - 1], needle[i])] = m1 - i;
+        }
+        
+        size_t end_slot = GUIARSTR_PAIR_HASH(needle[m1 - 1], needle[m1]);
+        pattern->mismatch_shift = pattern->shift[end_slot];
+        pattern->shift[end_slot] = 0;
+    }
+}
+
+// Borrows the needle as is (already lowercased if the options ask for it)
+static void guiarstr_pattern_setup(GuiarStrPattern* pattern, const char* needle, size_t len, unsigned int options) {
+    pattern->needle = (char*)needle;
+    pattern->length = len;
+    pattern->options = options;
+    pattern->allocator = NULL;
+    guiarstr_pattern_prepare(pattern);
+}
+
+// memcmp() == 0 for the needles of the filter path without a library call: overlapping loads
+// cover lengths that are not a multiple of the load size
+static GUIARSTR_ALWAYS_INLINE bool guiarstr_bytes_equal(const char* a, const char* b, size_t len) {
+#ifdef GUIARSTR_HAVE_SSE2
+    if (len >= 16) {
+        for (size_t i = 0; i + 16 < len; i += 16) {
+            __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+            if (_mm_movemask_epi8(eq) != 0xFFFF) return false;
+        }
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + len - 16)),
+                                    _mm_loadu_si128((const __m128i*)(b + len - 16)));
+        return _mm_movemask_epi8(eq) == 0xFFFF;
+    }
+#endif
+    if (len >= 8) {
+        uint64_t a0, b0, a1, b1;
+        for (size_t i = 0; i + 8 < len; i += 8) {
+            memcpy(&a0, a + i, 8);
+            memcpy(&b0, b + i, 8);
+            if (a0 != b0) return false;
+        }
+        memcpy(&a1, a + len - 8, 8);
+        memcpy(&b1, b + len - 8, 8);
+        return a1 == b1;
+    }
+    if (len >= 4) {
+        uint32_t a0, b0, a1, b1;
+        memcpy(&a0, a, 4);
+        memcpy(&b0, b, 4);
+        memcpy(&a1, a + len - 4, 4);
+        memcpy(&b1, b + len - 4, 4);
+        return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+    }
+    if (len >= 2) {
+        uint16_t a0, b0, a1, b1;
+        memcpy(&a0, a, 2);
+        memcpy(&b0, b, 2);
+        memcpy(&a1, a + len - 2, 2);
+        memcpy(&b1, b + len - 2, 2);
+        return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+    }
+    return len == 0 || a[0] == b[0];
+}
+
+// The needle is already lowercase, so folding it again in the comparison is harmless
+static bool guiarstr_pattern_verify(const GuiarStrPattern* pattern, const char* candidate) {
+    if (!guiarstr_pattern_ignores_case(pattern)) {
+        return pattern->length <= GUIARSTR_SEARCH_SIMD_MAX ? guiarstr_bytes_equal(candidate, pattern->needle, pattern->length)
+                                                           : memcmp(candidate, pattern->needle, pattern->length) == 0;
+    }
+    
+    return guiarstr_ascii_equalsi(candidate, pattern->needle, pattern->length);
+}
+
+static bool guiarstr_pattern_candidate(const GuiarStrPattern* pattern, const char* p) {
+    return ((unsigned char)p[0] | pattern->filter_fold[0]) == pattern->filter_bytes[0] &&
+           ((unsigned char)p[pattern->filter_offset] | pattern->filter_fold[1]) == pattern->filter_bytes[1] &&
+           guiarstr_pattern_verify(pattern, p);
+}
+
+static const char* guiarstr_search_scalar(const GuiarStrPattern* pattern, const char* haystack, size_t haystack_len) {
+    size_t positions = haystack_len - pattern->length + 1;
+    
+    if (!pattern->filter_fold[0]) {
+        const char* last = haystack + positions - 1;
+        const char* p = haystack;
+        while (p <= last && (p = memchr(p, pattern->filter_bytes[0], last - p + 1))) {
+            if (guiarstr_pattern_candidate(pattern, p)) {
+                return p;
+            }
+            p++;
+        }
+        return NULL;
+    }
+    
+    for (size_t i = 0; i < positions; i++) {
+        if (guiarstr_pattern_candidate(pattern, haystack + i)) {
+            return haystack + i;
+        }
+    }
+    return NULL;
+}
+
+static const char* guiarstr_search_horspool(const GuiarStrPattern* pattern, const char* haystack, size_t haystack_len) {
+    bool fold = guiarstr_pattern_ignores_case(pattern);
+    size_t m1 = pattern->length - 1;
+    size_t limit = haystack_len - pattern->length;
+    size_t pos = 0;
+    
+    while (pos <= limit) {
+        unsigned char a = (unsigned char)haystack[pos + m1 - 1];
+        unsigned char b = (unsigned char)haystack[pos + m1];
+        if (fold) {
+            a = guiarstr_fold_byte(a);
+            b = guiarstr_fold_byte(b);
+        }
+        
+        size_t step = pattern->shift[GUIARSTR_PAIR_HASH(a, b)];
+        if (step) {
+            pos += step;
+            continue;
+        }
+        if (guiarstr_pattern_verify(pattern, haystack + pos)) {
+            return haystack + pos;
+        }
+        pos += pattern->mismatch_shift;
+    }
+    
+    return NULL;
+}
+
+static const char* guiarstr_search_byte(const GuiarStrPattern* pattern, const char* haystack, size_t haystack_len) {
+    return memchr(haystack, pattern->filter_bytes[0], haystack_len);
+}
+
+// Match collection
+// Forward scans report into a GuiarStrMatches: find stops at the first match, count and find_all
+// take every non-overlapping one without restarting the scan. Offsets are relative to the
+// scanned text.
+typedef struct {
+    size_t* positions; // may be NULL
+    size_t capacity;
+    size_t count;
+    size_t limit; // the scan stops once this many matches are found
+    size_t next;  // no match may start before this offset
+} GuiarStrMatches;
+
+static void guiarstr_matches_init(GuiarStrMatches* matches, size_t* positions, size_t capacity, size_t limit) {
+    matches->positions = positions;
+    matches->capacity = positions ? capacity : 0;
+    matches->count = 0;
+    matches->limit = limit;
+    matches->next = 0;
+}
+
+// Returns true once the limit is reached
+static bool guiarstr_matches_add(GuiarStrMatches* matches, size_t at, size_t length) {
+    if (matches->count < matches->capacity) {
+        matches->positions[matches->count] = at;
+    }
+    matches->count++;
+    matches->next = at + length;
+    return matches->count >= matches->limit;
+}
+
+typedef const char* (*GuiarStrSearchFn)(const GuiarStrPattern* pattern, const char* haystack, size_t haystack_len);
+
+// Repeats a first-match search over text[from, end)
+static bool guiarstr_scan_with(GuiarStrSearchFn search, const GuiarStrPattern* pattern, const char* text, size_t from,
+                               size_t end, GuiarStrMatches* matches) {
+    for (;;) {
+        if (from < matches->next) from = matches->next;
+        if (from > end || end - from < pattern->length) return false;
+
+        const char* found = search(pattern, text + from, end - from);
+        if (!found) return false;
+        if (guiarstr_matches_add(matches, (size_t)(found - text), pattern->length)) return true;
+    }
+}
+
+#ifdef GUIARSTR_HAVE_SSE2
+// Verifies the candidates of one filter block, lowest first; bit 0 stands for offset block
+static bool guiarstr_matches_drain(const GuiarStrPattern* pattern, const char* text, size_t block, uint64_t mask,
+                                   GuiarStrMatches* matches) {
+    while (mask) {
+        size_t at = block + (size_t)__builtin_ctzll(mask);
+        mask &= mask - 1;
+        if (at >= matches->next && guiarstr_pattern_verify(pattern, text + at) &&
+            guiarstr_matches_add(matches, at, pattern->length)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Filter kernels
+// A position is a candidate when it holds the needle's first byte and the filter byte sits at
+// filter_offset after it. The hot loops test 64 positions per branch (128 with AVX2) and make no
+// calls, so the broadcast bytes stay in registers; blocks with candidates go back to the caller
+// for verification. The C string variants walk aligned 64-byte blocks and test them for the
+// terminator before filtering: bytes without one are followed by more of the string, so the
+// filter's loads, which reach at most 63 bytes further, stay within mapped pages.
+typedef size_t (*GuiarStrFilterFn)(const GuiarStrPattern* pattern, const char* text, size_t i, size_t positions,
+                                   uint64_t* mask);
+typedef uint64_t (*GuiarStrCstrFilterFn)(const GuiarStrPattern* pattern, const char** block);
+
+typedef struct {
+    __m128i first;
+    __m128i second;
+    __m128i first_fold;
+    __m128i second_fold;
+} GuiarStrFilterSse2;
+
+static GUIARSTR_ALWAYS_INLINE void guiarstr_filter_setup_sse2(const GuiarStrPattern* pattern, GuiarStrFilterSse2* filter) {
+    filter->first = _mm_set1_epi8((char)pattern->filter_bytes[0]);
+    filter->second = _mm_set1_epi8((char)pattern->filter_bytes[1]);
+    filter->first_fold = _mm_set1_epi8((char)pattern->filter_fold[0]);
+    filter->second_fold = _mm_set1_epi8((char)pattern->filter_fold[1]);
+}
+
+static GUIARSTR_ALWAYS_INLINE __m128i guiarstr_filter_block_sse2(const GuiarStrFilterSse2* filter, const char* p, size_t offset,
+                                                                 const bool fold) {
+    __m128i block_first = _mm_loadu_si128((const __m128i*)p);
+    __m128i block_second = _mm_loadu_si128((const __m128i*)(p + offset));
+    if (fold) {
+        block_first = _mm_or_si128(block_first, filter->first_fold);
+        block_second = _mm_or_si128(block_second, filter->second_fold);
+    }
+    return _mm_and_si128(_mm_cmpeq_epi8(filter->first, block_first), _mm_cmpeq_epi8(filter->second, block_second));
+}
+
+static GUIARSTR_ALWAYS_INLINE uint64_t guiarstr_mask64_sse2(__m128i eq0, __m128i eq1, __m128i eq2, __m128i eq3) {
+    return (uint64_t)(unsigned)_mm_movemask_epi8(eq0) | (uint64_t)(unsigned)_mm_movemask_epi8(eq1) << 16 |
+           (uint64_t)(unsigned)_mm_movemask_epi8(eq2) << 32 | (uint64_t)(unsigned)_mm_movemask_epi8(eq3) << 48;
+}
+
+// Returns the first 64-position block at or after i with a candidate, its mask in *mask, or an
+// offset with fewer than 64 positions left
+static GUIARSTR_ALWAYS_INLINE size_t guiarstr_filter_sse2_kernel(const GuiarStrPattern* pattern, const char* text, size_t i,
+                                                                 size_t positions, uint64_t* mask, const bool fold) {
+    GuiarStrFilterSse2 filter;
+    guiarstr_filter_setup_sse2(pattern, &filter);
+    size_t offset = pattern->filter_offset;
+
+    for (; positions - i >= 64; i += 64) {
+        const char* p = text + i;
+        __m128i eq0 = guiarstr_filter_block_sse2(&filter, p, offset, fold);
+        __m128i eq1 = guiarstr_filter_block_sse2(&filter, p + 16, offset, fold);
+        __m128i eq2 = guiarstr_filter_block_sse2(&filter, p + 32, offset, fold);
+        __m128i eq3 = guiarstr_filter_block_sse2(&filter, p + 48, offset, fold);
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(eq0, eq1), _mm_or_si128(eq2, eq3)))) {
+            *mask = guiarstr_mask64_sse2(eq0, eq1, eq2, eq3);
+            return i;
+        }
+    }
+    return i;
+}
+
+__attribute__((noinline))
+static size_t guiarstr_filter_sse2(const GuiarStrPattern* pattern, const char* text, size_t i, size_t positions, uint64_t* mask) {
+    return guiarstr_pattern_ignores_case(pattern) ? guiarstr_filter_sse2_kernel(pattern, text, i, positions, mask, true)
+                                                  : guiarstr_filter_sse2_kernel(pattern, text, i, positions, mask, false);
+}
+
+static GUIARSTR_ALWAYS_INLINE bool guiarstr_block_has_nul_sse2(const char* block) {
+    const __m128i* p = (const __m128i*)block;
+    __m128i low = _mm_min_epu8(_mm_min_epu8(_mm_load_si128(p), _mm_load_si128(p + 1)),
+                               _mm_min_epu8(_mm_load_si128(p + 2), _mm_load_si128(p + 3)));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(low, _mm_setzero_si128())) != 0;
+}
+
+// Advances the aligned *block until it holds candidates and neither it nor the next block holds
+// the terminator, and returns their mask; returns 0 with *block on the first block that may
+// contain the terminator or precede it by less than the needle.
+GUIARSTR_NO_SANITIZE_ADDRESS
+static GUIARSTR_ALWAYS_INLINE uint64_t guiarstr_cstr_filter_sse2_kernel(const GuiarStrPattern* pattern, const char** block_io,
+                                                                        const bool fold) {
+    GuiarStrFilterSse2 filter;
+    guiarstr_filter_setup_sse2(pattern, &filter);
+    size_t offset = pattern->filter_offset;
+    const char* block = *block_io;
+
+    for (;; block += 64) {
+        if (guiarstr_block_has_nul_sse2(block)) break;
+
+        __m128i eq0 = guiarstr_filter_block_sse2(&filter, block, offset, fold);
+        __m128i eq1 = guiarstr_filter_block_sse2(&filter, block + 16, offset, fold);
+        __m128i eq2 = guiarstr_filter_block_sse2(&filter, block + 32, offset, fold);
+        __m128i eq3 = guiarstr_filter_block_sse2(&filter, block + 48, offset, fold);
+        if (!_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(eq0, eq1), _mm_or_si128(eq2, eq3)))) {
+            continue;
+        }
+
+        // Candidates may reach into the next block
+        if (guiarstr_block_has_nul_sse2(block + 64)) break;
+        *block_io = block;
+        return guiarstr_mask64_sse2(eq0, eq1, eq2, eq3);
+    }
+
+    *block_io = block;
+    return 0;
+}
+
+__attribute__((noinline)) GUIARSTR_NO_SANITIZE_ADDRESS
+static uint64_t guiarstr_cstr_filter_sse2(const GuiarStrPattern* pattern, const char** block) {
+    return guiarstr_pattern_ignores_case(pattern) ? guiarstr_cstr_filter_sse2_kernel(pattern, block, true)
+                                                  : guiarstr_cstr_filter_sse2_kernel(pattern, block, false);
+}
+#endif
+
+#ifdef GUIARSTR_HAVE_AVX2
+typedef struct {
+    __m256i first;
+    __m256i second;
+    __m256i first_fold;
+    __m256i second_fold;
+} GuiarStrFilterAvx2;
+
+__attribute__((target("avx2")))
+static GUIARSTR_ALWAYS_INLINE void guiarstr_filter_setup_avx2(const GuiarStrPattern* pattern, GuiarStrFilterAvx2* filter) {
+    filter->first = _mm256_set1_epi8((char)pattern->filter_bytes[0]);
+    filter->second = _mm256_set1_epi8((char)pattern->filter_bytes[1]);
+    filter->first_fold = _mm256_set1_epi8((char)pattern->filter_fold[0]);
+    filter->second_fold = _mm256_set1_epi8((char)pattern->filter_fold[1]);
+}
+
+__attribute__((target("avx2")))
+static GUIARSTR_ALWAYS_INLINE __m256i guiarstr_filter_block_avx2(const GuiarStrFilterAvx2* filter, const char* p, size_t offset,
+                                                                 const bool fold) {
+    __m256i block_first = _mm256_loadu_si256((const __m256i*)p);
+    __m256i block_second = _mm256_loadu_si256((const __m256i*)(p + offset));
+    if (fold) {
+        block_first = _mm256_or_si256(block_first, filter->first_fold);
+        block_second = _mm256_or_si256(block_second, filter->second_fold);
+    }
+    return _mm256_and_si256(_mm256_cmpeq_epi8(filter->first, block_first), _mm256_cmpeq_epi8(filter->second, block_second));
+}
+
+__attribute__((target("avx2")))
+static GUIARSTR_ALWAYS_INLINE uint64_t guiarstr_mask64_avx2(__m256i eq0, __m256i eq1) {
+    return (uint64_t)(uint32_t)_mm256_movemask_epi8(eq0) | (uint64_t)(uint32_t)_mm256_movemask_epi8(eq1) << 32;
+}
+
+__attribute__((target("avx2")))
+static GUIARSTR_ALWAYS_INLINE size_t guiarstr_filter_avx2_kernel(const GuiarStrPattern* pattern, const char* text, size_t i,
+                                                                 size_t positions, uint64_t* mask, const bool fold) {
+    GuiarStrFilterAvx2 filter;
+    guiarstr_filter_setup_avx2(pattern, &filter);
+    size_t offset = pattern->filter_offset;
+    
+    // Two blocks per branch until one of them has a candidate
+    for (; positions - i >= 128; i += 128) {
+        const char* p = text + i;
+        __m256i eq0 = guiarstr_filter_block_avx2(&filter, p, offset, fold);
+        __m256i eq1 = guiarstr_filter_block_avx2(&filter, p + 32, offset, fold);
+        __m256i eq2 = guiarstr_filter_block_avx2(&filter, p + 64, offset, fold);
+        __m256i eq3 = guiarstr_filter_block_avx2(&filter, p + 96, offset, fold);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq2, eq3));
+        if (!_mm256_testz_si256(any, any)) break;
+    }
+
+    for (; positions - i >= 64; i += 64) {
+        const char* p = text + i;
+        __m256i eq0 = guiarstr_filter_block_avx2(&filter, p, offset, fold);
+        __m256i eq1 = guiarstr_filter_block_avx2(&filter, p + 32, offset, fold);
+        __m256i any = _mm256_or_si256(eq0, eq1);
+        if (!_mm256_testz_si256(any, any)) {
+            *mask = guiarstr_mask64_avx2(eq0, eq1);
+            return i;
+        }
+    }
+    return i;
+}
+        
+__attribute__((target("avx2"), noinline))
+static size_t guiarstr_filter_avx2(const GuiarStrPattern* pattern, const char* text, size_t i, size_t positions, uint64_t* mask) {
+    return guiarstr_pattern_ignores_case(pattern) ? guiarstr_filter_avx2_kernel(pattern, text, i, positions, mask, true)
+                                                  : guiarstr_filter_avx2_kernel(pattern, text, i, positions, mask, false);
+}
+
+__attribute__((target("avx2"))) GUIARSTR_NO_SANITIZE_ADDRESS
+static GUIARSTR_ALWAYS_INLINE bool guiarstr_block_has_nul_avx2(const char* block) {
+    const __m256i* p = (const __m256i*)block;
+    __m256i nul = _mm256_cmpeq_epi8(_mm256_min_epu8(_mm256_load_si256(p), _mm256_load_si256(p + 1)), _mm256_setzero_si256());
+    return !_mm256_testz_si256(nul, nul);
+}
+
+__attribute__((target("avx2"))) GUIARSTR_NO_SANITIZE_ADDRESS
+static GUIARSTR_ALWAYS_INLINE uint64_t guiarstr_cstr_filter_avx2_kernel(const GuiarStrPattern* pattern, const char** block_io,
+                                                                        const bool fold) {
+    GuiarStrFilterAvx2 filter;
+    guiarstr_filter_setup_avx2(pattern, &filter);
+    size_t offset = pattern->filter_offset;
+    const char* block = *block_io;
+
+    // Two blocks per branch while neither holds the terminator
+    for (;; block += 128) {
+        const __m256i* p = (const __m256i*)block;
+        __m256i low = _mm256_min_epu8(_mm256_min_epu8(_mm256_load_si256(p), _mm256_load_si256(p + 1)),
+                                      _mm256_min_epu8(_mm256_load_si256(p + 2), _mm256_load_si256(p + 3)));
+        __m256i nul = _mm256_cmpeq_epi8(low, _mm256_setzero_si256());
+        if (!_mm256_testz_si256(nul, nul)) break;
+        __m256i eq0 = guiarstr_filter_block_avx2(&filter, block, offset, fold);
+        __m256i eq1 = guiarstr_filter_block_avx2(&filter, block + 32, offset, fold);
+        __m256i eq2 = guiarstr_filter_block_avx2(&filter, block + 64, offset, fold);
+        __m256i eq3 = guiarstr_filter_block_avx2(&filter, block + 96, offset, fold);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq2, eq3));
+        if (!_mm256_testz_si256(any, any)) break;
+    }
+
+    for (;; block += 64) {
+        if (guiarstr_block_has_nul_avx2(block)) break;
+
+        __m256i eq0 = guiarstr_filter_block_avx2(&filter, block, offset, fold);
+        __m256i eq1 = guiarstr_filter_block_avx2(&filter, block + 32, offset, fold);
+        __m256i any = _mm256_or_si256(eq0, eq1);
+        if (_mm256_testz_si256(any, any)) {
+            continue;
+        }
+        
+        if (guiarstr_block_has_nul_avx2(block + 64)) break;
+        *block_io = block;
+        return guiarstr_mask64_avx2(eq0, eq1);
+    }
+
+    *block_io = block;
+    return 0;
+}
+
+__attribute__((target("avx2"), noinline)) GUIARSTR_NO_SANITIZE_ADDRESS
+static uint64_t guiarstr_cstr_filter_avx2(const GuiarStrPattern* pattern, const char** block) {
+    return guiarstr_pattern_ignores_case(pattern) ? guiarstr_cstr_filter_avx2_kernel(pattern, block, true)
+                                                  : guiarstr_cstr_filter_avx2_kernel(pattern, block, false);
+}
+#endif
+
+#ifdef GUIARSTR_HAVE_SSE2
+// Filters text[from, end) 64 positions at a time, then 16 at a time; the last few positions go
+// through the scalar search
+static bool guiarstr_scan_simd(const GuiarStrPattern* pattern, const char* text, size_t from, size_t end,
+                               GuiarStrMatches* matches) {
+    size_t positions = end - pattern->length + 1;
+    size_t i = from;
+
+    if (positions - i >= 64) {
+        GuiarStrFilterFn filter = guiarstr_filter_sse2;
+#ifdef GUIARSTR_HAVE_AVX2
+        if (__builtin_cpu_supports("avx2")) filter = guiarstr_filter_avx2;
+#endif
+        for (;;) {
+            uint64_t mask;
+            i = filter(pattern, text, i, positions, &mask);
+            if (positions - i < 64) break;
+            if (guiarstr_matches_drain(pattern, text, i, mask, matches)) return true;
+            i += 64;
+        }
+    }
+    
+    GuiarStrFilterSse2 filter;
+    guiarstr_filter_setup_sse2(pattern, &filter);
+    bool fold = guiarstr_pattern_ignores_case(pattern);
+    for (; positions - i >= 16; i += 16) {
+        unsigned mask = (unsigned)_mm_movemask_epi8(guiarstr_filter_block_sse2(&filter, text + i, pattern->filter_offset, fold));
+        if (mask && guiarstr_matches_drain(pattern, text, i, mask, matches)) return true;
+    }
+
+    return guiarstr_scan_with(guiarstr_search_scalar, pattern, text, i, end, matches);
+}
+#endif
+
+// Collects the matches that start in text[from, end) and end by end; an empty pattern matches
+// once at from. Returns true once the limit is reached.
+static bool guiarstr_pattern_scan(const GuiarStrPattern* pattern, const char* text, size_t from, size_t end,
+                                  GuiarStrMatches* matches) {
+    size_t len = pattern->length;
+    if (from < matches->next) from = matches->next;
+    if (len == 0) return guiarstr_matches_add(matches, from, 0) || true;
+    if (from > end || end - from < len) return false;
+
+    if (len == 1 && !pattern->filter_fold[0]) {
+        return guiarstr_scan_with(guiarstr_search_byte, pattern, text, from, end, matches);
+    }
+    if (len > GUIARSTR_SEARCH_SIMD_MAX) {
+        return guiarstr_scan_with(guiarstr_search_horspool, pattern, text, from, end, matches);
+    }
+#ifdef GUIARSTR_HAVE_SSE2
+    return guiarstr_scan_simd(pattern, text, from, end, matches);
+#else
+    return guiarstr_scan_with(guiarstr_search_scalar, pattern, text, from, end, matches);
+#endif
+}
+
+static const char* guiarstr_pattern_search(const GuiarStrPattern* pattern, const char* haystack, size_t haystack_len) {
+    size_t at;
+    GuiarStrMatches matches;
+    guiarstr_matches_init(&matches, &at, 1, 1);
+    return guiarstr_pattern_scan(pattern, haystack, 0, haystack_len, &matches) ? haystack + at : NULL;
+}
+
+// Reverse search
+// The same filter walked from the end: each block covers the candidate positions just below the
+// previous one and its mask is drained highest bit first. Long needles use it as well, there is
+// no reverse skip table.
+static const char* guiarstr_memrchr_fallback(const char* haystack, unsigned char c, size_t len) {
+    size_t i = len;
+    
+#ifdef GUIARSTR_HAVE_SSE2
+    const __m128i target = _mm_set1_epi8((char)c);
+    for (; i >= 16; i -= 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(haystack + i - 16));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, target));
+        if (mask) {
+            return haystack + i - 16 + (31 - __builtin_clz(mask));
+        }
+    }
+#endif
+    
+    while (i > 0) {
+        if ((unsigned char)haystack[--i] == c) {
+            return haystack + i;
+        }
+    }
+    return NULL;
+}
+
+#ifdef GUIARSTR_HAVE_AVX2
+__attribute__((target("avx2")))
+static const char* guiarstr_memrchr_avx2(const char* haystack, unsigned char c, size_t len) {
+    const __m256i target = _mm256_set1_epi8((char)c);
+    size_t i = len;
+    
+    for (; i >= 64; i -= 64) {
+        const char* p = haystack + i - 64;
+        __m256i eq0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)p), target);
+        __m256i eq1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + 32)), target);
+        __m256i any = _mm256_or_si256(eq0, eq1);
+        if (_mm256_testz_si256(any, any)) {
+            continue;
+        }
+        
+        uint64_t mask = (uint32_t)_mm256_movemask_epi8(eq0) | (uint64_t)(uint32_t)_mm256_movemask_epi8(eq1) << 32;
+        return p + (63 - __builtin_clzll(mask));
+    }
+    
+    return guiarstr_memrchr_fallback(haystack, c, i);
+}
+#endif
+
+static const char* guiarstr_memrchr(const char* haystack, unsigned char c, size_t len) {
+#ifdef GUIARSTR_HAVE_AVX2
+    if (len >= 64 && __builtin_cpu_supports("avx2")) {
+        return guiarstr_memrchr_avx2(haystack, c, len);
+    }
+#endif
+    return guiarstr_memrchr_fallback(haystack, c, len);
+}
+
+static const char* guiarstr_rsearch_scalar(const GuiarStrPattern* pattern, const char* haystack, size_t haystack_len) {
+    if (pattern->length > haystack_len) return NULL;
+    
+    size_t positions = haystack_len - pattern->length + 1;
+    
+    if (!pattern->filter_fold[0]) {
+        const char* p;
+        while (positions && (p = guiarstr_memrchr(haystack, pattern->filter_bytes[0], positions))) {
+            if (guiarstr_pattern_candidate(pattern, p)) {
+                return p;
+            }
+            positions = p - haystack;
+        }
+        return NULL;
+    }
+    
+    while (positions-- > 0) {
+        if (guiarstr_pattern_candidate(pattern, haystack + positions)) {
+            return haystack + positions;
+        }
+    }
+    return NULL;
+}
+
+#ifdef GUIARSTR_HAVE_SSE2
+static GUIARSTR_ALWAYS_INLINE const char* guiarstr_rsearch_sse2_kernel(const GuiarStrPattern* pattern, const char* haystack,
+                                                                       size_t haystack_len, const bool fold) {
+    const __m128i first = _mm_set1_epi8((char)pattern->filter_bytes[0]);
+    const __m128i second = _mm_set1_epi8((char)pattern->filter_bytes[1]);
+    const __m128i first_fold = _mm_set1_epi8((char)pattern->filter_fold[0]);
+    const __m128i second_fold = _mm_set1_epi8((char)pattern->filter_fold[1]);
+    size_t offset = pattern->filter_offset;
+    size_t i = haystack_len - pattern->length + 1; // candidates below i remain
+    
+    for (; i >= 16; i -= 16) {
+        const char* p = haystack + i - 16;
+        __m128i block_first = _mm_loadu_si128((const __m128i*)p);
+        __m128i block_second = _mm_loadu_si128((const __m128i*)(p + offset));
+        if (fold) {
+            block_first = _mm_or_si128(block_first, first_fold);
+            block_second = _mm_or_si128(block_second, second_fold);
+        }
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                                                                  _mm_cmpeq_epi8(second, block_second)));
+        while (mask) {
+            unsigned bit = 31 - (unsigned)__builtin_clz(mask);
+            if (guiarstr_pattern_verify(pattern, p + bit)) {
+                return p + bit;
+            }
+            mask &= ~(1u << bit);
+        }
+    }
+    
+    return guiarstr_rsearch_scalar(pattern, haystack, i + pattern->length - 1);
+}
+
+static const char* guiarstr_rsearch_sse2(const GuiarStrPattern* pattern, const char* haystack, size_t haystack_len) {
+    return guiarstr_pattern_ignores_case(pattern) ? guiarstr_rsearch_sse2_kernel(pattern, haystack, haystack_len, true)
+                                                  : guiarstr_rsearch_sse2_kernel(pattern, haystack, haystack_len, false);
+}
+#endif
+
+#ifdef GUIARSTR_HAVE_AVX2
+__attribute__((target("avx2")))
+static GUIARSTR_ALWAYS_INLINE const char* guiarstr_rsearch_avx2_kernel(const GuiarStrPattern* pattern, const char* haystack,
+                                                                       size_t haystack_len, const bool fold) {
+    const __m256i first = _mm256_set1_epi8((char)pattern->filter_bytes[0]);
+    const __m256i second = _mm256_set1_epi8((char)pattern->filter_bytes[1]);
+    const __m256i first_fold = _mm256_set1_epi8((char)pattern->filter_fold[0]);
+    const __m256i second_fold = _mm256_set1_epi8((char)pattern->filter_fold[1]);
+    size_t offset = pattern->filter_offset;
+    size_t i = haystack_len - pattern->length + 1;
+    
+    for (; i >= 64; i -= 64) {
+        const char* p = haystack + i - 64;
+        __m256i first0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i second0 = _mm256_loadu_si256((const __m256i*)(p + offset));
+        __m256i first1 = _mm256_loadu_si256((const __m256i*)(p + 32));
+        __m256i second1 = _mm256_loadu_si256((const __m256i*)(p + 32 + offset));
+        if (fold) {
+            first0 = _mm256_or_si256(first0, first_fold);
+            second0 = _mm256_or_si256(second0, second_fold);
+            first1 = _mm256_or_si256(first1, first_fold);
+            second1 = _mm256_or_si256(second1, second_fold);
+        }
+        
+        __m256i eq0 = _mm256_and_si256(_mm256_cmpeq_epi8(first, first0), _mm256_cmpeq_epi8(second, second0));
+        __m256i eq1 = _mm256_and_si256(_mm256_cmpeq_epi8(first, first1), _mm256_cmpeq_epi8(second, second1));
+        __m256i any = _mm256_or_si256(eq0, eq1);
+        if (_mm256_testz_si256(any, any)) {
+            continue;
+        }
+        
+        uint64_t mask = (uint32_t)_mm256_movemask_epi8(eq0) | (uint64_t)(uint32_t)_mm256_movemask_epi8(eq1) << 32;
+        while (mask) {
+            unsigned bit = 63 - (unsigned)__builtin_clzll(mask);
+            if (guiarstr_pattern_verify(pattern, p + bit)) {
+                return p + bit;
+            }
+            mask &= ~((uint64_t)1 << bit);
+        }
+    }
+    
+    return guiarstr_rsearch_sse2(pattern, haystack, i + pattern->length - 1);
+}
+
+__attribute__((target("avx2")))
+static const char* guiarstr_rsearch_avx2(const GuiarStrPattern* pattern, const char* haystack, size_t haystack_len) {
+    return guiarstr_pattern_ignores_case(pattern) ? guiarstr_rsearch_avx2_kernel(pattern, haystack, haystack_len, true)
+                                                  : guiarstr_rsearch_avx2_kernel(pattern, haystack, haystack_len, false);
+}
+#endif
+
+static const char* guiarstr_pattern_rsearch(const GuiarStrPattern* pattern, const char* haystack, size_t haystack_len) {
+    size_t len = pattern->length;
+    if (len == 0) return haystack + haystack_len;
+    if (len > haystack_len) return NULL;
+    if (len == 1 && !pattern->filter_fold[0]) return guiarstr_memrchr(haystack, pattern->filter_bytes[0], haystack_len);
+    
+#ifdef GUIARSTR_HAVE_AVX2
+    if (haystack_len - len >= 32 && __builtin_cpu_supports("avx2")) {
+        return guiarstr_rsearch_avx2(pattern, haystack, haystack_len);
+    }
+#endif
+#ifdef GUIARSTR_HAVE_SSE2
+    return guiarstr_rsearch_sse2(pattern, haystack, haystack_len);
+#else
+    return guiarstr_rsearch_scalar(pattern, haystack, haystack_len);
+#endif
+}
+
+static const char* guiarstr_memmem(const char* haystack, size_t haystack_len,
+                                   const char* needle, size_t needle_len) {
+    if (needle_len == 0) return haystack;
+    if (needle_len > haystack_len) return NULL;
+    if (needle_len == 1) return memchr(haystack, needle[0], haystack_len);
+    
+    GuiarStrPattern pattern;
+    guiarstr_pattern_setup(&pattern, needle, needle_len, 0);
+    return guiarstr_pattern_search(&pattern, haystack, haystack_len);
+}
+
+static const char* guiarstr_memrmem(const char* haystack, size_t haystack_len,
+                                    const char* needle, size_t needle_len) {
+    if (needle_len == 0) return haystack + haystack_len;
+    if (needle_len > haystack_len) return NULL;
+    if (needle_len == 1) return guiarstr_memrchr(haystack, (unsigned char)needle[0], haystack_len);
+    
+    GuiarStrPattern pattern;
+    guiarstr_pattern_setup(&pattern, needle, needle_len, 0);
+    return guiarstr_pattern_rsearch(&pattern, haystack, haystack_len);
+}
+
+// C string scans
+// Needles up to GUIARSTR_SEARCH_SIMD_MAX bytes run the C string filters, which find the terminator
+// in the same pass. Longer needles, and builds without SSE2, measure the string one window at a
+// time and search each window by length, so an early match still returns without a full strlen.
+static bool guiarstr_cstr_scan_windows(const GuiarStrPattern* pattern, const char* str, GuiarStrMatches* matches) {
+    size_t window = GUIARSTR_SEARCH_WINDOW;
+    size_t searched = 0; // candidates before this offset are ruled out
+    size_t known = 0;    // str[0, known) holds no terminator
+    
+    for (;;) {
+        size_t end = known + guiarstr_nul_offset(str + known, window);
+        bool nul = end < known + window;
+        known = end;
+        
+        if (guiarstr_pattern_scan(pattern, str, searched, known, matches)) return true;
+        if (known >= pattern->length) searched = known - pattern->length + 1;
+        if (nul) return false;
+        if (window < GUIARSTR_SEARCH_WINDOW_MAX) window *= 2;
+    }
+}
+
+#ifdef GUIARSTR_HAVE_SSE2
+// The bytes before the first aligned block are searched by length, along with the block after
+// them; the filter takes over from there. Matches it finds again are skipped by matches->next.
+static bool guiarstr_cstr_scan_blocks(const GuiarStrPattern* pattern, const char* str, GuiarStrMatches* matches) {
+    size_t head = 64 - ((uintptr_t)str & 63);
+    size_t len = guiarstr_nul_offset(str, head + 64);
+    if (guiarstr_pattern_scan(pattern, str, 0, len, matches) || len < head + 64) {
+        return matches->count >= matches->limit;
+    }
+
+    GuiarStrCstrFilterFn filter = guiarstr_cstr_filter_sse2;
+#ifdef GUIARSTR_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2")) filter = guiarstr_cstr_filter_avx2;
+#endif
+    const char* block = str + head;
+
+    for (;;) {
+        uint64_t mask = filter(pattern, &block);
+        size_t base = (size_t)(block - str);
+        if (!mask) {
+            return guiarstr_pattern_scan(pattern, str, base, base + guiarstr_nul_offset(block, 128), matches);
+        }
+        if (guiarstr_matches_drain(pattern, str, base, mask, matches)) return true;
+        block += 64;
+    }
+}
+#endif
+
+static bool guiarstr_cstr_scan(const GuiarStrPattern* pattern, const char* str, GuiarStrMatches* matches) {
+#ifdef GUIARSTR_HAVE_SSE2
+    if (pattern->length > 0 && pattern->length <= GUIARSTR_SEARCH_SIMD_MAX) {
+        return guiarstr_cstr_scan_blocks(pattern, str, matches);
+    }
+#endif
+    return guiarstr_cstr_scan_windows(pattern, str, matches);
+}
+
+static const char* guiarstr_cstr_search(const char* str, const GuiarStrPattern* pattern) {
+    size_t at;
+    GuiarStrMatches matches;
+    guiarstr_matches_init(&matches, &at, 1, 1);
+    return guiarstr_cstr_scan(pattern, str, &matches) ? str + at : NULL;
+}
+
+static size_t guiarstr_cstr_count(const char* str, const GuiarStrPattern* pattern) {
+    GuiarStrMatches matches;
+    guiarstr_matches_init(&matches, NULL, 0, (size_t)-1);
+    guiarstr_cstr_scan(pattern, str, &matches);
+    return matches.count;
+}
+
+// Character sets
+// Scalar lookups test the bitmap. The AVX2 classifier fetches a byte's row by its low nibble
+// with PSHUFB, once per half of the byte range (PSHUFB zeroes lanes whose index has the top
+// bit set, so each table only answers for its half), then tests the row bit selected by the
+// high nibble. Without AVX2, small sets compare against each member instead.
+#define GUIARSTR_CHARSET_MEMBERS 4
+
+static bool guiarstr_charset_has(const GuiarStrCharSet* set, unsigned char c) {
+    return (set->bits[c >> 3] >> (c & 7)) & 1;
+}
+
+static size_t guiarstr_charset_scan_scalar(const GuiarStrCharSet* set, const char* data, size_t len, bool want) {
+    for (size_t i = 0; i < len; i++) {
+        if (guiarstr_charset_has(set, (unsigned char)data[i]) == want) {
+            return i;
+        }
+    }
+    return len;
+}
+
+static size_t guiarstr_charset_rscan_scalar(const GuiarStrCharSet* set, const char* data, size_t len, bool want) {
+    while (len > 0 && guiarstr_charset_has(set, (unsigned char)data[len - 1]) != want) {
+        len--;
+    }
+    return len;
+}
+
+#ifdef GUIARSTR_HAVE_SSE2
+static GUIARSTR_ALWAYS_INLINE unsigned guiarstr_charset_mask_sse2(const __m128i members[4], __m128i block) {
+    __m128i eq = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, members[0]), _mm_cmpeq_epi8(block, members[1])),
+                              _mm_or_si128(_mm_cmpeq_epi8(block, members[2]), _mm_cmpeq_epi8(block, members[3])));
+    return (unsigned)_mm_movemask_epi8(eq);
+}
+
+static void guiarstr_charset_members_sse2(const GuiarStrCharSet* set, __m128i members[4]) {
+    for (size_t i = 0; i < GUIARSTR_CHARSET_MEMBERS; i++) {
+        members[i] = _mm_set1_epi8((char)set->members[i]);
+    }
+}
+#endif
+
+// Sets too large for the member compares fall back to the bitmap
+static size_t guiarstr_charset_scan_small(const GuiarStrCharSet* set, const char* data, size_t len, bool want) {
+    size_t i = 0;
+    
+#ifdef GUIARSTR_HAVE_SSE2
+    if (set->count <= GUIARSTR_CHARSET_MEMBERS) {
+        __m128i members[4];
+        guiarstr_charset_members_sse2(set, members);
+        unsigned flip = want ? 0 : 0xFFFF;
+        
+        for (; i + 16 <= len; i += 16) {
+            unsigned mask = guiarstr_charset_mask_sse2(members, _mm_loadu_si128((const __m128i*)(data + i))) ^ flip;
+            if (mask) {
+                return i + (size_t)__builtin_ctz(mask);
+            }
+        }
+    }
+#endif
+    
+    return i + guiarstr_charset_scan_scalar(set, data + i, len - i, want);
+}
+
+static size_t guiarstr_charset_rscan_small(const GuiarStrCharSet* set, const char* data, size_t len, bool want) {
+#ifdef GUIARSTR_HAVE_SSE2
+    if (set->count <= GUIARSTR_CHARSET_MEMBERS) {
+        __m128i members[4];
+        guiarstr_charset_members_sse2(set, members);
+        unsigned flip = want ? 0 : 0xFFFF;
+        
+        for (; len >= 16; len -= 16) {
+            unsigned mask = guiarstr_charset_mask_sse2(members, _mm_loadu_si128((const __m128i*)(data + len - 16))) ^ flip;
+            if (mask) {
+                return len - 16 + (32 - (size_t)__builtin_clz(mask));
+            }
+        }
+    }
+#endif
+    
+    return guiarstr_charset_rscan_scalar(set, data, len, want);
+}
+
+#ifdef GUIARSTR_HAVE_AVX2
+typedef struct {
+    __m256i rows_low;
+    __m256i rows_high;
+    __m256i row_bits;
+} GuiarStrCharSetTables;
+
+__attribute__((target("avx2")))
+static GUIARSTR_ALWAYS_INLINE void guiarstr_charset_tables_avx2(const GuiarStrCharSet* set, GuiarStrCharSetTables* tables) {
+    tables->rows_low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)set->rows[0]));
+    tables->rows_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)set->rows[1]));
+    tables->row_bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                        1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+}
+
+__attribute__((target("avx2")))
+static GUIARSTR_ALWAYS_INLINE uint32_t guiarstr_charset_mask_avx2(const GuiarStrCharSetTables* tables, __m256i block) {
+    __m256i rows = _mm256_or_si256(_mm256_shuffle_epi8(tables->rows_low, block),
+                                   _mm256_shuffle_epi8(tables->rows_high,
+                                                       _mm256_xor_si256(block, _mm256_set1_epi8((char)0x80))));
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), _mm256_set1_epi8(0x0F));
+    __m256i bit = _mm256_shuffle_epi8(tables->row_bits, high);
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(rows, bit), bit));
+}
+
+__attribute__((target("avx2")))
+static size_t guiarstr_charset_scan_avx2(const GuiarStrCharSet* set, const char* data, size_t len, bool want) {
+    GuiarStrCharSetTables tables;
+    guiarstr_charset_tables_avx2(set, &tables);
+    uint32_t flip = want ? 0 : 0xFFFFFFFFu;
+    size_t i = 0;
+    
+    for (; i + 32 <= len; i += 32) {
+        uint32_t mask = guiarstr_charset_mask_avx2(&tables, _mm256_loadu_si256((const __m256i*)(data + i))) ^ flip;
+        if (mask) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+    
+    return i + guiarstr_charset_scan_small(set, data + i, len - i, want);
+}
+
+__attribute__((target("avx2")))
+static size_t guiarstr_charset_rscan_avx2(const GuiarStrCharSet* set, const char* data, size_t len, bool want) {
+    GuiarStrCharSetTables tables;
+    guiarstr_charset_tables_avx2(set, &tables);
+    uint32_t flip = want ? 0 : 0xFFFFFFFFu;
+    
+    for (; len >= 32; len -= 32) {
+        uint32_t mask = guiarstr_charset_mask_avx2(&tables, _mm256_loadu_si256((const __m256i*)(data + len - 32))) ^ flip;
+        if (mask) {
+            return len - 32 + (32 - (size_t)__builtin_clz(mask));
+        }
+    }
+    
+    return guiarstr_charset_rscan_small(set, data, len, want);
+}
+#endif
+
+// Offset of the first byte whose membership equals want, len if there is none
+static size_t guiarstr_charset_scan(const GuiarStrCharSet* set, const char* data, size_t len, bool want) {
+    if (set->count == 0) return want ? len : 0;
+    if (set->count == 1 && want) {
+        const char* found = len ? memchr(data, set->members[0], len) : NULL;
+        return found ? (size_t)(found - data) : len;
+    }
+    
+#ifdef GUIARSTR_HAVE_AVX2
+    if (len >= 32 && __builtin_cpu_supports("avx2")) {
+        return guiarstr_charset_scan_avx2(set, data, len, want);
+    }
+#endif
+    return guiarstr_charset_scan_small(set, data, len, want);
+}
+
+// Length of the prefix that ends with the last byte whose membership equals want, 0 if there is none
+static size_t guiarstr_charset_rscan(const GuiarStrCharSet* set, const char* data, size_t len, bool want) {
+    if (set->count == 0) return want ? 0 : len;
+    if (set->count == 1 && want) {
+        const char* found = guiarstr_memrchr(data, set->members[0], len);
+        return found ? (size_t)(found - data) + 1 : 0;
+    }
+    
+#ifdef GUIARSTR_HAVE_AVX2
+    if (len >= 32 && __builtin_cpu_supports("avx2")) {
+        return guiarstr_charset_rscan_avx2(set, data, len, want);
+    }
+#endif
+    return guiarstr_charset_rscan_small(set, data, len, want);
+}
+
+// C strings are measured one window at a time, as in guiarstr_cstr_scan_windows(); returns the offset
+// of the first byte whose membership equals want, or the string length
+static size_t guiarstr_charset_cstr_scan(const GuiarStrCharSet* set, const char* str, bool want) {
+    size_t window = GUIARSTR_SEARCH_WINDOW;
+    size_t known = 0;
+    
+    for (;;) {
+        size_t end = known + guiarstr_nul_offset(str + known, window);
+        bool nul = end < known + window;
+        
+        size_t found = guiarstr_charset_scan(set, str + known, end - known, want);
+        if (found < end - known || nul) return known + found;
+        
+        known = end;
+        if (window < GUIARSTR_SEARCH_WINDOW_MAX) window *= 2;
+    }
+}
+
+// Helper functions
+static size_t guiarstr_utf8_lead_len(unsigned char c) {
+    if ((c & 0x80) == 0x00) return 1;      // 0xxxxxxx
+    if ((c & 0xE0) == 0xC0) return 2;      // 110xxxxx
+    if ((c & 0xF0) == 0xE0) return 3;      // 1110xxxx
+    if ((c & 0xF8) == 0xF0) return 4;      // 11110xxx
+    
+    return 1; // Invalid UTF-8, treat as single byte
+}
+
+static size_t guiarstr_utf8_count_chars(const char* data, size_t len) {
+    size_t count = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (((unsigned char)data[i] & 0xC0) != 0x80) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// UTF-8 validation (strict RFC 3629: no overlong forms, surrogates or code points above U+10FFFF)
+// The scalar validator skips ASCII runs a block at a time and decodes everything else one
+// sequence at a time. With AVX2 the whole input is first checked 64 bytes per iteration with the
+// Keiser-Lemire nibble lookups; the scalar validator then only re-reads from the first flagged
+// block to report the exact offset.
+static size_t guiarstr_utf8_error_scalar(const unsigned char* s, size_t i, size_t len) {
+    while (i < len) {
+#ifdef GUIARSTR_HAVE_SSE2
+        while (i + 16 <= len && !_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(s + i)))) {
+            i += 16;
+        }
+#else
+        for (uint64_t word; i + 8 <= len; i += 8) {
+            memcpy(&word, s + i, 8);
+            if (word & 0x8080808080808080ull) break;
+        }
+#endif
+        if (i == len) break;
+        
+        unsigned char c = s[i];
+        if (c < 0x80) {
+            i++;
+            continue;
+        }
+        
+        size_t need;
+        unsigned char lo = 0x80, hi = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF) {
+            need = 1;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            need = 2;
+            if (c == 0xE0) lo = 0xA0;
+            if (c == 0xED) hi = 0x9F;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            need = 3;
+            if (c == 0xF0) lo = 0x90;
+            if (c == 0xF4) hi = 0x8F;
+        } else {
+            return i;
+        }
+        
+        if (need > len - i - 1) return i;
+        if (s[i + 1] < lo || s[i + 1] > hi) return i;
+        for (size_t k = 2; k <= need; k++) {
+            if ((s[i + k] & 0xC0) != 0x80) return i;
+        }
+        i += need + 1;
+    }
+    
+    return (size_t)-1;
+}
+
+#ifdef GUIARSTR_HAVE_AVX2
+// Error classes of a (previous byte, current byte) pair, one bit each; a pair is invalid when its
+// three nibble lookups share a bit. TWO_CONTS is instead required exactly where a byte must be
+// the third or fourth of a sequence.
+#define GUIARSTR_UTF8_TOO_SHORT (1 << 0)
+#define GUIARSTR_UTF8_TOO_LONG (1 << 1)
+#define GUIARSTR_UTF8_OVERLONG_3 (1 << 2)
+#define GUIARSTR_UTF8_TOO_LARGE (1 << 3)
+#define GUIARSTR_UTF8_SURROGATE (1 << 4)
+#define GUIARSTR_UTF8_OVERLONG_2 (1 << 5)
+#define GUIARSTR_UTF8_TOO_LARGE_1000 (1 << 6)
+#define GUIARSTR_UTF8_OVERLONG_4 (1 << 6)
+#define GUIARSTR_UTF8_TWO_CONTS (1 << 7)
+#define GUIARSTR_UTF8_CARRY (GUIARSTR_UTF8_TOO_SHORT | GUIARSTR_UTF8_TOO_LONG | GUIARSTR_UTF8_TWO_CONTS)
+
+#define GUIARSTR_UTF8_TABLE(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p) \
+    _mm256_setr_epi8((char)(a), (char)(b), (char)(c), (char)(d), (char)(e), (char)(f), (char)(g), (char)(h), \
+                     (char)(i), (char)(j), (char)(k), (char)(l), (char)(m), (char)(n), (char)(o), (char)(p), \
+                     (char)(a), (char)(b), (char)(c), (char)(d), (char)(e), (char)(f), (char)(g), (char)(h), \
+                     (char)(i), (char)(j), (char)(k), (char)(l), (char)(m), (char)(n), (char)(o), (char)(p))
+
+typedef struct {
+    __m256i byte_1_high;
+    __m256i byte_1_low;
+    __m256i byte_2_high;
+} GuiarStrUtf8Tables;
+
+__attribute__((target("avx2")))
+static GUIARSTR_ALWAYS_INLINE void guiarstr_utf8_tables_avx2(GuiarStrUtf8Tables* tables) {
+    const int carry = GUIARSTR_UTF8_CARRY;
+    const int large = GUIARSTR_UTF8_TOO_LARGE | GUIARSTR_UTF8_TOO_LARGE_1000;
+    const int cont = GUIARSTR_UTF8_TOO_LONG | GUIARSTR_UTF8_OVERLONG_2 | GUIARSTR_UTF8_TWO_CONTS;
+    
+    tables->byte_1_high = GUIARSTR_UTF8_TABLE(
+        GUIARSTR_UTF8_TOO_LONG, GUIARSTR_UTF8_TOO_LONG, GUIARSTR_UTF8_TOO_LONG, GUIARSTR_UTF8_TOO_LONG,
+        GUIARSTR_UTF8_TOO_LONG, GUIARSTR_UTF8_TOO_LONG, GUIARSTR_UTF8_TOO_LONG, GUIARSTR_UTF8_TOO_LONG,
+        GUIARSTR_UTF8_TWO_CONTS, GUIARSTR_UTF8_TWO_CONTS, GUIARSTR_UTF8_TWO_CONTS, GUIARSTR_UTF8_TWO_CONTS,
+        GUIARSTR_UTF8_TOO_SHORT | GUIARSTR_UTF8_OVERLONG_2,
+        GUIARSTR_UTF8_TOO_SHORT,
+        GUIARSTR_UTF8_TOO_SHORT | GUIARSTR_UTF8_OVERLONG_3 | GUIARSTR_UTF8_SURROGATE,
+        GUIARSTR_UTF8_TOO_SHORT | large | GUIARSTR_UTF8_OVERLONG_4);
+    tables->byte_1_low = GUIARSTR_UTF8_TABLE(
+        carry | GUIARSTR_UTF8_OVERLONG_3 | GUIARSTR_UTF8_OVERLONG_2 | GUIARSTR_UTF8_OVERLONG_4,
+        carry | GUIARSTR_UTF8_OVERLONG_2,
+        carry, carry,
+        carry | GUIARSTR_UTF8_TOO_LARGE,
+        carry | large, carry | large, carry | large,
+        carry | large, carry | large, carry | large, carry | large, carry | large,
+        carry | large | GUIARSTR_UTF8_SURROGATE,
+        carry | large, carry | large);
+    tables->byte_2_high = GUIARSTR_UTF8_TABLE(
+        GUIARSTR_UTF8_TOO_SHORT, GUIARSTR_UTF8_TOO_SHORT, GUIARSTR_UTF8_TOO_SHORT, GUIARSTR_UTF8_TOO_SHORT,
+        GUIARSTR_UTF8_TOO_SHORT, GUIARSTR_UTF8_TOO_SHORT, GUIARSTR_UTF8_TOO_SHORT, GUIARSTR_UTF8_TOO_SHORT,
+        cont | GUIARSTR_UTF8_OVERLONG_3 | GUIARSTR_UTF8_TOO_LARGE_1000 | GUIARSTR_UTF8_OVERLONG_4,
+        cont | GUIARSTR_UTF8_OVERLONG_3 | GUIARSTR_UTF8_TOO_LARGE,
+        cont | GUIARSTR_UTF8_SURROGATE | GUIARSTR_UTF8_TOO_LARGE,
+        cont | GUIARSTR_UTF8_SURROGATE | GUIARSTR_UTF8_TOO_LARGE,
+        GUIARSTR_UTF8_TOO_SHORT, GUIARSTR_UTF8_TOO_SHORT, GUIARSTR_UTF8_TOO_SHORT, GUIARSTR_UTF8_TOO_SHORT);
+}
+
+// Bytes of block shifted right by n positions, filled from the end of prev
+#define GUIARSTR_UTF8_PREV(block, prev, n) \
+    _mm256_alignr_epi8((block), _mm256_permute2x128_si256((prev), (block), 0x21), 16 - (n))
+
+__attribute__((target("avx2")))
+static GUIARSTR_ALWAYS_INLINE __m256i guiarstr_utf8_block_errors_avx2(const GuiarStrUtf8Tables* tables, __m256i block,
+                                                                     __m256i prev) {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i prev1 = GUIARSTR_UTF8_PREV(block, prev, 1);
+    
+    __m256i byte_1_high = _mm256_shuffle_epi8(tables->byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    __m256i byte_1_low = _mm256_shuffle_epi8(tables->byte_1_low, _mm256_and_si256(prev1, nibble));
+    __m256i byte_2_high = _mm256_shuffle_epi8(tables->byte_2_high, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble));
+    __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+    
+    // Only bytes >= 0xE0 (two back) or >= 0xF0 (three back) keep their top bit after these subtractions
+    __m256i third = _mm256_subs_epu8(GUIARSTR_UTF8_PREV(block, prev, 2), _mm256_set1_epi8((char)(0xE0 - 0x80)));
+    __m256i fourth = _mm256_subs_epu8(GUIARSTR_UTF8_PREV(block, prev, 3), _mm256_set1_epi8((char)(0xF0 - 0x80)));
+    __m256i must_continue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8((char)0x80));
+    
+    return _mm256_xor_si256(must_continue, special);
+}
+
+// Returns the start of the first 64-byte block with an error, or where the full blocks end.
+// A sequence left open at the end of a block is only reported with the next one.
+__attribute__((target("avx2")))
+static size_t guiarstr_utf8_check_avx2(const unsigned char* s, size_t len) {
+    GuiarStrUtf8Tables tables;
+    guiarstr_utf8_tables_avx2(&tables);
+    
+    // A block leaves a sequence open when one of its last three bytes starts a longer one
+    const __m256i open_limit = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+    __m256i prev = _mm256_setzero_si256();
+    __m256i open = _mm256_setzero_si256();
+    size_t i = 0;
+    
+    for (; i + 64 <= len; i += 64) {
+        __m256i lo = _mm256_loadu_si256((const __m256i*)(s + i));
+        __m256i hi = _mm256_loadu_si256((const __m256i*)(s + i + 32));
+        __m256i error = open;
+        
+        if (!_mm256_movemask_epi8(_mm256_or_si256(lo, hi))) {
+            open = _mm256_setzero_si256();
+        } else {
+            error = _mm256_or_si256(guiarstr_utf8_block_errors_avx2(&tables, lo, prev),
+                                    guiarstr_utf8_block_errors_avx2(&tables, hi, lo));
+            open = _mm256_subs_epu8(hi, open_limit);
+        }
+        if (!_mm256_testz_si256(error, error)) {
+            return i;
+        }
+        prev = hi;
+    }
+    return i;
+}
+#endif
+
+// Offset of the first byte of the first invalid or truncated sequence, (size_t)-1 if there is none
+static size_t guiarstr_utf8_error(const unsigned char* s, size_t len) {
+    size_t checked = 0;
+    
+#ifdef GUIARSTR_HAVE_AVX2
+    if (len >= 64 && __builtin_cpu_supports("avx2")) {
+        checked = guiarstr_utf8_check_avx2(s, len);
+        
+        // Everything before checked is valid except possibly a sequence its last three bytes opened
+        for (size_t back = 1; back <= 3 && back <= checked; back++) {
+            if ((s[checked - back] & 0xC0) != 0x80) {
+                checked -= back;
+                break;
+            }
+        }
+    }
+#endif
+    return guiarstr_utf8_error_scalar(s, checked, len);
+}
+
+static bool guiarstr_owns_data(const GuiarStr* str) {
+    return !(str->flags & (GUIARSTR_FLAG_INLINE | GUIARSTR_FLAG_BORROWED | GUIARSTR_FLAG_SHARED | GUIARSTR_FLAG_MAPPED));
+}
+
+static void guiarstr_release_data(GuiarStr* str) {
+    if (str->flags & GUIARSTR_FLAG_SHARED) {
+        GuiarStrSharedHeader* header = guiarstr_shared_header(str);
+        if (GUIARSTR_ATOMIC_DEC(&header->refs) == 0) {
+            guiarstr_mem_free(str->allocator, header);
+        }
+#ifdef GUIARSTR_HAVE_MMAP
+    } else if (str->flags & GUIARSTR_FLAG_MAPPED) {
+        munmap(str->data, str->capacity);
+#endif
+    } else if (guiarstr_owns_data(str)) {
+        guiarstr_mem_free(str->allocator, str->data);
+    }
+}
+
+#ifdef GUIARSTR_HAVE_MMAP
+// Huge buffers bypass malloc so that growing them can remap pages instead of copying.
+// Custom allocators keep full control of their strings.
+static bool guiarstr_use_mapping(const GuiarStr* str, size_t capacity) {
+    size_t threshold = guiarstr_str_policy(str)->mmap_threshold;
+    return threshold && capacity >= threshold && str->allocator == &guiarstr_default_allocator;
+}
+
+static char* guiarstr_map_pages(size_t size, bool huge_pages) {
+    void* pages = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pages == MAP_FAILED) {
+        return NULL;
+    }
+    
+#ifdef MADV_HUGEPAGE
+    if (huge_pages) {
+        madvise(pages, size, MADV_HUGEPAGE);
+    }
+#else
+    (void)huge_pages;
+#endif
+    
+    return pages;
+}
+
+static GuiarStrError guiarstr_set_mapped_capacity(GuiarStr* str, size_t new_capacity) {
+    bool huge_pages = guiarstr_str_policy(str)->huge_pages;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    char* new_data;
+    
+    if (new_capacity > SIZE_MAX - page) {
+        return GUIARSTR_ERR_OVERFLOW;
+    }
+    new_capacity = (new_capacity + page - 1) / page * page;
+    
+    if (str->flags & GUIARSTR_FLAG_MAPPED) {
+#ifdef GUIARSTR_HAVE_MREMAP
+        void* pages = mremap(str->data, str->capacity, new_capacity, MREMAP_MAYMOVE);
+        new_data = pages == MAP_FAILED ? NULL : pages;
+#ifdef MADV_HUGEPAGE
+        if (new_data && huge_pages) {
+            madvise(new_data, new_capacity, MADV_HUGEPAGE);
+        }
+#endif
+#else
+        new_data = guiarstr_map_pages(new_capacity, huge_pages);
+        if (new_data) {
+            memcpy(new_data, str->data, str->length + 1);
+            munmap(str->data, str->capacity);
+        }
+#endif
+    } else {
+        new_data = guiarstr_map_pages(new_capacity, huge_pages);
+        if (new_data) {
+            memcpy(new_data, str->data, str->length + 1);
+            guiarstr_release_data(str);
+        }
+    }
+    
+    if (!new_data) {
+        return GUIARSTR_ERR_MEMORY;
+    }
+    
+    str->data = new_data;
+    str->capacity = new_capacity;
+    str->flags = (str->flags & GUIARSTR_FLAG_EMBEDDED) | GUIARSTR_FLAG_MAPPED;
+    return GUIARSTR_OK;
+}
+#endif
+
+// Moves inline, caller-provided, shared or mapped data to its own heap buffer the first time it has to change
+static GuiarStrError guiarstr_set_capacity(GuiarStr* str, size_t new_capacity) {
+    char* new_data;
+    
+#ifdef GUIARSTR_HAVE_MMAP
+    if (guiarstr_use_mapping(str, new_capacity)) {
+        return guiarstr_set_mapped_capacity(str, new_capacity);
+    }
+#endif
+    
+    if (guiarstr_owns_data(str)) {
+        new_data = guiarstr_mem_realloc(str->allocator, str->data, str->capacity, new_capacity);
+    } else {
+        new_data = guiarstr_mem_alloc(str->allocator, new_capacity);
+        if (new_data) {
+            memcpy(new_data, str->data, str->length + 1);
+            guiarstr_release_data(str);
+        }
+    }
+    
+    if (!new_data) {
+        return GUIARSTR_ERR_MEMORY;
+    }
+    
+    str->data = new_data;
+    str->capacity = new_capacity;
+    str->flags &= ~(GUIARSTR_FLAG_INLINE | GUIARSTR_FLAG_BORROWED | GUIARSTR_FLAG_SHARED | GUIARSTR_FLAG_MAPPED);
+    return GUIARSTR_OK;
+}
+
+// Copy-on-write: a string whose data is still referenced elsewhere gets a private copy
+static GuiarStrError guiarstr_make_unique(GuiarStr* str) {
+    if ((str->flags & GUIARSTR_FLAG_SHARED) && GUIARSTR_ATOMIC_LOAD(&guiarstr_shared_header(str)->refs) > 1) {
+        return guiarstr_set_capacity(str, str->capacity);
+    }
+    
+    return GUIARSTR_OK;
+}
+
+// Growth shared by every growable buffer type
+static GuiarStrError guiarstr_grow_capacity(const GuiarStrGrowthPolicy* policy, size_t capacity, size_t required,
+                                            size_t* new_capacity) {
+    size_t result = capacity < GUIARSTR_MIN_CAPACITY ? GUIARSTR_MIN_CAPACITY : capacity;
+    
+    while (result < required) {
+        double grown = (double)result * policy->growth_factor;
+        if (grown >= (double)SIZE_MAX) { // Overflow check
+            result = required;
+            break;
+        }
+        
+        size_t next = (size_t)grown;
+        result = next > result ? next : required;
+    }
+    
+    size_t page = policy->page_size;
+    if (page && result >= page) {
+        if (result > SIZE_MAX - (page - 1)) {
+            return GUIARSTR_ERR_OVERFLOW;
+        }
+        result = (result + page - 1) / page * page;
+    }
+    
+    *new_capacity = result;
+    return GUIARSTR_OK;
+}
+
+static GuiarStrError guiarstr_ensure_capacity(GuiarStr* str, size_t required) {
+    GuiarStrError err = guiarstr_make_unique(str);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    if (str->capacity >= required) {
+        return GUIARSTR_OK;
+    }
+    
+    size_t new_capacity;
+    err = guiarstr_grow_capacity(guiarstr_str_policy(str), str->capacity, required, &new_capacity);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    return guiarstr_set_capacity(str, new_capacity);
+}
+
+static GuiarStr* guiarstr_alloc_str(const GuiarStrAllocator* allocator, size_t capacity) {
+    allocator = guiarstr_resolve_allocator(allocator);
+    
+    if (capacity < GUIARSTR_MIN_CAPACITY) {
+        capacity = GUIARSTR_MIN_CAPACITY;
+    }
+    
+    // Short strings live right behind the header: one allocation instead of two
+    if (capacity <= GUIARSTR_SSO_CAPACITY) {
+        GuiarStr* result = guiarstr_mem_alloc(allocator, sizeof(GuiarStr) + capacity);
+        if (!result) {
+            return NULL;
+        }
+        
+        result->data = (char*)(result + 1);
+        result->data[0] = '\0';
+        result->length = 0;
+        result->capacity = capacity;
+        result->allocator = allocator;
+        result->policy = NULL;
+        result->flags = GUIARSTR_FLAG_INLINE;
+        
+        return result;
+    }
+    
+    GuiarStr* result = guiarstr_mem_alloc(allocator, sizeof(GuiarStr));
+    if (!result) {
+        return NULL;
+    }
+    
+    result->data = guiarstr_mem_alloc(allocator, capacity);
+    if (!result->data) {
+        guiarstr_mem_free(allocator, result);
+        return NULL;
+    }
+    
+    result->data[0] = '\0';
+    result->length = 0;
+    result->capacity = capacity;
+    result->allocator = allocator;
+    result->policy = NULL;
+    result->flags = 0;
+    
+    return result;
+}
+
+static GuiarStr* guiarstr_create_len_impl(const GuiarStrAllocator* allocator, const char* str, size_t len) {
+    if (len == (size_t)-1) {
+        return NULL;
+    }
+    
+    GuiarStr* result = guiarstr_alloc_str(allocator, len + 1);
+    if (!result) {
+        return NULL;
+    }
+    
+    memcpy(result->data, str, len);
+    result->data[len] = '\0';
+    result->length = len;
+    
+    return result;
+}
+
+static GuiarStr* guiarstr_copy_impl(const GuiarStrAllocator* allocator, const GuiarStr* str) {
+    allocator = guiarstr_resolve_allocator(allocator);
+    
+    // Shared data only needs another reference
+    if ((str->flags & GUIARSTR_FLAG_SHARED) && allocator == str->allocator) {
+        GuiarStr* result = guiarstr_mem_alloc(allocator, sizeof(GuiarStr));
+        if (!result) {
+            return NULL;
+        }
+        
+        GUIARSTR_ATOMIC_INC(&guiarstr_shared_header(str)->refs);
+        *result = *str;
+        result->flags = GUIARSTR_FLAG_SHARED;
+        return result;
+    }
+    
+    GuiarStr* result = guiarstr_alloc_str(allocator, str->length + 1);
+    if (!result) {
+        return NULL;
+    }
+    
+    memcpy(result->data, str->data, str->length + 1);
+    result->length = str->length;
+    result->policy = str->policy;
+    
+    return result;
+}
+
+// Memory management
+GuiarStr* guiarstr_create(const char* str) {
+    if (!str) {
+        return NULL;
+    }
+    
+    return guiarstr_create_len_impl(NULL, str, strlen(str));
+}
+
+GuiarStr* guiarstr_create_len(const char* str, size_t len) {
+    if (!str) {
+        return NULL;
+    }
+    
+    return guiarstr_create_len_impl(NULL, str, len);
+}
+
+GuiarStr* guiarstr_create_empty(size_t initial_capacity) {
+    return guiarstr_alloc_str(NULL, initial_capacity);
+}
+
+GuiarStr* guiarstr_copy(const GuiarStr* str) {
+    if (!str) {
+        return NULL;
+    }
+    
+    return guiarstr_copy_impl(NULL, str);
+}
+
+GuiarStr* guiarstr_create_arena(GuiarStrArena* arena, const char* str) {
+    if (!arena || !str) {
+        return NULL;
+    }
+    
+    return guiarstr_create_len_impl(&arena->allocator, str, strlen(str));
+}
+
+GuiarStr* guiarstr_create_len_arena(GuiarStrArena* arena, const char* str, size_t len) {
+    if (!arena || !str) {
+        return NULL;
+    }
+    
+    return guiarstr_create_len_impl(&arena->allocator, str, len);
+}
+
+GuiarStr* guiarstr_create_empty_arena(GuiarStrArena* arena, size_t initial_capacity) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    
+    return guiarstr_alloc_str(&arena->allocator, initial_capacity);
+}
+
+GuiarStr* guiarstr_copy_arena(GuiarStrArena* arena, const GuiarStr* str) {
+    if (!arena || !str) {
+        return NULL;
+    }
+    
+    return guiarstr_copy_impl(&arena->allocator, str);
+}
+
+GuiarStr* guiarstr_create_with_allocator(const char* str, const GuiarStrAllocator* allocator) {
+    if (!str) {
+        return NULL;
+    }
+    
+    return guiarstr_create_len_impl(allocator, str, strlen(str));
+}
+
+GuiarStr* guiarstr_create_empty_with_allocator(size_t initial_capacity, const GuiarStrAllocator* allocator) {
+    return guiarstr_alloc_str(allocator, initial_capacity);
+}
+
+GuiarStr* guiarstr_view_copy(const GuiarStrView* view) {
+    if (!view || !view->data) {
+        return NULL;
+    }
+    
+    return guiarstr_create_len(view->data, view->length);
+}
+
+void guiarstr_free(GuiarStr* str) {
+    if (str) {
+        guiarstr_release_data(str);
+        if (!(str->flags & GUIARSTR_FLAG_EMBEDDED)) {
+            guiarstr_mem_free(str->allocator, str);
+        }
+    }
+}
+
+GuiarStrError guiarstr_reserve(GuiarStr* str, size_t new_capacity) {
+    GUIARSTR_CHECK_NULL(str);
+    
+    if (new_capacity <= str->capacity) {
+        return GUIARSTR_OK;
+    }
+    
+    return guiarstr_set_capacity(str, new_capacity);
+}
+
+GuiarStrError guiarstr_resize(GuiarStr* str, size_t new_length, char fill_char) {
+    GUIARSTR_CHECK_NULL(str);
+    
+    GuiarStrError err = guiarstr_ensure_capacity(str, new_length + 1);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    if (new_length > str->length) {
+        memset(str->data + str->length, fill_char, new_length - str->length);
+    }
+    
+    str->data[new_length] = '\0';
+    str->length = new_length;
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_shrink_to_fit(GuiarStr* str) {
+    GUIARSTR_CHECK_NULL(str);
+    
+    size_t min_capacity = str->length + 1;
+    if (min_capacity < GUIARSTR_MIN_CAPACITY) {
+        min_capacity = GUIARSTR_MIN_CAPACITY;
+    }
+    
+    // Inline, caller-provided and shared storage cannot shrink
+    if (str->capacity <= min_capacity || (!guiarstr_owns_data(str) && !(str->flags & GUIARSTR_FLAG_MAPPED))) {
+        return GUIARSTR_OK;
+    }
+    
+    return guiarstr_set_capacity(str, min_capacity);
+}
+
+// Embedded strings (the GuiarStr header is owned by the caller)
+GuiarStrError guiarstr_init(GuiarStr* str, const char* init) {
+    GUIARSTR_CHECK_NULL(str);
+    GUIARSTR_CHECK_NULL(init);
+    
+    size_t len = strlen(init);
+    GuiarStrError err = guiarstr_init_empty(str, len + 1);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    memcpy(str->data, init, len + 1);
+    str->length = len;
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_init_empty(GuiarStr* str, size_t initial_capacity) {
+    GUIARSTR_CHECK_NULL(str);
+    
+    if (initial_capacity < GUIARSTR_MIN_CAPACITY) {
+        initial_capacity = GUIARSTR_MIN_CAPACITY;
+    }
+    
+    str->allocator = guiarstr_resolve_allocator(NULL);
+    str->data = guiarstr_mem_alloc(str->allocator, initial_capacity);
+    if (!str->data) {
+        return GUIARSTR_ERR_MEMORY;
+    }
+    
+    str->data[0] = '\0';
+    str->length = 0;
+    str->capacity = initial_capacity;
+    str->policy = NULL;
+    str->flags = GUIARSTR_FLAG_EMBEDDED;
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_init_with_buffer(GuiarStr* str, char* buffer, size_t capacity) {
+    GUIARSTR_CHECK_NULL(str);
+    GUIARSTR_CHECK_NULL(buffer);
+    
+    if (capacity == 0) {
+        return GUIARSTR_ERR_INVALID;
+    }
+    
+    buffer[0] = '\0';
+    str->data = buffer;
+    str->length = 0;
+    str->capacity = capacity;
+    str->allocator = guiarstr_resolve_allocator(NULL);
+    str->policy = NULL;
+    str->flags = GUIARSTR_FLAG_EMBEDDED | GUIARSTR_FLAG_BORROWED;
+    return GUIARSTR_OK;
+}
+
+void guiarstr_deinit(GuiarStr* str) {
+    if (!str) return;
+    
+    guiarstr_release_data(str);
+    
+    str->data = NULL;
+    str->length = 0;
+    str->capacity = 0;
+}
+
+// Shared (copy-on-write) strings
+GuiarStr* guiarstr_create_shared(const char* str) {
+    GuiarStr* result = guiarstr_create(str);
+    if (!result) {
+        return NULL;
+    }
+    
+    if (guiarstr_share(result) != GUIARSTR_OK) {
+        guiarstr_free(result);
+        return NULL;
+    }
+    
+    return result;
+}
+
+GuiarStrError guiarstr_share(GuiarStr* str) {
+    GUIARSTR_CHECK_NULL(str);
+    
+    if (str->flags & GUIARSTR_FLAG_SHARED) {
+        return GUIARSTR_OK;
+    }
+    
+    char* data = guiarstr_shared_alloc(str->allocator, str->length + 1);
+    if (!data) {
+        return GUIARSTR_ERR_MEMORY;
+    }
+    
+    memcpy(data, str->data, str->length + 1);
+    guiarstr_release_data(str);
+    
+    str->data = data;
+    str->capacity = str->length + 1;
+    str->flags = (str->flags & GUIARSTR_FLAG_EMBEDDED) | GUIARSTR_FLAG_SHARED;
+    return GUIARSTR_OK;
+}
+
+bool guiarstr_is_shared(const GuiarStr* str) {
+    if (!str || !(str->flags & GUIARSTR_FLAG_SHARED)) {
+        return false;
+    }
+    
+    return GUIARSTR_ATOMIC_LOAD(&guiarstr_shared_header(str)->refs) > 1;
+}
+
+// Basic string manipulation
+char* guiarstr_trim(char* str) {
+    if (!str) return NULL;
+    
+    while (guiarstr_ascii_isspace((unsigned char)*str)) str++;
+    
+    if (*str == '\0') return str;
+    
+    char* end = str + strlen(str) - 1;
+    while (end > str && guiarstr_ascii_isspace((unsigned char)*end)) end--;
+    
+    *(end + 1) = '\0';
+    return str;
+}
+
+char* guiarstr_strip(char* str, const char* chars_to_remove) {
+    if (!str || !chars_to_remove) return str;
+    
+    GuiarStrCharSet set;
+    guiarstr_charset_init(&set, chars_to_remove);
+    return guiarstr_strip_set(str, &set);
+}
+
+void guiarstr_tolower(char* str) {
+    if (!str) return;
+    
+    guiarstr_ascii_case(str, str, strlen(str), false);
+}
+
+void guiarstr_toupper(char* str) {
+    if (!str) return;
+    
+    guiarstr_ascii_case(str, str, strlen(str), true);
+}
+
+void guiarstr_tolower_len(char* data, size_t len) {
+    if (!data) return;
+    
+    guiarstr_ascii_case(data, data, len, false);
+}
+
+void guiarstr_toupper_len(char* data, size_t len) {
+    if (!data) return;
+    
+    guiarstr_ascii_case(data, data, len, true);
+}
+
+// Dynamic string operations
+GuiarStrError guiarstr_append(GuiarStr* str, const char* append) {
+    if (!append) {
+        return GUIARSTR_ERR_NULL;
+    }
+    
+    return guiarstr_append_len(str, append, strlen(append));
+}
+
+GuiarStrError guiarstr_append_len(GuiarStr* str, const char* append, size_t len) {
+    GUIARSTR_CHECK_NULL(str);
+    if (!append && len > 0) {
+        return GUIARSTR_ERR_NULL;
+    }
+    
+    if (len == 0) {
+        return GUIARSTR_OK;
+    }
+    
+    GuiarStrError err = guiarstr_ensure_capacity(str, str->length + len + 1);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    memcpy(str->data + str->length, append, len);
+    str->length += len;
+    str->data[str->length] = '\0';
+    
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_append_char(GuiarStr* str, char c) {
+    GUIARSTR_CHECK_NULL(str);
+    
+    GuiarStrError err = guiarstr_ensure_capacity(str, str->length + 2);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    str->data[str->length++] = c;
+    str->data[str->length] = '\0';
+    
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_append_view(GuiarStr* str, const GuiarStrView* view) {
+    GUIARSTR_CHECK_NULL(str);
+    GUIARSTR_CHECK_NULL(view);
+    
+    return guiarstr_append_len(str, view->data, view->length);
+}
+
+GuiarStrError guiarstr_append_str(GuiarStr* str, const GuiarStr* append) {
+    GUIARSTR_CHECK_NULL(str);
+    GUIARSTR_CHECK_NULL(append);
+    
+    if (append != str) {
+        return guiarstr_append_len(str, append->data, append->length);
+    }
+    
+    // Self-append: growing may move the source, so copy from the new buffer
+    size_t len = str->length;
+    if (len == 0) {
+        return GUIARSTR_OK;
+    }
+    if (len > (SIZE_MAX - 1) / 2) {
+        return GUIARSTR_ERR_OVERFLOW;
+    }
+    
+    GuiarStrError err = guiarstr_ensure_capacity(str, len * 2 + 1);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    memcpy(str->data + len, str->data, len);
+    str->length = len * 2;
+    str->data[str->length] = '\0';
+    
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_insert(GuiarStr* str, size_t pos, const char* insert) {
+    if (!insert) {
+        return GUIARSTR_ERR_NULL;
+    }
+    
+    return guiarstr_insert_len(str, pos, insert, strlen(insert));
+}
+
+GuiarStrError guiarstr_insert_len(GuiarStr* str, size_t pos, const char* insert, size_t len) {
+    GUIARSTR_CHECK_NULL(str);
+    if (!insert && len > 0) {
+        return GUIARSTR_ERR_NULL;
+    }
+    
+    if (len == 0) {
+        return GUIARSTR_OK;
+    }
+    
+    if (pos > str->length) {
+        pos = str->length;
+    }
+    
+    GuiarStrError err = guiarstr_ensure_capacity(str, str->length + len + 1);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    memmove(str->data + pos + len, str->data + pos, str->length - pos);
+    memcpy(str->data + pos, insert, len);
+    str->length += len;
+    str->data[str->length] = '\0';
+    
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_insert_str(GuiarStr* str, size_t pos, const GuiarStr* insert) {
+    GUIARSTR_CHECK_NULL(str);
+    GUIARSTR_CHECK_NULL(insert);
+    
+    if (insert != str) {
+        return guiarstr_insert_len(str, pos, insert->data, insert->length);
+    }
+    
+    size_t len = str->length;
+    if (len == 0) {
+        return GUIARSTR_OK;
+    }
+    if (len > (SIZE_MAX - 1) / 2) {
+        return GUIARSTR_ERR_OVERFLOW;
+    }
+    if (pos > len) {
+        pos = len;
+    }
+    
+    GuiarStrError err = guiarstr_ensure_capacity(str, len * 2 + 1);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    // Self-insert: after opening the hole, the original tail sits at pos + len
+    memmove(str->data + pos + len, str->data + pos, len - pos);
+    memcpy(str->data + pos, str->data, pos);
+    memcpy(str->data + pos * 2, str->data + pos + len, len - pos);
+    str->length = len * 2;
+    str->data[str->length] = '\0';
+    
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_insert_char(GuiarStr* str, size_t pos, char c) {
+    GUIARSTR_CHECK_NULL(str);
+    
+    if (pos > str->length) {
+        pos = str->length;
+    }
+    
+    GuiarStrError err = guiarstr_ensure_capacity(str, str->length + 2);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    memmove(str->data + pos + 1, str->data + pos, str->length - pos);
+    str->data[pos] = c;
+    str->length++;
+    str->data[str->length] = '\0';
+    
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_remove(GuiarStr* str, size_t pos, size_t len) {
+    GUIARSTR_CHECK_NULL(str);
+    
+    if (pos >= str->length) {
+        return GUIARSTR_OK;
+    }
+    
+    if (pos + len > str->length) {
+        len = str->length - pos;
+    }
+    
+    GuiarStrError err = guiarstr_make_unique(str);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    memmove(str->data + pos, str->data + pos + len, str->length - pos - len);
+    str->length -= len;
+    str->data[str->length] = '\0';
+    
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_clear(GuiarStr* str) {
+    GUIARSTR_CHECK_NULL(str);
+    
+    GuiarStrError err = guiarstr_make_unique(str);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    str->length = 0;
+    str->data[0] = '\0';
+    
+    return GUIARSTR_OK;
+}
+
+// String inspection and search
+bool guiarstr_startswith(const char* str, const char* prefix) {
+    if (!str || !prefix) return false;
+    
+    while (*prefix) {
+        if (*str++ != *prefix++) return false;
+    }
+    
+    return true;
+}
+
+bool guiarstr_endswith(const char* str, const char* suffix) {
+    if (!str || !suffix) return false;
+    
+    size_t lenstr = strlen(str);
+    size_t lensuffix = strlen(suffix);
+    
+    if (lensuffix > lenstr) return false;
+    
+    return strcmp(str + lenstr - lensuffix, suffix) == 0;
+}
+
+bool guiarstr_startswithi(const char* str, const char* prefix) {
+    if (!str || !prefix) return false;
+    
+    // A NUL inside the first lenprefix bytes means str is shorter than the prefix
+    size_t lenprefix = strlen(prefix);
+    if (guiarstr_nul_offset(str, lenprefix) < lenprefix) return false;
+    
+    return guiarstr_ascii_equalsi(str, prefix, lenprefix);
+}
+
+bool guiarstr_endswithi(const char* str, const char* suffix) {
+    if (!str || !suffix) return false;
+    
+    size_t lenstr = strlen(str);
+    size_t lensuffix = strlen(suffix);
+    
+    if (lensuffix > lenstr) return false;
+    
+    return guiarstr_ascii_equalsi(str + lenstr - lensuffix, suffix, lensuffix);
+}
+
+bool guiarstr_contains(const char* str, const char* substr) {
+    return guiarstr_find(str, substr) != (size_t)-1;
+}
+
+size_t guiarstr_count(const char* str, const char* substr) {
+    if (!str || !substr || !*substr) return 0;
+    
+    GuiarStrPattern pattern;
+    guiarstr_pattern_setup(&pattern, substr, strlen(substr), 0);
+    return guiarstr_cstr_count(str, &pattern);
+}
+
+// Advanced search
+size_t guiarstr_find(const char* str, const char* substr) {
+    return guiarstr_find_from(str, substr, 0);
+}
+
+size_t guiarstr_find_from(const char* str, const char* substr, size_t from_pos) {
+    if (!str || !substr) return (size_t)-1;
+    
+    if (guiarstr_nul_offset(str, from_pos) < from_pos) return (size_t)-1;
+    
+    // Up to two bytes the filter tests the same bytes as the C library's strstr, whose kernels
+    // are tuned per platform and start faster
+    size_t len = strlen(substr);
+    const char* found;
+    if (len <= 2) {
+        found = strstr(str + from_pos, substr);
+    } else {
+        GuiarStrPattern pattern;
+        guiarstr_pattern_setup(&pattern, substr, len, 0);
+        found = guiarstr_cstr_search(str + from_pos, &pattern);
+    }
+    return found ? (size_t)(found - str) : (size_t)-1;
+}
+
+size_t guiarstr_rfind(const char* str, const char* substr) {
+    return guiarstr_rfind_from(str, substr, (size_t)-1);
+}
+
+// Last match starting at or before from_pos; positions past the end search the whole string
+size_t guiarstr_rfind_from(const char* str, const char* substr, size_t from_pos) {
+    if (!str || !substr) return (size_t)-1;
+    
+    return guiarstr_view_rfind_from(guiarstr_view_from_cstr(str), guiarstr_view_from_cstr(substr), from_pos);
+}
+
+size_t guiarstr_find_char(const char* str, char c) {
+    if (!str) return (size_t)-1;
+    
+    const char* found = strchr(str, c);
+    return found ? (size_t)(found - str) : (size_t)-1;
+}
+
+size_t guiarstr_find_char_from(const char* str, char c, size_t from_pos) {
+    if (!str) return (size_t)-1;
+    
+    size_t str_len = strlen(str);
+    if (from_pos > str_len) return (size_t)-1;
+    
+    const char* found = strchr(str + from_pos, c);
+    return found ? (size_t)(found - str) : (size_t)-1;
+}
+
+size_t guiarstr_rfind_char(const char* str, char c) {
+    if (!str) return (size_t)-1;
+    
+    const char* found = strrchr(str, c);
+    return found ? (size_t)(found - str) : (size_t)-1;
+}
+
+size_t guiarstr_find_any(const char* str, const char* chars) {
+    if (!str || !chars) return (size_t)-1;
+    
+    GuiarStrCharSet set;
+    guiarstr_charset_init(&set, chars);
+    return guiarstr_charset_cstr_scan(&set, str, true);
+}
+
+size_t guiarstr_rfind_any(const char* str, const char* chars) {
+    if (!str || !chars) return (size_t)-1;
+    
+    GuiarStrCharSet set;
+    guiarstr_charset_init(&set, chars);
+    return guiarstr_rfind_any_set(str, &set);
+}
+
+size_t guiarstr_find_any_from(const char* str, const char* chars, size_t from_pos) {
+    if (!str || !chars) return (size_t)-1;
+    
+    GuiarStrCharSet set;
+    guiarstr_charset_init(&set, chars);
+    return guiarstr_find_any_from_set(str, &set, from_pos);
+}
+
+size_t guiarstr_find_not_any(const char* str, const char* chars) {
+    if (!str || !chars) return (size_t)-1;
+    
+    GuiarStrCharSet set;
+    guiarstr_charset_init(&set, chars);
+    return guiarstr_charset_cstr_scan(&set, str, false);
+}
+
+size_t guiarstr_find_not_any_from(const char* str, const char* chars, size_t from_pos) {
+    if (!str || !chars) return (size_t)-1;
+    
+    GuiarStrCharSet set;
+    guiarstr_charset_init(&set, chars);
+    return guiarstr_find_not_any_from_set(str, &set, from_pos);
+}
+
+// Character sets
+GuiarStrError guiarstr_charset_init(GuiarStrCharSet* set, const char* chars) {
+    GuiarStrError err = guiarstr_charset_init_len(set, chars, chars ? strlen(chars) : 0);
+    return (err == GUIARSTR_OK && !chars) ? GUIARSTR_ERR_NULL : err;
+}
+
+GuiarStrError guiarstr_charset_init_len(GuiarStrCharSet* set, const char* chars, size_t len) {
+    GUIARSTR_CHECK_NULL(set);
+    
+    // A rejected set is left empty rather than uninitialized
+    memset(set, 0, sizeof(GuiarStrCharSet));
+    if (!chars && len > 0) {
+        return GUIARSTR_ERR_NULL;
+    }
+    
+    for (size_t i = 0; i < len; i++) {
+        guiarstr_charset_add(set, (unsigned char)chars[i]);
+    }
+    return GUIARSTR_OK;
+}
+
+void guiarstr_charset_add(GuiarStrCharSet* set, unsigned char c) {
+    if (!set || guiarstr_charset_has(set, c)) return;
+    
+    set->bits[c >> 3] |= (uint8_t)(1u << (c & 7));
+    set->rows[c >> 7][c & 15] |= (uint8_t)(1u << ((c >> 4) & 7));
+    
+    // Unused member slots repeat the first member so the compares need no count
+    if (set->count < GUIARSTR_CHARSET_MEMBERS) {
+        for (size_t i = set->count; i < GUIARSTR_CHARSET_MEMBERS; i++) {
+            set->members[i] = set->count ? set->members[0] : c;
+        }
+        set->members[set->count] = c;
+    }
+    set->count++;
+}
+
+bool guiarstr_charset_contains(const GuiarStrCharSet* set, unsigned char c) {
+    return set && guiarstr_charset_has(set, c);
+}
+
+static size_t guiarstr_find_set_from(const char* str, const GuiarStrCharSet* set, size_t from_pos, bool want) {
+    if (!str || !set) return (size_t)-1;
+    if (guiarstr_nul_offset(str, from_pos) < from_pos) return (size_t)-1;
+    
+    size_t pos = from_pos + guiarstr_charset_cstr_scan(set, str + from_pos, want);
+    return str[pos] ? pos : (size_t)-1;
+}
+
+size_t guiarstr_find_any_from_set(const char* str, const GuiarStrCharSet* set, size_t from_pos) {
+    return guiarstr_find_set_from(str, set, from_pos, true);
+}
+
+size_t guiarstr_find_not_any_from_set(const char* str, const GuiarStrCharSet* set, size_t from_pos) {
+    return guiarstr_find_set_from(str, set, from_pos, false);
+}
+
+size_t guiarstr_rfind_any_set(const char* str, const GuiarStrCharSet* set) {
+    if (!str || !set) return (size_t)-1;
+    
+    return guiarstr_view_rfind_any_set(guiarstr_view_from_cstr(str), set);
+}
+
+char* guiarstr_strip_set(char* str, const GuiarStrCharSet* set) {
+    if (!str || !set) return str;
+    
+    GuiarStrView stripped = guiarstr_view_strip_set(guiarstr_view_from_cstr(str), set);
+    char* start = str + (stripped.data - str);
+    start[stripped.length] = '\0';
+    return start;
+}
+
+// Alternates between copying a run of kept bytes and skipping a run of removed ones
+char* guiarstr_remove_chars_set(const char* str, const GuiarStrCharSet* set) {
+    if (!str || !set) return NULL;
+    
+    size_t len = strlen(str);
+    char* result = guiarstr_mem_alloc(NULL, len + 1);
+    if (!result) return NULL;
+    
+    size_t i = 0;
+    size_t j = 0;
+    while (i < len) {
+        size_t keep = guiarstr_charset_scan(set, str + i, len - i, true);
+        memcpy(result + j, str + i, keep);
+        i += keep;
+        j += keep;
+        i += guiarstr_charset_scan(set, str + i, len - i, false);
+    }
+    
+    result[j] = '\0';
+    return result;
+}
+
+// String modification
+char* guiarstr_reverse(const char* str) {
+    if (!str) return NULL;
+    
+    size_t len = strlen(str);
+    char* reversed = guiarstr_mem_alloc(NULL, len + 1);
+    if (!reversed) return NULL;
+    
+    const char* p = str + len;
+    char* out = reversed;
+    
+    while (p > str) {
+        const char* start = p - 1;
+        while (start > str && (*start & 0xC0) == 0x80) start--;
+        
+        int char_len = p - start;
+        memcpy(out, start, char_len);
+        out += char_len;
+        p = start;
+    }
+    
+    *out = '\0';
+    return reversed;
+}
+
+static size_t guiarstr_replace_count(const GuiarStrPattern* from, const char* data, size_t len, size_t max_replacements) {
+    if (max_replacements == 0) return 0;
+    
+    GuiarStrMatches matches;
+    guiarstr_matches_init(&matches, NULL, 0, max_replacements);
+    guiarstr_pattern_scan(from, data, 0, len, &matches);
+    return matches.count;
+}
+
+// Copies len bytes from src to dst with up to max_replacements matches of from replaced by to and
+// returns the new length. Forward only, so dst may equal src when to is not longer than from, or
+// trail it by the total growth otherwise: the writes then never overtake the reads.
+static size_t guiarstr_replace_compact(const GuiarStrPattern* from, GuiarStrView to, char* dst, const char* src, size_t len,
+                                       size_t max_replacements) {
+    const char* end = src + len;
+    char* start = dst;
+    const char* found;
+    size_t count = 0;
+    
+    while (count < max_replacements && (found = guiarstr_pattern_search(from, src, end - src))) {
+        if (dst != src) {
+            memmove(dst, src, found - src);
+        }
+        dst += found - src;
+        if (to.length) {
+            memcpy(dst, to.data, to.length);
+            dst += to.length;
+        }
+        src = found + from->length;
+        count++;
+    }
+    
+    if (dst != src) {
+        memmove(dst, src, end - src);
+    }
+    dst += end - src;
+    
+    return dst - start;
+}
+
+// Only a growing replacement needs the counting pass; otherwise the input length bounds the result
+static char* guiarstr_replace_pattern_impl(const GuiarStrAllocator* allocator, const char* str, const GuiarStrPattern* from,
+                                           const char* to, size_t max_replacements) {
+    if (!str || !from || !to || from->length == 0) return NULL;
+    
+    size_t to_len = strlen(to);
+    size_t str_len = strlen(str);
+    size_t result_len = str_len;
+    
+    if (to_len > from->length) {
+        max_replacements = guiarstr_replace_count(from, str, str_len, max_replacements);
+        
+        size_t extra = to_len - from->length;
+        if (max_replacements > (SIZE_MAX - 1 - str_len) / extra) return NULL;
+        result_len = str_len + max_replacements * extra;
+    }
+    
+    char* result = guiarstr_mem_alloc(allocator, result_len + 1);
+    if (!result) return NULL;
+    
+    result_len = guiarstr_replace_compact(from, guiarstr_view_from(to, to_len), result, str, str_len, max_replacements);
+    result[result_len] = '\0';
+    return result;
+}
+
+static char* guiarstr_replace_n_impl(const GuiarStrAllocator* allocator, const char* str, const char* from, const char* to, size_t max_replacements) {
+    if (!str || !from || !to || !*from) return NULL;
+    
+    GuiarStrPattern pattern;
+    guiarstr_pattern_setup(&pattern, from, strlen(from), 0);
+    return guiarstr_replace_pattern_impl(allocator, str, &pattern, to, max_replacements);
+}
+
+char* guiarstr_replace(const char* str, const char* from, const char* to) {
+    return guiarstr_replace_n_impl(NULL, str, from, to, (size_t)-1);
+}
+
+char* guiarstr_replace_n(const char* str, const char* from, const char* to, size_t max_replacements) {
+    return guiarstr_replace_n_impl(NULL, str, from, to, max_replacements);
+}
+
+char* guiarstr_replace_n_pattern(const char* str, const GuiarStrPattern* from, const char* to, size_t max_replacements) {
+    return guiarstr_replace_pattern_impl(NULL, str, from, to, max_replacements);
+}
+
+char* guiarstr_replace_arena(GuiarStrArena* arena, const char* str, const char* from, const char* to) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    
+    return guiarstr_replace_n_impl(&arena->allocator, str, from, to, (size_t)-1);
+}
+
+char* guiarstr_replace_n_arena(GuiarStrArena* arena, const char* str, const char* from, const char* to, size_t max_replacements) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    
+    return guiarstr_replace_n_impl(&arena->allocator, str, from, to, max_replacements);
+}
+
+char* guiarstr_replace_char(const char* str, char from, char to) {
+    if (!str) return NULL;
+    
+    size_t len = strlen(str);
+    char* result = guiarstr_mem_alloc(NULL, len + 1);
+    if (!result) return NULL;
+    
+    for (size_t i = 0; i < len; i++) {
+        result[i] = (str[i] == from) ? to : str[i];
+    }
+    
+    result[len] = '\0';
+    return result;
+}
+
+char* guiarstr_remove_chars(const char* str, const char* chars_to_remove) {
+    if (!str || !chars_to_remove) return NULL;
+    
+    GuiarStrCharSet set;
+    guiarstr_charset_init(&set, chars_to_remove);
+    return guiarstr_remove_chars_set(str, &set);
+}
+
+// Split and join
+static char** guiarstr_split_tokens(const GuiarStrAllocator* allocator, GuiarStrTokenizer* tok, size_t* count) {
+    GuiarStrView token;
+    size_t capacity = 0;
+    
+    while (guiarstr_tokenizer_next(tok, &token)) capacity++;
+    guiarstr_tokenizer_reset(tok);
+    
+    char** result = guiarstr_mem_alloc(allocator, (capacity ? capacity : 1) * sizeof(char*));
+    if (!result) {
+        *count = 0;
+        return NULL;
+    }
+    
+    size_t size = 0;
+    while (guiarstr_tokenizer_next(tok, &token)) {
+        char* copy = guiarstr_mem_alloc(allocator, token.length + 1);
+        if (!copy) goto cleanup;
+        
+        memcpy(copy, token.data, token.length);
+        copy[token.length] = '\0';
+        result[size++] = copy;
+    }
+    
+    *count = size;
+    return result;
+    
+cleanup:
+    for (size_t i = 0; i < size; ++i) guiarstr_mem_free(allocator, result[i]);
+    guiarstr_mem_free(allocator, result);
+    *count = 0;
+    return NULL;
+}
+
+static char** guiarstr_split_impl(const GuiarStrAllocator* allocator, const char* str, char delimiter, size_t* count) {
+    if (!str || !count) return NULL;
+    
+    GuiarStrTokenizer tok;
+    guiarstr_tokenizer_init(&tok, str, strlen(str), delimiter);
+    return guiarstr_split_tokens(allocator, &tok, count);
+}
+
+static char** guiarstr_split_pattern_impl(const GuiarStrAllocator* allocator, const char* str, const GuiarStrPattern* delimiter,
+                                          size_t* count) {
+    if (!str || !delimiter || !count) return NULL;
+    
+    GuiarStrTokenizer tok;
+    guiarstr_tokenizer_init_pattern(&tok, str, strlen(str), delimiter);
+    return guiarstr_split_tokens(allocator, &tok, count);
+}
+
+// The delimiter is compiled once for both tokenizer passes
+static char** guiarstr_split_str_impl(const GuiarStrAllocator* allocator, const char* str, const char* delimiter, size_t* count) {
+    if (!str || !delimiter || !count) return NULL;
+    
+    GuiarStrPattern pattern;
+    guiarstr_pattern_setup(&pattern, delimiter, strlen(delimiter), 0);
+    return guiarstr_split_pattern_impl(allocator, str, &pattern, count);
+}
+
+static char** guiarstr_split_any_impl(const GuiarStrAllocator* allocator, const char* str, const char* delimiters, size_t* count) {
+    if (!str || !delimiters || !count) return NULL;
+    
+    GuiarStrTokenizer tok;
+    guiarstr_tokenizer_init_any(&tok, str, strlen(str), delimiters);
+    return guiarstr_split_tokens(allocator, &tok, count);
+}
+
+static char** guiarstr_split_lines_impl(const GuiarStrAllocator* allocator, const char* str, size_t* count) {
+    if (!str || !count) return NULL;
+    
+    GuiarStrTokenizer tok;
+    guiarstr_tokenizer_init_lines(&tok, str, strlen(str));
+    return guiarstr_split_tokens(allocator, &tok, count);
+}
+
+char** guiarstr_split(const char* str, char delimiter, size_t* count) {
+    return guiarstr_split_impl(NULL, str, delimiter, count);
+}
+
+char** guiarstr_split_str(const char* str, const char* delimiter, size_t* count) {
+    return guiarstr_split_str_impl(NULL, str, delimiter, count);
+}
+
+char** guiarstr_split_str_pattern(const char* str, const GuiarStrPattern* delimiter, size_t* count) {
+    return guiarstr_split_pattern_impl(NULL, str, delimiter, count);
+}
+
+char** guiarstr_split_any(const char* str, const char* delimiters, size_t* count) {
+    return guiarstr_split_any_impl(NULL, str, delimiters, count);
+}
+
+char** guiarstr_split_any_set(const char* str, const GuiarStrCharSet* set, size_t* count) {
+    if (!str || !set || !count) return NULL;
+    
+    GuiarStrTokenizer tok;
+    guiarstr_tokenizer_init_set(&tok, str, strlen(str), set);
+    return guiarstr_split_tokens(NULL, &tok, count);
+}
+
+char** guiarstr_split_lines(const char* str, size_t* count) {
+    return guiarstr_split_lines_impl(NULL, str, count);
+}
+
+char** guiarstr_split_arena(GuiarStrArena* arena, const char* str, char delimiter, size_t* count) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    
+    return guiarstr_split_impl(&arena->allocator, str, delimiter, count);
+}
+
+char** guiarstr_split_str_arena(GuiarStrArena* arena, const char* str, const char* delimiter, size_t* count) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    
+    return guiarstr_split_str_impl(&arena->allocator, str, delimiter, count);
+}
+
+char** guiarstr_split_any_arena(GuiarStrArena* arena, const char* str, const char* delimiters, size_t* count) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    
+    return guiarstr_split_any_impl(&arena->allocator, str, delimiters, count);
+}
+
+char** guiarstr_split_lines_arena(GuiarStrArena* arena, const char* str, size_t* count) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    
+    return guiarstr_split_lines_impl(&arena->allocator, str, count);
+}
+
+void guiarstr_split_free(char** tokens, size_t count) {
+    if (!tokens) return;
+    
+    for (size_t i = 0; i < count; ++i) guiarstr_mem_free(NULL, tokens[i]);
+    guiarstr_mem_free(NULL, tokens);
+}
+
+char* guiarstr_join(char** strings, size_t count, const char* separator) {
+    if (!strings || !separator) return NULL;
+    
+    size_t sep_len = strlen(separator);
+    size_t total_length = 0;
+    
+    for (size_t i = 0; i < count; ++i) {
+        if (strings[i]) {
+            total_length += strlen(strings[i]);
+            if (i < count - 1) total_length += sep_len;
+        }
+    }
+    
+    char* result = guiarstr_mem_alloc(NULL, total_length + 1);
+    if (!result) return NULL;
+    
+    result[0] = '\0';
+    
+    for (size_t i = 0; i < count; ++i) {
+        if (strings[i]) {
+            strcat(result, strings[i]);
+            if (i < count - 1) strcat(result, separator);
+        }
+    }
+    
+    return result;
+}
+
+char* guiarstr_join_views(const GuiarStrView* views, size_t count, const char* separator) {
+    if (!views || !separator) return NULL;
+    
+    size_t sep_len = strlen(separator);
+    size_t total_length = 0;
+    
+    for (size_t i = 0; i < count; ++i) {
+        total_length += views[i].length;
+        if (i < count - 1) total_length += sep_len;
+    }
+    
+    char* result = guiarstr_mem_alloc(NULL, total_length + 1);
+    if (!result) return NULL;
+    
+    char* ptr = result;
+    
+    for (size_t i = 0; i < count; ++i) {
+        memcpy(ptr, views[i].data, views[i].length);
+        ptr += views[i].length;
+        
+        if (i < count - 1) {
+            memcpy(ptr, separator, sep_len);
+            ptr += sep_len;
+        }
+    }
+    
+    *ptr = '\0';
+    return result;
+}
+
+// Streaming tokenizer
+static void guiarstr_tokenizer_setup(GuiarStrTokenizer* tok, const char* str, size_t len,
+                                     GuiarStrTokenizeMode mode) {
+    tok->data = str;
+    tok->length = len;
+    tok->pos = 0;
+    tok->mode = mode;
+    tok->delimiter = NULL;
+    tok->delimiter_length = 0;
+    tok->delimiter_char = '\0';
+    tok->pattern = NULL;
+    tok->done = false;
+}
+
+GuiarStrError guiarstr_tokenizer_init(GuiarStrTokenizer* tok, const char* str, size_t len, char delimiter) {
+    GUIARSTR_CHECK_NULL(tok);
+    GUIARSTR_CHECK_NULL(str);
+    
+    guiarstr_tokenizer_setup(tok, str, len, GUIARSTR_TOKENIZE_CHAR);
+    tok->delimiter_char = delimiter;
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_tokenizer_init_str(GuiarStrTokenizer* tok, const char* str, size_t len, const char* delimiter) {
+    GUIARSTR_CHECK_NULL(tok);
+    GUIARSTR_CHECK_NULL(str);
+    GUIARSTR_CHECK_NULL(delimiter);
+    
+    guiarstr_tokenizer_setup(tok, str, len, GUIARSTR_TOKENIZE_STR);
+    tok->delimiter = delimiter;
+    tok->delimiter_length = strlen(delimiter);
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_tokenizer_init_any(GuiarStrTokenizer* tok, const char* str, size_t len, const char* delimiters) {
+    GUIARSTR_CHECK_NULL(tok);
+    GUIARSTR_CHECK_NULL(str);
+    GUIARSTR_CHECK_NULL(delimiters);
+    
+    guiarstr_tokenizer_setup(tok, str, len, GUIARSTR_TOKENIZE_ANY);
+    tok->delimiter = delimiters;
+    tok->delimiter_length = strlen(delimiters);
+    return guiarstr_charset_init_len(&tok->delimiter_set, delimiters, tok->delimiter_length);
+}
+
+GuiarStrError guiarstr_tokenizer_init_set(GuiarStrTokenizer* tok, const char* str, size_t len, const GuiarStrCharSet* delimiters) {
+    GUIARSTR_CHECK_NULL(tok);
+    GUIARSTR_CHECK_NULL(str);
+    GUIARSTR_CHECK_NULL(delimiters);
+    
+    guiarstr_tokenizer_setup(tok, str, len, GUIARSTR_TOKENIZE_ANY);
+    tok->delimiter_set = *delimiters;
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_tokenizer_init_lines(GuiarStrTokenizer* tok, const char* str, size_t len) {
+    GUIARSTR_CHECK_NULL(tok);
+    GUIARSTR_CHECK_NULL(str);
+    
+    guiarstr_tokenizer_setup(tok, str, len, GUIARSTR_TOKENIZE_LINES);
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_tokenizer_init_pattern(GuiarStrTokenizer* tok, const char* str, size_t len, const GuiarStrPattern* delimiter) {
+    GUIARSTR_CHECK_NULL(tok);
+    GUIARSTR_CHECK_NULL(str);
+    GUIARSTR_CHECK_NULL(delimiter);
+    
+    guiarstr_tokenizer_setup(tok, str, len, GUIARSTR_TOKENIZE_PATTERN);
+    tok->pattern = delimiter;
+    tok->delimiter = delimiter->needle;
+    tok->delimiter_length = delimiter->length;
+    return GUIARSTR_OK;
+}
+
+bool guiarstr_tokenizer_next(GuiarStrTokenizer* tok, GuiarStrView* token) {
+    if (!tok || !token || tok->done) return false;
+    
+    const char* start = tok->data + tok->pos;
+    size_t remaining = tok->length - tok->pos;
+    const char* found = NULL;
+    size_t skip = 1;
+    
+    switch (tok->mode) {
+        case GUIARSTR_TOKENIZE_CHAR:
+            found = memchr(start, tok->delimiter_char, remaining);
+            break;
+        
+        case GUIARSTR_TOKENIZE_STR:
+        case GUIARSTR_TOKENIZE_PATTERN:
+            if (tok->delimiter_length == 0) {
+                // Empty delimiter, each character is a token
+                if (remaining == 0) {
+                    tok->done = true;
+                    return false;
+                }
+                token->data = start;
+                token->length = 1;
+                tok->pos++;
+                return true;
+            }
+            found = tok->pattern ? guiarstr_pattern_search(tok->pattern, start, remaining)
+                                 : guiarstr_memmem(start, remaining, tok->delimiter, tok->delimiter_length);
+            skip = tok->delimiter_length;
+            break;
+        
+        case GUIARSTR_TOKENIZE_ANY: {
+            size_t i = guiarstr_charset_scan(&tok->delimiter_set, start, remaining, true);
+            found = i < remaining ? start + i : NULL;
+            break;
+        }
+        
+        case GUIARSTR_TOKENIZE_LINES:
+            for (size_t i = 0; i < remaining; i++) {
+                if (start[i] == '\n' || start[i] == '\r') {
+                    found = start + i;
+                    // Handle CRLF
+                    if (start[i] == '\r' && i + 1 < remaining && start[i + 1] == '\n') {
+                        skip = 2;
+                    }
+                    break;
+                }
+            }
+            break;
+    }
+    
+    token->data = start;
+    if (found) {
+        token->length = found - start;
+        tok->pos += token->length + skip;
+    } else {
+        token->length = remaining;
+        tok->pos = tok->length;
+        tok->done = true;
+    }
+    
+    return true;
+}
+
+void guiarstr_tokenizer_reset(GuiarStrTokenizer* tok) {
+    if (!tok) return;
+    
+    tok->pos = 0;
+    tok->done = false;
+}
+
+// Zero-copy split
+static size_t guiarstr_collect_tokens(GuiarStrTokenizer* tok, GuiarStrView* views, size_t max_views) {
+    size_t size = 0;
+    GuiarStrView token;
+    
+    while (guiarstr_tokenizer_next(tok, &token)) {
+        if (views && size < max_views) {
+            views[size] = token;
+        }
+        size++;
+    }
+    
+    return size;
+}
+
+size_t guiarstr_split_view(const char* str, char delimiter, GuiarStrView* views, size_t max_views) {
+    if (!str) return 0;
+    
+    GuiarStrTokenizer tok;
+    guiarstr_tokenizer_init(&tok, str, strlen(str), delimiter);
+    return guiarstr_collect_tokens(&tok, views, max_views);
+}
+
+size_t guiarstr_split_str_view(const char* str, const char* delimiter, GuiarStrView* views, size_t max_views) {
+    if (!str || !delimiter) return 0;
+    
+    GuiarStrTokenizer tok;
+    guiarstr_tokenizer_init_str(&tok, str, strlen(str), delimiter);
+    return guiarstr_collect_tokens(&tok, views, max_views);
+}
+
+size_t guiarstr_split_any_view(const char* str, const char* delimiters, GuiarStrView* views, size_t max_views) {
+    if (!str || !delimiters) return 0;
+    
+    GuiarStrTokenizer tok;
+    guiarstr_tokenizer_init_any(&tok, str, strlen(str), delimiters);
+    return guiarstr_collect_tokens(&tok, views, max_views);
+}
+
+size_t guiarstr_split_lines_view(const char* str, GuiarStrView* views, size_t max_views) {
+    if (!str) return 0;
+    
+    GuiarStrTokenizer tok;
+    guiarstr_tokenizer_init_lines(&tok, str, strlen(str));
+    return guiarstr_collect_tokens(&tok, views, max_views);
+}
+
+// Counts the tokens first so the whole result needs exactly one allocation
+static GuiarStrView* guiarstr_alloc_views(size_t needed, size_t* count) {
+    GuiarStrView* views = guiarstr_mem_alloc(NULL, (needed ? needed : 1) * sizeof(GuiarStrView));
+    if (!views) {
+        *count = 0;
+        return NULL;
+    }
+    
+    *count = needed;
+    return views;
+}
+
+GuiarStrView* guiarstr_split_view_alloc(const char* str, char delimiter, size_t* count) {
+    if (!str || !count) return NULL;
+    
+    GuiarStrView* views = guiarstr_alloc_views(guiarstr_split_view(str, delimiter, NULL, 0), count);
+    if (views) guiarstr_split_view(str, delimiter, views, *count);
+    return views;
+}
+
+GuiarStrView* guiarstr_split_str_view_alloc(const char* str, const char* delimiter, size_t* count) {
+    if (!str || !delimiter || !count) return NULL;
+    
+    GuiarStrView* views = guiarstr_alloc_views(guiarstr_split_str_view(str, delimiter, NULL, 0), count);
+    if (views) guiarstr_split_str_view(str, delimiter, views, *count);
+    return views;
+}
+
+GuiarStrView* guiarstr_split_any_view_alloc(const char* str, const char* delimiters, size_t* count) {
+    if (!str || !delimiters || !count) return NULL;
+    
+    GuiarStrView* views = guiarstr_alloc_views(guiarstr_split_any_view(str, delimiters, NULL, 0), count);
+    if (views) guiarstr_split_any_view(str, delimiters, views, *count);
+    return views;
+}
+
+GuiarStrView* guiarstr_split_lines_view_alloc(const char* str, size_t* count) {
+    if (!str || !count) return NULL;
+    
+    GuiarStrView* views = guiarstr_alloc_views(guiarstr_split_lines_view(str, NULL, 0), count);
+    if (views) guiarstr_split_lines_view(str, views, *count);
+    return views;
+}
+
+void guiarstr_split_view_free(GuiarStrView* views) {
+    guiarstr_mem_free(NULL, views);
+}
+
+// String views
+GuiarStrView guiarstr_view_from(const char* data, size_t length) {
+    GuiarStrView view;
+    view.data = data;
+    view.length = data ? length : 0;
+    return view;
+}
+
+GuiarStrView guiarstr_view_from_cstr(const char* str) {
+    return guiarstr_view_from(str, str ? strlen(str) : 0);
+}
+
+GuiarStrView guiarstr_view_from_str(const GuiarStr* str) {
+    return str ? guiarstr_view_from(str->data, str->length) : guiarstr_view_from(NULL, 0);
+}
+
+GuiarStrView guiarstr_view_slice(GuiarStrView view, size_t pos, size_t len) {
+    if (pos > view.length) {
+        pos = view.length;
+    }
+    if (len > view.length - pos) {
+        len = view.length - pos;
+    }
+    
+    return guiarstr_view_from(view.data ? view.data + pos : NULL, len);
+}
+
+GuiarStrView guiarstr_view_trim_left(GuiarStrView view) {
+    size_t start = 0;
+    while (start < view.length && guiarstr_ascii_isspace((unsigned char)view.data[start])) {
+        start++;
+    }
+    
+    return guiarstr_view_slice(view, start, view.length - start);
+}
+
+GuiarStrView guiarstr_view_trim_right(GuiarStrView view) {
+    size_t end = view.length;
+    while (end > 0 && guiarstr_ascii_isspace((unsigned char)view.data[end - 1])) {
+        end--;
+    }
+    
+    return guiarstr_view_slice(view, 0, end);
+}
+
+GuiarStrView guiarstr_view_trim(GuiarStrView view) {
+    return guiarstr_view_trim_right(guiarstr_view_trim_left(view));
+}
+
+GuiarStrView guiarstr_view_strip(GuiarStrView view, GuiarStrView chars) {
+    GuiarStrCharSet set;
+    guiarstr_charset_init_len(&set, chars.data, chars.length);
+    return guiarstr_view_strip_set(view, &set);
+}
+
+GuiarStrView guiarstr_view_strip_set(GuiarStrView view, const GuiarStrCharSet* set) {
+    if (!set) return view;
+    
+    size_t start = guiarstr_charset_scan(set, view.data, view.length, false);
+    size_t end = start + guiarstr_charset_rscan(set, view.data + start, view.length - start, false);
+    
+    return guiarstr_view_slice(view, start, end - start);
+}
+
+bool guiarstr_view_equals(GuiarStrView a, GuiarStrView b) {
+    return a.length == b.length && (a.length == 0 || memcmp(a.data, b.data, a.length) == 0);
+}
+
+int guiarstr_view_compare(GuiarStrView a, GuiarStrView b) {
+    size_t len = a.length < b.length ? a.length : b.length;
+    int result = len ? memcmp(a.data, b.data, len) : 0;
+    
+    if (result != 0) {
+        return result < 0 ? -1 : 1;
+    }
+    if (a.length != b.length) {
+        return a.length < b.length ? -1 : 1;
+    }
+    return 0;
+}
+
+bool guiarstr_view_startswith(GuiarStrView view, GuiarStrView prefix) {
+    return prefix.length <= view.length &&
+           (prefix.length == 0 || memcmp(view.data, prefix.data, prefix.length) == 0);
+}
+
+bool guiarstr_view_endswith(GuiarStrView view, GuiarStrView suffix) {
+    return suffix.length <= view.length &&
+           (suffix.length == 0 || memcmp(view.data + view.length - suffix.length, suffix.data, suffix.length) == 0);
+}
+
+bool guiarstr_view_equalsi(GuiarStrView a, GuiarStrView b) {
+    return a.length == b.length && guiarstr_ascii_equalsi(a.data, b.data, a.length);
+}
+
+bool guiarstr_view_startswithi(GuiarStrView view, GuiarStrView prefix) {
+    return prefix.length <= view.length && guiarstr_ascii_equalsi(view.data, prefix.data, prefix.length);
+}
+
+bool guiarstr_view_endswithi(GuiarStrView view, GuiarStrView suffix) {
+    return suffix.length <= view.length &&
+           guiarstr_ascii_equalsi(view.data + view.length - suffix.length, suffix.data, suffix.length);
+}
+
+size_t guiarstr_view_find_from(GuiarStrView view, GuiarStrView needle, size_t from_pos) {
+    if (from_pos > view.length) return (size_t)-1;
+    if (needle.length == 0) return from_pos;
+    
+    const char* found = guiarstr_memmem(view.data + from_pos, view.length - from_pos, needle.data, needle.length);
+    return found ? (size_t)(found - view.data) : (size_t)-1;
+}
+
+size_t guiarstr_view_find(GuiarStrView view, GuiarStrView needle) {
+    return guiarstr_view_find_from(view, needle, 0);
+}
+
+size_t guiarstr_view_rfind(GuiarStrView view, GuiarStrView needle) {
+    return guiarstr_view_rfind_from(view, needle, (size_t)-1);
+}
+
+size_t guiarstr_view_rfind_from(GuiarStrView view, GuiarStrView needle, size_t from_pos) {
+    if (needle.length > view.length) return (size_t)-1;
+    
+    size_t last = view.length - needle.length;
+    if (from_pos < last) last = from_pos;
+    if (needle.length == 0) return last;
+    
+    const char* found = guiarstr_memrmem(view.data, last + needle.length, needle.data, needle.length);
+    return found ? (size_t)(found - view.data) : (size_t)-1;
+}
+
+bool guiarstr_view_contains(GuiarStrView view, GuiarStrView needle) {
+    return guiarstr_view_find(view, needle) != (size_t)-1;
+}
+
+size_t guiarstr_view_count(GuiarStrView view, GuiarStrView needle) {
+    GuiarStrPattern pattern;
+    guiarstr_pattern_setup(&pattern, needle.data, needle.length, 0);
+    return guiarstr_pattern_count(&pattern, view);
+}
+
+size_t guiarstr_view_find_char(GuiarStrView view, char c) {
+    const char* found = view.length ? memchr(view.data, c, view.length) : NULL;
+    return found ? (size_t)(found - view.data) : (size_t)-1;
+}
+
+size_t guiarstr_view_rfind_char(GuiarStrView view, char c) {
+    const char* found = guiarstr_memrchr(view.data, (unsigned char)c, view.length);
+    return found ? (size_t)(found - view.data) : (size_t)-1;
+}
+
+size_t guiarstr_view_find_any(GuiarStrView view, GuiarStrView chars) {
+    GuiarStrCharSet set;
+    guiarstr_charset_init_len(&set, chars.data, chars.length);
+    return guiarstr_view_find_any_set(view, &set);
+}
+
+size_t guiarstr_view_rfind_any(GuiarStrView view, GuiarStrView chars) {
+    GuiarStrCharSet set;
+    guiarstr_charset_init_len(&set, chars.data, chars.length);
+    return guiarstr_view_rfind_any_set(view, &set);
+}
+
+size_t guiarstr_view_find_not_any(GuiarStrView view, GuiarStrView chars) {
+    GuiarStrCharSet set;
+    guiarstr_charset_init_len(&set, chars.data, chars.length);
+    return guiarstr_view_find_not_any_set(view, &set);
+}
+
+size_t guiarstr_view_find_any_set(GuiarStrView view, const GuiarStrCharSet* set) {
+    if (!set) return (size_t)-1;
+    
+    size_t pos = guiarstr_charset_scan(set, view.data, view.length, true);
+    return pos < view.length ? pos : (size_t)-1;
+}
+
+size_t guiarstr_view_find_not_any_set(GuiarStrView view, const GuiarStrCharSet* set) {
+    if (!set) return (size_t)-1;
+    
+    size_t pos = guiarstr_charset_scan(set, view.data, view.length, false);
+    return pos < view.length ? pos : (size_t)-1;
+}
+
+size_t guiarstr_view_rfind_any_set(GuiarStrView view, const GuiarStrCharSet* set) {
+    if (!set) return (size_t)-1;
+    
+    size_t end = guiarstr_charset_rscan(set, view.data, view.length, true);
+    return end ? end - 1 : (size_t)-1;
+}
+
+static size_t guiarstr_view_split_mode(GuiarStrView view, GuiarStrTokenizeMode mode, GuiarStrView delimiter,
+                                       char delimiter_char, GuiarStrView* views, size_t max_views) {
+    if (!view.data) return 0;
+    
+    GuiarStrTokenizer tok;
+    guiarstr_tokenizer_setup(&tok, view.data, view.length, mode);
+    tok.delimiter = delimiter.data;
+    tok.delimiter_length = delimiter.length;
+    tok.delimiter_char = delimiter_char;
+    if (mode == GUIARSTR_TOKENIZE_ANY) {
+        guiarstr_charset_init_len(&tok.delimiter_set, delimiter.data, delimiter.length);
+    }
+    
+    return guiarstr_collect_tokens(&tok, views, max_views);
+}
+
+size_t guiarstr_view_split(GuiarStrView view, char delimiter, GuiarStrView* views, size_t max_views) {
+    return guiarstr_view_split_mode(view, GUIARSTR_TOKENIZE_CHAR, guiarstr_view_from(NULL, 0), delimiter, views, max_views);
+}
+
+size_t guiarstr_view_split_str(GuiarStrView view, GuiarStrView delimiter, GuiarStrView* views, size_t max_views) {
+    return guiarstr_view_split_mode(view, GUIARSTR_TOKENIZE_STR, delimiter, '\0', views, max_views);
+}
+
+size_t guiarstr_view_split_any(GuiarStrView view, GuiarStrView delimiters, GuiarStrView* views, size_t max_views) {
+    return guiarstr_view_split_mode(view, GUIARSTR_TOKENIZE_ANY, delimiters, '\0', views, max_views);
+}
+
+size_t guiarstr_view_split_any_set(GuiarStrView view, const GuiarStrCharSet* set, GuiarStrView* views, size_t max_views) {
+    if (!view.data || !set) return 0;
+    
+    GuiarStrTokenizer tok;
+    guiarstr_tokenizer_init_set(&tok, view.data, view.length, set);
+    return guiarstr_collect_tokens(&tok, views, max_views);
+}
+
+size_t guiarstr_view_split_lines(GuiarStrView view, GuiarStrView* views, size_t max_views) {
+    return guiarstr_view_split_mode(view, GUIARSTR_TOKENIZE_LINES, guiarstr_view_from(NULL, 0), '\0', views, max_views);
+}
+
+size_t guiarstr_view_utf8_len(GuiarStrView view) {
+    return guiarstr_utf8_count_chars(view.data, view.length);
+}
+
+size_t guiarstr_view_utf8_char_len(GuiarStrView view, size_t byte_pos) {
+    if (byte_pos >= view.length) return 0;
+    
+    size_t len = guiarstr_utf8_lead_len((unsigned char)view.data[byte_pos]);
+    return len <= view.length - byte_pos ? len : view.length - byte_pos;
+}
+
+size_t guiarstr_view_utf8_byte_pos(GuiarStrView view, size_t char_pos) {
+    size_t current_char = 0;
+    
+    for (size_t i = 0; i < view.length; i++) {
+        if (((unsigned char)view.data[i] & 0xC0) != 0x80) {
+            if (current_char == char_pos) {
+                return i;
+            }
+            current_char++;
+        }
+    }
+    
+    return view.length;
+}
+
+bool guiarstr_view_utf8_validate(GuiarStrView view) {
+    return guiarstr_view_utf8_error_offset(view) == (size_t)-1;
+}
+
+size_t guiarstr_view_utf8_error_offset(GuiarStrView view) {
+    return guiarstr_utf8_error_offset(view.data, view.length);
+}
+
+GuiarStrView guiarstr_view_utf8_substring(GuiarStrView view, size_t char_pos, size_t char_len) {
+    size_t start = guiarstr_view_utf8_byte_pos(view, char_pos);
+    GuiarStrView rest = guiarstr_view_slice(view, start, view.length - start);
+    size_t end = guiarstr_view_utf8_byte_pos(rest, char_len);
+    
+    return guiarstr_view_slice(rest, 0, end);
+}
+
+// FNV-1a: cheap, byte-at-a-time and stable across platforms
+uint64_t guiarstr_view_hash(GuiarStrView view) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    
+    for (size_t i = 0; i < view.length; i++) {
+        hash ^= (unsigned char)view.data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    
+    return hash;
+}
+
+// Search patterns
+GuiarStrPattern* guiarstr_pattern_create(const char* needle, unsigned int options) {
+    if (!needle) return NULL;
+    
+    return guiarstr_pattern_create_len(needle, strlen(needle), options);
+}
+
+GuiarStrPattern* guiarstr_pattern_create_len(const char* needle, size_t len, unsigned int options) {
+    if ((!needle && len > 0) || len == (size_t)-1) return NULL;
+    
+    const GuiarStrAllocator* allocator = guiarstr_resolve_allocator(NULL);
+    GuiarStrPattern* pattern = guiarstr_mem_alloc(allocator, sizeof(GuiarStrPattern));
+    if (!pattern) return NULL;
+    
+    char* copy = guiarstr_mem_alloc(allocator, len + 1);
+    if (!copy) {
+        guiarstr_mem_free(allocator, pattern);
+        return NULL;
+    }
+    
+    bool fold = (options & GUIARSTR_PATTERN_IGNORE_CASE) != 0;
+    for (size_t i = 0; i < len; i++) {
+        copy[i] = fold ? (char)guiarstr_fold_byte((unsigned char)needle[i]) : needle[i];
+    }
+    copy[len] = '\0';
+    
+    guiarstr_pattern_setup(pattern, copy, len, options);
+    pattern->allocator = allocator;
+    return pattern;
+}
+
+void guiarstr_pattern_free(GuiarStrPattern* pattern) {
+    if (!pattern) return;
+    
+    guiarstr_mem_free(pattern->allocator, pattern->needle);
+    guiarstr_mem_free(pattern->allocator, pattern);
+}
+
+size_t guiarstr_pattern_find_from(const GuiarStrPattern* pattern, GuiarStrView haystack, size_t from_pos) {
+    if (!pattern || from_pos > haystack.length) return (size_t)-1;
+    
+    const char* found = guiarstr_pattern_search(pattern, haystack.data + from_pos, haystack.length - from_pos);
+    return found ? (size_t)(found - haystack.data) : (size_t)-1;
+}
+
+size_t guiarstr_pattern_find(const GuiarStrPattern* pattern, GuiarStrView haystack) {
+    return guiarstr_pattern_find_from(pattern, haystack, 0);
+}
+
+size_t guiarstr_pattern_rfind(const GuiarStrPattern* pattern, GuiarStrView haystack) {
+    if (!pattern) return (size_t)-1;
+    
+    const char* found = guiarstr_pattern_rsearch(pattern, haystack.data, haystack.length);
+    return found ? (size_t)(found - haystack.data) : (size_t)-1;
+}
+
+size_t guiarstr_pattern_find_all(const GuiarStrPattern* pattern, GuiarStrView haystack, size_t* positions, size_t max_positions) {
+    if (!pattern || pattern->length == 0) return 0;
+    
+    GuiarStrMatches matches;
+    guiarstr_matches_init(&matches, positions, max_positions, (size_t)-1);
+    guiarstr_pattern_scan(pattern, haystack.data, 0, haystack.length, &matches);
+    return matches.count;
+}
+
+size_t guiarstr_pattern_count(const GuiarStrPattern* pattern, GuiarStrView haystack) {
+    return guiarstr_pattern_find_all(pattern, haystack, NULL, 0);
+}
+
+// Case-insensitive search
+// The needle is lowercased once, into a stack buffer when it fits; the haystack is folded on the
+// fly by the filter kernels and the verification compare, so it is never copied.
+#define GUIARSTR_FOLD_BUFFER 128
+
+static bool guiarstr_pattern_setup_folded(GuiarStrPattern* pattern, const char* needle, size_t len, char* buffer) {
+    char* folded = len <= GUIARSTR_FOLD_BUFFER ? buffer : guiarstr_mem_alloc(NULL, len);
+    if (!folded) return false;
+    
+    guiarstr_ascii_case(folded, needle, len, false);
+    guiarstr_pattern_setup(pattern, folded, len, GUIARSTR_PATTERN_IGNORE_CASE);
+    return true;
+}
+
+static void guiarstr_pattern_release_folded(GuiarStrPattern* pattern, const char* buffer) {
+    if (pattern->needle != buffer) {
+        guiarstr_mem_free(NULL, pattern->needle);
+    }
+}
+
+size_t guiarstr_find_i(const char* str, const char* substr) {
+    return guiarstr_find_from_i(str, substr, 0);
+}
+
+size_t guiarstr_find_from_i(const char* str, const char* substr, size_t from_pos) {
+    if (!str || !substr) return (size_t)-1;
+    
+    if (guiarstr_nul_offset(str, from_pos) < from_pos) return (size_t)-1;
+    
+    char buffer[GUIARSTR_FOLD_BUFFER];
+    GuiarStrPattern pattern;
+    if (!guiarstr_pattern_setup_folded(&pattern, substr, strlen(substr), buffer)) return (size_t)-1;
+    
+    const char* found = guiarstr_cstr_search(str + from_pos, &pattern);
+    guiarstr_pattern_release_folded(&pattern, buffer);
+    return found ? (size_t)(found - str) : (size_t)-1;
+}
+
+size_t guiarstr_rfind_i(const char* str, const char* substr) {
+    if (!str || !substr) return (size_t)-1;
+    
+    return guiarstr_view_rfind_i(guiarstr_view_from_cstr(str), guiarstr_view_from_cstr(substr));
+}
+
+bool guiarstr_contains_i(const char* str, const char* substr) {
+    return guiarstr_find_i(str, substr) != (size_t)-1;
+}
+
+size_t guiarstr_count_i(const char* str, const char* substr) {
+    if (!str || !substr || !*substr) return 0;
+    
+    char buffer[GUIARSTR_FOLD_BUFFER];
+    GuiarStrPattern pattern;
+    if (!guiarstr_pattern_setup_folded(&pattern, substr, strlen(substr), buffer)) return 0;
+
+    size_t count = guiarstr_cstr_count(str, &pattern);
+    guiarstr_pattern_release_folded(&pattern, buffer);
+    return count;
+}
+
+char* guiarstr_replace_i(const char* str, const char* from, const char* to) {
+    return guiarstr_replace_n_i(str, from, to, (size_t)-1);
+}
+
+char* guiarstr_replace_n_i(const char* str, const char* from, const char* to, size_t max_replacements) {
+    if (!str || !from || !to || !*from) return NULL;
+    
+    char buffer[GUIARSTR_FOLD_BUFFER];
+    GuiarStrPattern pattern;
+    if (!guiarstr_pattern_setup_folded(&pattern, from, strlen(from), buffer)) return NULL;
+    
+    char* result = guiarstr_replace_pattern_impl(NULL, str, &pattern, to, max_replacements);
+    guiarstr_pattern_release_folded(&pattern, buffer);
+    return result;
+}
+
+size_t guiarstr_view_find_i(GuiarStrView view, GuiarStrView needle) {
+    char buffer[GUIARSTR_FOLD_BUFFER];
+    GuiarStrPattern pattern;
+    if (!guiarstr_pattern_setup_folded(&pattern, needle.data, needle.length, buffer)) return (size_t)-1;
+    
+    size_t pos = guiarstr_pattern_find(&pattern, view);
+    guiarstr_pattern_release_folded(&pattern, buffer);
+    return pos;
+}
+
+size_t guiarstr_view_rfind_i(GuiarStrView view, GuiarStrView needle) {
+    char buffer[GUIARSTR_FOLD_BUFFER];
+    GuiarStrPattern pattern;
+    if (!guiarstr_pattern_setup_folded(&pattern, needle.data, needle.length, buffer)) return (size_t)-1;
+    
+    size_t pos = guiarstr_pattern_rfind(&pattern, view);
+    guiarstr_pattern_release_folded(&pattern, buffer);
+    return pos;
+}
+
+bool guiarstr_view_contains_i(GuiarStrView view, GuiarStrView needle) {
+    return guiarstr_view_find_i(view, needle) != (size_t)-1;
+}
+
+size_t guiarstr_view_count_i(GuiarStrView view, GuiarStrView needle) {
+    char buffer[GUIARSTR_FOLD_BUFFER];
+    GuiarStrPattern pattern;
+    if (!guiarstr_pattern_setup_folded(&pattern, needle.data, needle.length, buffer)) return 0;
+    
+    size_t count = guiarstr_pattern_count(&pattern, view);
+    guiarstr_pattern_release_folded(&pattern, buffer);
+    return count;
+}
+
+// Multi-pattern matching
+// Aho-Corasick with failure links folded into a complete DFA: every state has a row with one
+// entry per byte class, so a scan costs one table load per byte. Bytes that appear in no pattern
+// share class 0, which keeps rows short for typical keyword sets. Entries leading to a state with
+// an output carry GUIARSTR_MATCHER_HIT so the scan loops test the entry they already loaded.
+
+#define GUIARSTR_MATCHER_HIT 0x80000000u
+#define GUIARSTR_MATCHER_NONE 0xFFFFFFFFu
+
+typedef struct {
+    uint32_t fail;
+    uint32_t output;  // nearest state on the fail chain (self included) ending a pattern, 0 if none
+    uint32_t pattern; // lowest pattern index ending exactly here
+    uint32_t depth;
+} GuiarStrMatcherState;
+
+struct GuiarStrMatcher {
+    uint32_t* transitions; // state_count rows of class_count entries
+    GuiarStrMatcherState* states;
+    uint32_t* same_next;   // next pattern with identical bytes, per pattern
+    size_t* lengths;       // per pattern
+    size_t state_count;
+    size_t class_count;
+    size_t pattern_count;
+    uint16_t byte_class[256];
+    const GuiarStrAllocator* allocator;
+};
+
+static void guiarstr_matcher_release(GuiarStrMatcher* matcher) {
+    guiarstr_mem_free(matcher->allocator, matcher->transitions);
+    guiarstr_mem_free(matcher->allocator, matcher->states);
+    guiarstr_mem_free(matcher->allocator, matcher->same_next);
+    guiarstr_mem_free(matcher->allocator, matcher->lengths);
+    guiarstr_mem_free(matcher->allocator, matcher);
+}
+
+static uint16_t guiarstr_matcher_class(const GuiarStrMatcher* matcher, unsigned char c) {
+    return matcher->byte_class[c];
+}
+
+static void guiarstr_matcher_build_trie(GuiarStrMatcher* matcher, const GuiarStrView* patterns) {
+    size_t classes = matcher->class_count;
+    
+    matcher->state_count = 1;
+    matcher->states[0] = (GuiarStrMatcherState){0, 0, GUIARSTR_MATCHER_NONE, 0};
+    
+    for (size_t i = 0; i < matcher->pattern_count; i++) {
+        uint32_t state = 0;
+        
+        for (size_t j = 0; j < patterns[i].length; j++) {
+            uint32_t* entry = &matcher->transitions[state * classes +
+                                                    guiarstr_matcher_class(matcher, (unsigned char)patterns[i].data[j])];
+            if (*entry == 0) {
+                uint32_t next = (uint32_t)matcher->state_count++;
+                matcher->states[next] = (GuiarStrMatcherState){0, 0, GUIARSTR_MATCHER_NONE, (uint32_t)(j + 1)};
+                *entry = next;
+            }
+            state = *entry;
+        }
+        
+        // Identical patterns chain off the first one in index order
+        matcher->lengths[i] = patterns[i].length;
+        matcher->same_next[i] = GUIARSTR_MATCHER_NONE;
+        uint32_t* slot = &matcher->states[state].pattern;
+        while (*slot != GUIARSTR_MATCHER_NONE) {
+            slot = &matcher->same_next[*slot];
+        }
+        *slot = (uint32_t)i;
+    }
+}
+
+// Breadth-first, so a state's fail target already has a complete row when the state is reached
+static GuiarStrError guiarstr_matcher_build_links(GuiarStrMatcher* matcher) {
+    size_t classes = matcher->class_count;
+    uint32_t* table = matcher->transitions;
+    GuiarStrMatcherState* states = matcher->states;
+    
+    uint32_t* queue = guiarstr_mem_alloc(matcher->allocator, matcher->state_count * sizeof(uint32_t));
+    if (!queue) return GUIARSTR_ERR_MEMORY;
+    
+    size_t head = 0, tail = 0;
+    for (size_t c = 0; c < classes; c++) {
+        uint32_t child = table[c];
+        if (child) {
+            states[child].fail = 0;
+            queue[tail++] = child;
+        }
+    }
+    
+    while (head < tail) {
+        uint32_t state = queue[head++];
+        GuiarStrMatcherState* s = &states[state];
+        s->output = s->pattern != GUIARSTR_MATCHER_NONE ? state : states[s->fail].output;
+        
+        uint32_t* row = &table[(size_t)state * classes];
+        const uint32_t* fail_row = &table[(size_t)s->fail * classes];
+        for (size_t c = 0; c < classes; c++) {
+            if (row[c]) {
+                states[row[c]].fail = fail_row[c];
+                queue[tail++] = row[c];
+            } else {
+                row[c] = fail_row[c];
+            }
+        }
+    }
+    
+    guiarstr_mem_free(matcher->allocator, queue);
+    
+    size_t entries = matcher->state_count * classes;
+    for (size_t i = 0; i < entries; i++) {
+        if (states[table[i]].output) {
+            table[i] |= GUIARSTR_MATCHER_HIT;
+        }
+    }
+    
+    return GUIARSTR_OK;
+}
+
+GuiarStrMatcher* guiarstr_matcher_create(const GuiarStrView* patterns, size_t count, unsigned int options) {
+    if (!patterns && count > 0) return NULL;
+    
+    bool fold = (options & GUIARSTR_PATTERN_IGNORE_CASE) != 0;
+    bool seen[256] = {false};
+    size_t max_states = 1;
+    
+    for (size_t i = 0; i < count; i++) {
+        if (!patterns[i].data || patterns[i].length == 0) return NULL;
+        if (patterns[i].length > GUIARSTR_MATCHER_HIT - max_states) return NULL;
+        
+        max_states += patterns[i].length;
+        for (size_t j = 0; j < patterns[i].length; j++) {
+            unsigned char c = (unsigned char)patterns[i].data[j];
+            seen[fold ? guiarstr_fold_byte(c) : c] = true;
+        }
+    }
+    if (count >= GUIARSTR_MATCHER_NONE) return NULL;
+    
+    const GuiarStrAllocator* allocator = guiarstr_resolve_allocator(NULL);
+    GuiarStrMatcher* matcher = guiarstr_mem_alloc(allocator, sizeof(GuiarStrMatcher));
+    if (!matcher) return NULL;
+    
+    memset(matcher, 0, sizeof(GuiarStrMatcher));
+    matcher->allocator = allocator;
+    matcher->pattern_count = count;
+    
+    size_t classes = 1;
+    for (int c = 0; c < 256; c++) {
+        if (seen[c]) {
+            matcher->byte_class[c] = (uint16_t)classes++;
+        }
+    }
+    if (fold) {
+        for (int c = 'A'; c <= 'Z'; c++) {
+            matcher->byte_class[c] = matcher->byte_class[c - 'A' + 'a'];
+        }
+    }
+    matcher->class_count = classes;
+    
+    if (max_states > SIZE_MAX / sizeof(uint32_t) / classes) {
+        guiarstr_matcher_release(matcher);
+        return NULL;
+    }
+    
+    size_t table_size = max_states * classes * sizeof(uint32_t);
+    matcher->transitions = guiarstr_mem_alloc(allocator, table_size);
+    matcher->states = guiarstr_mem_alloc(allocator, max_states * sizeof(GuiarStrMatcherState));
+    matcher->same_next = guiarstr_mem_alloc(allocator, (count ? count : 1) * sizeof(uint32_t));
+    matcher->lengths = guiarstr_mem_alloc(allocator, (count ? count : 1) * sizeof(size_t));
+    if (!matcher->transitions || !matcher->states || !matcher->same_next || !matcher->lengths) {
+        guiarstr_matcher_release(matcher);
+        return NULL;
+    }
+    memset(matcher->transitions, 0, table_size);
+    
+    guiarstr_matcher_build_trie(matcher, patterns);
+    if (guiarstr_matcher_build_links(matcher) != GUIARSTR_OK) {
+        guiarstr_matcher_release(matcher);
+        return NULL;
+    }
+    
+    // Shared prefixes usually leave the worst-case tables mostly unused
+    if (matcher->state_count < max_states) {
+        size_t used = matcher->state_count * classes * sizeof(uint32_t);
+        uint32_t* table = guiarstr_mem_realloc(allocator, matcher->transitions, table_size, used);
+        if (table) matcher->transitions = table;
+        
+        GuiarStrMatcherState* states = guiarstr_mem_realloc(allocator, matcher->states,
+                                                            max_states * sizeof(GuiarStrMatcherState),
+                                                            matcher->state_count * sizeof(GuiarStrMatcherState));
+        if (states) matcher->states = states;
+    }
+    
+    return matcher;
+}
+
+GuiarStrMatcher* guiarstr_matcher_create_cstr(const char* const* patterns, size_t count, unsigned int options) {
+    if (!patterns && count > 0) return NULL;
+    if (count > SIZE_MAX / sizeof(GuiarStrView)) return NULL;
+    
+    GuiarStrView* views = guiarstr_mem_alloc(NULL, (count ? count : 1) * sizeof(GuiarStrView));
+    if (!views) return NULL;
+    
+    GuiarStrMatcher* matcher = NULL;
+    bool valid = true;
+    for (size_t i = 0; i < count; i++) {
+        if (!patterns[i]) {
+            valid = false;
+            break;
+        }
+        views[i] = guiarstr_view_from_cstr(patterns[i]);
+    }
+    
+    if (valid) {
+        matcher = guiarstr_matcher_create(views, count, options);
+    }
+    
+    guiarstr_mem_free(NULL, views);
+    return matcher;
+}
+
+void guiarstr_matcher_free(GuiarStrMatcher* matcher) {
+    if (!matcher) return;
+    
+    guiarstr_matcher_release(matcher);
+}
+
+size_t guiarstr_matcher_pattern_count(const GuiarStrMatcher* matcher) {
+    return matcher ? matcher->pattern_count : 0;
+}
+
+bool guiarstr_matcher_contains(const GuiarStrMatcher* matcher, GuiarStrView text) {
+    if (!matcher) return false;
+    
+    const unsigned char* p = (const unsigned char*)text.data;
+    const uint32_t* table = matcher->transitions;
+    size_t classes = matcher->class_count;
+    uint32_t state = 0;
+    
+    for (size_t i = 0; i < text.length; i++) {
+        uint32_t next = table[state * classes + matcher->byte_class[p[i]]];
+        if (next & GUIARSTR_MATCHER_HIT) return true;
+        state = next;
+    }
+    
+    return false;
+}
+
+// Leftmost-longest: once a match is known the scan only continues while the automaton's current
+// suffix still starts at or before it, since no later match could start earlier
+bool guiarstr_matcher_find_from(const GuiarStrMatcher* matcher, GuiarStrView text, size_t from_pos, GuiarStrMatch* match) {
+    if (!matcher || !match || from_pos > text.length) return false;
+    
+    const unsigned char* p = (const unsigned char*)text.data;
+    const uint32_t* table = matcher->transitions;
+    const GuiarStrMatcherState* states = matcher->states;
+    size_t classes = matcher->class_count;
+    uint32_t state = 0;
+    bool found = false;
+    
+    for (size_t i = from_pos; i < text.length; i++) {
+        uint32_t next = table[state * classes + matcher->byte_class[p[i]]];
+        state = next & ~GUIARSTR_MATCHER_HIT;
+        
+        if (found && i + 1 - states[state].depth > match->offset) break;
+        
+        if (next & GUIARSTR_MATCHER_HIT) {
+            const GuiarStrMatcherState* out = &states[states[state].output];
+            size_t start = i + 1 - out->depth;
+            
+            if (!found || start < match->offset || (start == match->offset && out->depth > match->length)) {
+                match->pattern = out->pattern;
+                match->offset = start;
+                match->length = out->depth;
+                found = true;
+            }
+        }
+    }
+    
+    return found;
+}
+
+bool guiarstr_matcher_find(const GuiarStrMatcher* matcher, GuiarStrView text, GuiarStrMatch* match) {
+    return guiarstr_matcher_find_from(matcher, text, 0, match);
+}
+
+size_t guiarstr_matcher_find_all(const GuiarStrMatcher* matcher, GuiarStrView text, GuiarStrMatch* matches, size_t max_matches) {
+    if (!matcher) return 0;
+    
+    const unsigned char* p = (const unsigned char*)text.data;
+    const uint32_t* table = matcher->transitions;
+    const GuiarStrMatcherState* states = matcher->states;
+    size_t classes = matcher->class_count;
+    uint32_t state = 0;
+    size_t count = 0;
+    
+    for (size_t i = 0; i < text.length; i++) {
+        uint32_t next = table[state * classes + matcher->byte_class[p[i]]];
+        state = next & ~GUIARSTR_MATCHER_HIT;
+        if (!(next & GUIARSTR_MATCHER_HIT)) continue;
+        
+        for (uint32_t out = states[state].output; out; out = states[states[out].fail].output) {
+            for (uint32_t id = states[out].pattern; id != GUIARSTR_MATCHER_NONE; id = matcher->same_next[id]) {
+                if (matches && count < max_matches) {
+                    matches[count] = (GuiarStrMatch){id, i + 1 - states[out].depth, states[out].depth};
+                }
+                count++;
+            }
+        }
+    }
+    
+    return count;
+}
+
+// A pattern already marked had its whole output chain marked with it, so each walk stops at the
+// first known hit and the scan ends early once every pattern has been seen
+size_t guiarstr_matcher_hits(const GuiarStrMatcher* matcher, GuiarStrView text, unsigned char* bitmap) {
+    if (!matcher || !bitmap) return 0;
+    
+    memset(bitmap, 0, (matcher->pattern_count + 7) / 8);
+    
+    const unsigned char* p = (const unsigned char*)text.data;
+    const uint32_t* table = matcher->transitions;
+    const GuiarStrMatcherState* states = matcher->states;
+    size_t classes = matcher->class_count;
+    uint32_t state = 0;
+    size_t hits = 0;
+    
+    for (size_t i = 0; i < text.length && hits < matcher->pattern_count; i++) {
+        uint32_t next = table[state * classes + matcher->byte_class[p[i]]];
+        state = next & ~GUIARSTR_MATCHER_HIT;
+        if (!(next & GUIARSTR_MATCHER_HIT)) continue;
+        
+        for (uint32_t out = states[state].output; out; out = states[states[out].fail].output) {
+            uint32_t first = states[out].pattern;
+            if (bitmap[first / 8] & (1u << (first % 8))) break;
+            
+            for (uint32_t id = first; id != GUIARSTR_MATCHER_NONE; id = matcher->same_next[id]) {
+                bitmap[id / 8] |= (unsigned char)(1u << (id % 8));
+                hits++;
+            }
+        }
+    }
+    
+    return hits;
+}
+
+static bool guiarstr_matcher_grows(const GuiarStrMatcher* matcher, const GuiarStrView* replacements) {
+    for (size_t i = 0; i < matcher->pattern_count; i++) {
+        if (replacements[i].length > matcher->lengths[i]) return true;
+    }
+    
+    return false;
+}
+
+static GuiarStrError guiarstr_rewrite_reserve(const GuiarStrAllocator* allocator, char** data, size_t* capacity, size_t required) {
+    if (required <= *capacity) return GUIARSTR_OK;
+    
+    size_t new_capacity = *capacity;
+    while (new_capacity < required) {
+        new_capacity = new_capacity > SIZE_MAX / 2 ? required : new_capacity * 2;
+    }
+    
+    char* grown = guiarstr_mem_realloc(allocator, *data, *capacity, new_capacity);
+    if (!grown) return GUIARSTR_ERR_MEMORY;
+    
+    *data = grown;
+    *capacity = new_capacity;
+    return GUIARSTR_OK;
+}
+
+// Single scan: the text before each leftmost-longest match is copied, then that match's
+// replacement. In place (*out is text.data, no replacement longer than its pattern) the output
+// never overtakes the scan. Otherwise *out is allocated from an estimate and doubled as needed,
+// which keeps the work linear without a separate counting pass.
+static GuiarStrError guiarstr_matcher_rewrite(const GuiarStrMatcher* matcher, GuiarStrView text, const GuiarStrView* replacements,
+                                              const GuiarStrAllocator* allocator, bool in_place,
+                                              char** out, size_t* out_len, size_t* out_cap) {
+    char* dst = *out;
+    size_t capacity = *out_cap;
+    
+    if (!in_place) {
+        capacity = text.length < SIZE_MAX / 2 ? text.length + 1 : SIZE_MAX;
+        if (guiarstr_matcher_grows(matcher, replacements) && capacity < SIZE_MAX / 2 - 64) {
+            capacity += capacity / 8 + 64;
+        }
+        dst = guiarstr_mem_alloc(allocator, capacity);
+        if (!dst) return GUIARSTR_ERR_MEMORY;
+    }
+    
+    GuiarStrMatch match;
+    size_t len = 0;
+    size_t pos = 0;
+    bool found;
+    
+    do {
+        found = guiarstr_matcher_find_from(matcher, text, pos, &match);
+        size_t piece = (found ? match.offset : text.length) - pos;
+        const GuiarStrView* to = found ? &replacements[match.pattern] : NULL;
+        size_t to_len = to ? to->length : 0;
+        
+        if (!in_place) {
+            GuiarStrError err = GUIARSTR_ERR_OVERFLOW;
+            if (piece > SIZE_MAX - 1 - len || to_len > SIZE_MAX - 1 - len - piece ||
+                (err = guiarstr_rewrite_reserve(allocator, &dst, &capacity, len + piece + to_len + 1)) != GUIARSTR_OK) {
+                guiarstr_mem_free(allocator, dst);
+                return err;
+            }
+        }
+        
+        if (piece && dst + len != text.data + pos) {
+            memmove(dst + len, text.data + pos, piece);
+        }
+        len += piece;
+        if (to_len) {
+            memcpy(dst + len, to->data, to_len);
+            len += to_len;
+        }
+        
+        if (found) pos = match.offset + match.length;
+    } while (found);
+    
+    dst[len] = '\0';
+    *out = dst;
+    *out_len = len;
+    *out_cap = capacity;
+    return GUIARSTR_OK;
+}
+
+char* guiarstr_matcher_replace(const GuiarStrMatcher* matcher, GuiarStrView text, const GuiarStrView* replacements) {
+    if (!matcher || (!text.data && text.length > 0)) return NULL;
+    if (!replacements && matcher->pattern_count > 0) return NULL;
+    
+    char* result = NULL;
+    size_t result_len, capacity = 0;
+    if (guiarstr_matcher_rewrite(matcher, text, replacements, NULL, false, &result, &result_len, &capacity) != GUIARSTR_OK) {
+        return NULL;
+    }
+    
+    return result;
+}
+
+// True when any view points into the string's buffer, which must then survive until the copy is done
+static bool guiarstr_views_alias(const GuiarStr* str, const GuiarStrView* views, size_t count) {
+    uintptr_t begin = (uintptr_t)str->data;
+    uintptr_t end = begin + str->capacity;
+    
+    for (size_t i = 0; i < count; i++) {
+        uintptr_t p = (uintptr_t)views[i].data;
+        if (views[i].length && p < end && p + views[i].length > begin) return true;
+    }
+    
+    return false;
+}
+
+GuiarStrError guiarstr_matcher_replace_str(const GuiarStrMatcher* matcher, GuiarStr* str, const GuiarStrView* replacements) {
+    GUIARSTR_CHECK_NULL(matcher);
+    GUIARSTR_CHECK_NULL(str);
+    if (!replacements && matcher->pattern_count > 0) {
+        return GUIARSTR_ERR_NULL;
+    }
+    
+    char* result;
+    size_t result_len, capacity = str->capacity;
+    GuiarStrError err;
+    
+    // Shrinking replacements compact the string's own buffer
+    if (!guiarstr_matcher_grows(matcher, replacements) && !guiarstr_views_alias(str, replacements, matcher->pattern_count)) {
+        err = guiarstr_make_unique(str);
+        if (err != GUIARSTR_OK) {
+            return err;
+        }
+        
+        result = str->data;
+        guiarstr_matcher_rewrite(matcher, guiarstr_view_from_str(str), replacements, NULL, true, &result, &result_len, &capacity);
+        str->length = result_len;
+        return GUIARSTR_OK;
+    }
+    
+    result = NULL;
+    err = guiarstr_matcher_rewrite(matcher, guiarstr_view_from_str(str), replacements, str->allocator, false,
+                                   &result, &result_len, &capacity);
     if (err != GUIARSTR_OK) {
         return err;
     }
     
-    memcpy(str->data + str->length, append, len);
-    str->length += len;
+    guiarstr_release_data(str);
+    str->data = result;
+    str->length = result_len;
+    str->capacity = capacity;
+    str->flags &= ~(GUIARSTR_FLAG_INLINE | GUIARSTR_FLAG_BORROWED | GUIARSTR_FLAG_SHARED | GUIARSTR_FLAG_MAPPED);
+    
+    return GUIARSTR_OK;
+}
+
+// Leftmost-longest over all of from[] at once; from[i] is replaced by to[i], the lowest i winning
+// between identical entries
+char* guiarstr_replace_many(const char* str, const GuiarStrView* from, const GuiarStrView* to, size_t n) {
+    if (!str || (n > 0 && (!from || !to))) return NULL;
+    
+    GuiarStrMatcher* matcher = guiarstr_matcher_create(from, n, 0);
+    if (!matcher) return NULL;
+    
+    char* result = guiarstr_matcher_replace(matcher, guiarstr_view_from_cstr(str), to);
+    guiarstr_matcher_free(matcher);
+    return result;
+}
+
+// Binary-safe GuiarStr operations
+size_t guiarstr_str_find(const GuiarStr* str, GuiarStrView needle) {
+    return guiarstr_view_find(guiarstr_view_from_str(str), needle);
+}
+
+size_t guiarstr_str_find_from(const GuiarStr* str, GuiarStrView needle, size_t from_pos) {
+    return guiarstr_view_find_from(guiarstr_view_from_str(str), needle, from_pos);
+}
+
+size_t guiarstr_str_rfind(const GuiarStr* str, GuiarStrView needle) {
+    return guiarstr_view_rfind(guiarstr_view_from_str(str), needle);
+}
+
+size_t guiarstr_str_count(const GuiarStr* str, GuiarStrView needle) {
+    return guiarstr_view_count(guiarstr_view_from_str(str), needle);
+}
+
+size_t guiarstr_str_find_i(const GuiarStr* str, GuiarStrView needle) {
+    return guiarstr_view_find_i(guiarstr_view_from_str(str), needle);
+}
+
+size_t guiarstr_str_count_i(const GuiarStr* str, GuiarStrView needle) {
+    return guiarstr_view_count_i(guiarstr_view_from_str(str), needle);
+}
+
+bool guiarstr_str_contains(const GuiarStr* str, GuiarStrView needle) {
+    return guiarstr_view_contains(guiarstr_view_from_str(str), needle);
+}
+
+// Edits the string's own buffer: a shrinking replacement compacts it in one forward pass, a growing
+// one counts first, grows the buffer once and moves the text to its end so the same forward pass
+// can fill from the front. from or to pointing into str fall back to copying into a new buffer.
+// from is the caller's needle, checked for aliasing; pattern may search a folded copy of it
+static GuiarStrError guiarstr_str_replace_pattern(GuiarStr* str, const GuiarStrPattern* pattern, GuiarStrView from,
+                                                  GuiarStrView to, size_t max_replacements) {
+    size_t len = str->length;
+    size_t result_len = len;
+    if (to.length > from.length) {
+        max_replacements = guiarstr_replace_count(pattern, str->data, len, max_replacements);
+        if (max_replacements == 0) {
+            return GUIARSTR_OK;
+        }
+        
+        size_t extra = to.length - from.length;
+        if (max_replacements > (SIZE_MAX - 1 - len) / extra) {
+            return GUIARSTR_ERR_OVERFLOW;
+        }
+        result_len = len + max_replacements * extra;
+    }
+    
+    GuiarStrView operands[2] = {from, to};
+    if (guiarstr_views_alias(str, operands, 2)) {
+        char* result = guiarstr_mem_alloc(str->allocator, result_len + 1);
+        if (!result) {
+            return GUIARSTR_ERR_MEMORY;
+        }
+        
+        size_t capacity = result_len + 1;
+        result_len = guiarstr_replace_compact(pattern, to, result, str->data, len, max_replacements);
+        result[result_len] = '\0';
+        
+        guiarstr_release_data(str);
+        str->data = result;
+        str->length = result_len;
+        str->capacity = capacity;
+        str->flags &= ~(GUIARSTR_FLAG_INLINE | GUIARSTR_FLAG_BORROWED | GUIARSTR_FLAG_SHARED | GUIARSTR_FLAG_MAPPED);
+        return GUIARSTR_OK;
+    }
+    
+    GuiarStrError err = guiarstr_ensure_capacity(str, result_len + 1);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    char* src = str->data;
+    if (result_len > len) {
+        src += result_len - len;
+        memmove(src, str->data, len);
+    }
+    
+    str->length = guiarstr_replace_compact(pattern, to, str->data, src, len, max_replacements);
     str->data[str->length] = '\0';
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_str_replace(GuiarStr* str, GuiarStrView from, GuiarStrView to, size_t max_replacements) {
+    GUIARSTR_CHECK_NULL(str);
+    if (from.length == 0) {
+        return GUIARSTR_ERR_INVALID;
+    }
+    
+    GuiarStrPattern pattern;
+    guiarstr_pattern_setup(&pattern, from.data, from.length, 0);
+    return guiarstr_str_replace_pattern(str, &pattern, from, to, max_replacements);
+}
+
+GuiarStrError guiarstr_str_replace_i(GuiarStr* str, GuiarStrView from, GuiarStrView to, size_t max_replacements) {
+    GUIARSTR_CHECK_NULL(str);
+    if (from.length == 0) {
+        return GUIARSTR_ERR_INVALID;
+    }
+    
+    char buffer[GUIARSTR_FOLD_BUFFER];
+    GuiarStrPattern pattern;
+    if (!guiarstr_pattern_setup_folded(&pattern, from.data, from.length, buffer)) {
+        return GUIARSTR_ERR_MEMORY;
+    }
+    
+    GuiarStrError err = guiarstr_str_replace_pattern(str, &pattern, from, to, max_replacements);
+    guiarstr_pattern_release_folded(&pattern, buffer);
+    return err;
+}
+
+size_t guiarstr_str_split(const GuiarStr* str, GuiarStrView delimiter, GuiarStrView* views, size_t max_views) {
+    return guiarstr_view_split_str(guiarstr_view_from_str(str), delimiter, views, max_views);
+}
+
+int guiarstr_str_compare(const GuiarStr* a, const GuiarStr* b) {
+    return guiarstr_view_compare(guiarstr_view_from_str(a), guiarstr_view_from_str(b));
+}
+
+bool guiarstr_str_equals(const GuiarStr* a, const GuiarStr* b) {
+    return guiarstr_view_equals(guiarstr_view_from_str(a), guiarstr_view_from_str(b));
+}
+
+uint64_t guiarstr_str_hash(const GuiarStr* str) {
+    return guiarstr_view_hash(guiarstr_view_from_str(str));
+}
+
+static GuiarStrError guiarstr_str_case(GuiarStr* str, bool upper) {
+    GUIARSTR_CHECK_NULL(str);
+    
+    GuiarStrError err = guiarstr_make_unique(str);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
     
+    guiarstr_ascii_case(str->data, str->data, str->length, upper);
     return GUIARSTR_OK;
 }
 
-GuiarStrError guiarstr_append_char(GuiarStr* str, char c) {
+GuiarStrError guiarstr_str_tolower(GuiarStr* str) {
+    return guiarstr_str_case(str, false);
+}
+
+GuiarStrError guiarstr_str_toupper(GuiarStr* str) {
+    return guiarstr_str_case(str, true);
+}
+
+GuiarStrError guiarstr_str_trim(GuiarStr* str) {
     GUIARSTR_CHECK_NULL(str);
     
-    GuiarStrError err = guiarstr_ensure_capacity(str, str->length + 2);
+    GuiarStrView trimmed = guiarstr_view_trim(guiarstr_view_from_str(str));
+    if (trimmed.length == str->length) {
+        return GUIARSTR_OK;
+    }
+    
+    size_t start = (size_t)(trimmed.data - str->data);
+    GuiarStrError err = guiarstr_make_unique(str);
     if (err != GUIARSTR_OK) {
         return err;
     }
     
-    str->data[str->length++] = c;
+    memmove(str->data, str->data + start, trimmed.length);
+    str->length = trimmed.length;
     str->data[str->length] = '\0';
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_str_replace_many(GuiarStr* str, const GuiarStrView* from, const GuiarStrView* to, size_t n) {
+    GUIARSTR_CHECK_NULL(str);
+    if (n > 0 && (!from || !to)) {
+        return GUIARSTR_ERR_NULL;
+    }
+    
+    for (size_t i = 0; i < n; i++) {
+        if (!from[i].data || from[i].length == 0) {
+            return GUIARSTR_ERR_INVALID;
+        }
+    }
+    
+    GuiarStrMatcher* matcher = guiarstr_matcher_create(from, n, 0);
+    if (!matcher) {
+        return GUIARSTR_ERR_MEMORY;
+    }
+    
+    GuiarStrError err = guiarstr_matcher_replace_str(matcher, str, to);
+    guiarstr_matcher_free(matcher);
+    return err;
+}
+
+// String builder
+GuiarStrBuilder* guiarstr_builder_create(size_t initial_capacity) {
+    return guiarstr_builder_create_with_allocator(initial_capacity, NULL);
+}
+
+static GuiarStrError guiarstr_builder_init_impl(GuiarStrBuilder* builder, size_t initial_capacity, const GuiarStrAllocator* allocator) {
+    builder->allocator = allocator;
+    builder->buffer = guiarstr_create_empty_with_allocator(initial_capacity, allocator);
+    if (!builder->buffer) {
+        return GUIARSTR_ERR_MEMORY;
+    }
+    
+    builder->parts_count = 0;
+    builder->parts_capacity = 16;
+    builder->parts = guiarstr_mem_alloc(allocator, builder->parts_capacity * sizeof(GuiarStrView));
+    if (!builder->parts) {
+        guiarstr_free(builder->buffer);
+        return GUIARSTR_ERR_MEMORY;
+    }
     
     return GUIARSTR_OK;
 }
 
-GuiarStrError guiarstr_append_view(GuiarStr* str, const GuiarStrView* view) {
+GuiarStrBuilder* guiarstr_builder_create_with_allocator(size_t initial_capacity, const GuiarStrAllocator* allocator) {
+    allocator = guiarstr_resolve_allocator(allocator);
+    
+    GuiarStrBuilder* builder = guiarstr_mem_alloc(allocator, sizeof(GuiarStrBuilder));
+    if (!builder) return NULL;
+    
+    if (guiarstr_builder_init_impl(builder, initial_capacity, allocator) != GUIARSTR_OK) {
+        guiarstr_mem_free(allocator, builder);
+        return NULL;
+    }
+    
+    return builder;
+}
+
+GuiarStrError guiarstr_builder_init(GuiarStrBuilder* builder, size_t initial_capacity) {
+    GUIARSTR_CHECK_NULL(builder);
+    
+    return guiarstr_builder_init_impl(builder, initial_capacity, guiarstr_resolve_allocator(NULL));
+}
+
+void guiarstr_builder_deinit(GuiarStrBuilder* builder) {
+    if (!builder) return;
+    
+    guiarstr_free(builder->buffer);
+    guiarstr_mem_free(builder->allocator, builder->parts);
+    builder->buffer = NULL;
+    builder->parts = NULL;
+    builder->parts_count = 0;
+    builder->parts_capacity = 0;
+}
+
+void guiarstr_builder_free(GuiarStrBuilder* builder) {
+    if (!builder) return;
+    
+    guiarstr_builder_deinit(builder);
+    guiarstr_mem_free(builder->allocator, builder);
+}
+
+GuiarStrError guiarstr_builder_append(GuiarStrBuilder* builder, const char* str) {
+    GUIARSTR_CHECK_NULL(builder);
     GUIARSTR_CHECK_NULL(str);
+    
+    GuiarStrView view;
+    view.data = str;
+    view.length = strlen(str);
+    
+    return guiarstr_builder_append_view(builder, &view);
+}
+
+GuiarStrError guiarstr_builder_append_view(GuiarStrBuilder* builder, const GuiarStrView* view) {
+    GUIARSTR_CHECK_NULL(builder);
     GUIARSTR_CHECK_NULL(view);
     
-    return guiarstr_append_len(str, view->data, view->length);
+    // Add to parts array
+    if (builder->parts_count >= builder->parts_capacity) {
+        size_t new_capacity = builder->parts_capacity * 2;
+        GuiarStrView* new_parts = guiarstr_mem_realloc(builder->allocator, builder->parts,
+                                                       builder->parts_capacity * sizeof(GuiarStrView),
+                                                       new_capacity * sizeof(GuiarStrView));
+        if (!new_parts) return GUIARSTR_ERR_MEMORY;
+        
+        builder->parts = new_parts;
+        builder->parts_capacity = new_capacity;
+    }
+    
+    builder->parts[builder->parts_count++] = *view;
+    
+    // Also append to buffer
+    return guiarstr_append_len(builder->buffer, view->data, view->length);
 }
 
-GuiarStrError guiarstr_insert(GuiarStr* str, size_t pos, const char* insert) {
-    if (!insert) {
-        return GUIARSTR_ERR_NULL;
+GuiarStrError guiarstr_builder_append_char(GuiarStrBuilder* builder, char c) {
+    GUIARSTR_CHECK_NULL(builder);
+    
+    char str[2] = {c, '\0'};
+    return guiarstr_builder_append(builder, str);
+}
+
+GuiarStrError guiarstr_builder_append_fmt(GuiarStrBuilder* builder, const char* fmt, ...) {
+    GUIARSTR_CHECK_NULL(builder);
+    GUIARSTR_CHECK_NULL(fmt);
+    
+    va_list args;
+    va_start(args, fmt);
+    GuiarStrError err = guiarstr_builder_append_fmt_va(builder, fmt, args);
+    va_end(args);
+    
+    return err;
+}
+
+GuiarStrError guiarstr_builder_append_fmt_va(GuiarStrBuilder* builder, const char* fmt, va_list args) {
+    GUIARSTR_CHECK_NULL(builder);
+    GUIARSTR_CHECK_NULL(fmt);
+    
+    // First, determine how much space we need
+    va_list args_copy;
+    va_copy(args_copy, args);
+    int needed = vsnprintf(NULL, 0, fmt, args_copy);
+    va_end(args_copy);
+    
+    if (needed < 0) {
+        return GUIARSTR_ERR_INVALID;
+    }
+    
+    // Ensure we have enough space
+    GuiarStrError err = guiarstr_ensure_capacity(builder->buffer, builder->buffer->length + needed + 1);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
+    
+    // Format directly into the buffer
+    int written = vsnprintf(builder->buffer->data + builder->buffer->length, 
+                           builder->buffer->capacity - builder->buffer->length, 
+                           fmt, args);
+    
+    if (written < 0) {
+        return GUIARSTR_ERR_INVALID;
+    }
+    
+    builder->buffer->length += written;
+    
+    // Add to parts array
+    GuiarStrView view;
+    view.data = builder->buffer->data + builder->buffer->length - written;
+    view.length = written;
+    
+    if (builder->parts_count >= builder->parts_capacity) {
+        size_t new_capacity = builder->parts_capacity * 2;
+        GuiarStrView* new_parts = guiarstr_mem_realloc(builder->allocator, builder->parts,
+                                                       builder->parts_capacity * sizeof(GuiarStrView),
+                                                       new_capacity * sizeof(GuiarStrView));
+        if (!new_parts) return GUIARSTR_ERR_MEMORY;
+        
+        builder->parts = new_parts;
+        builder->parts_capacity = new_capacity;
     }
     
-    return guiarstr_insert_len(str, pos, insert, strlen(insert));
+    builder->parts[builder->parts_count++] = view;
+    
+    return GUIARSTR_OK;
+}
+
+GuiarStr* guiarstr_builder_build(GuiarStrBuilder* builder) {
+    if (!builder) return NULL;
+    
+    return guiarstr_copy(builder->buffer);
 }
 
-GuiarStrError guiarstr_insert_len(GuiarStr* str, size_t pos, const char* insert, size_t len) {
-    GUIARSTR_CHECK_NULL(str);
-    if (!insert && len > 0) {
-        return GUIARSTR_ERR_NULL;
-    }
+// Hands the buffer itself to the caller and leaves a fresh one behind: no copy of the contents
+GuiarStr* guiarstr_builder_take(GuiarStrBuilder* builder, bool shrink) {
+    if (!builder) return NULL;
     
-    if (len == 0) {
-        return GUIARSTR_OK;
+    GuiarStr* fresh = guiarstr_create_empty_with_allocator(GUIARSTR_MIN_CAPACITY, builder->allocator);
+    if (!fresh) {
+        return NULL;
     }
     
-    if (pos > str->length) {
-        pos = str->length;
+    GuiarStr* result = builder->buffer;
+    builder->buffer = fresh;
+    builder->parts_count = 0;
+    
+    if (shrink) {
+        guiarstr_shrink_to_fit(result);
     }
     
-    GuiarStrError err = guiarstr_ensure_capacity(str, str->length + len + 1);
+    return result;
+}
+
+GuiarStrError guiarstr_builder_reset(GuiarStrBuilder* builder) {
+    GUIARSTR_CHECK_NULL(builder);
+    
+    GuiarStrError err = guiarstr_clear(builder->buffer);
     if (err != GUIARSTR_OK) {
         return err;
     }
     
-    memmove(str->data + pos + len, str->data + pos, str->length - pos);
-    memcpy(str->data + pos, insert, len);
-    str->length += len;
-    str->data[str->length] = '\0';
-    
+    builder->parts_count = 0;
     return GUIARSTR_OK;
 }
 
-GuiarStrError guiarstr_insert_char(GuiarStr* str, size_t pos, char c) {
-    GUIARSTR_CHECK_NULL(str);
+// Chunked builder
+struct GuiarStrChunk {
+    GuiarStrChunk* next;
+    size_t size;
+    size_t used;
+};
+
+static char* guiarstr_chunk_data(const GuiarStrChunk* chunk) {
+    return (char*)(chunk + 1);
+}
+
+// Earlier chunks are never moved: a new one is linked in once the last is full
+static GuiarStrChunk* guiarstr_chunk_builder_grow(GuiarStrChunkBuilder* builder, size_t min_size) {
+    size_t size = builder->chunk_size;
+    if (size < min_size) {
+        size = min_size;
+    }
     
-    if (pos > str->length) {
-        pos = str->length;
+    if (size > SIZE_MAX - sizeof(GuiarStrChunk)) {
+        return NULL;
     }
     
-    GuiarStrError err = guiarstr_ensure_capacity(str, str->length + 2);
-    if (err != GUIARSTR_OK) {
-        return err;
+    GuiarStrChunk* chunk = guiarstr_mem_alloc(builder->allocator, sizeof(GuiarStrChunk) + size);
+    if (!chunk) {
+        return NULL;
     }
     
-    memmove(str->data + pos + 1, str->data + pos, str->length - pos);
-    str->data[pos] = c;
-    str->length++;
-    str->data[str->length] = '\0';
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
     
-    return GUIARSTR_OK;
+    if (builder->last) {
+        builder->last->next = chunk;
+    } else {
+        builder->first = chunk;
+    }
+    builder->last = chunk;
+    
+    return chunk;
 }
 
-GuiarStrError guiarstr_remove(GuiarStr* str, size_t pos, size_t len) {
-    GUIARSTR_CHECK_NULL(str);
-    
-    if (pos >= str->length) {
-        return GUIARSTR_OK;
+static void guiarstr_chunk_free_list(const GuiarStrAllocator* allocator, GuiarStrChunk* chunk) {
+    while (chunk) {
+        GuiarStrChunk* next = chunk->next;
+        guiarstr_mem_free(allocator, chunk);
+        chunk = next;
     }
+}
+
+GuiarStrChunkBuilder* guiarstr_chunk_builder_create(size_t chunk_size) {
+    return guiarstr_chunk_builder_create_with_allocator(chunk_size, NULL);
+}
+
+GuiarStrChunkBuilder* guiarstr_chunk_builder_create_with_allocator(size_t chunk_size, const GuiarStrAllocator* allocator) {
+    allocator = guiarstr_resolve_allocator(allocator);
     
-    if (pos + len > str->length) {
-        len = str->length - pos;
-    }
+    GuiarStrChunkBuilder* builder = guiarstr_mem_alloc(allocator, sizeof(GuiarStrChunkBuilder));
+    if (!builder) return NULL;
     
-    memmove(str->data + pos, str->data + pos + len, str->length - pos - len);
-    str->length -= len;
-    str->data[str->length] = '\0';
+    builder->first = NULL;
+    builder->last = NULL;
+    builder->chunk_size = chunk_size ? chunk_size : GUIARSTR_CHUNK_DEFAULT_SIZE;
+    builder->length = 0;
+    builder->allocator = allocator;
     
-    return GUIARSTR_OK;
+    return builder;
 }
 
-GuiarStrError guiarstr_clear(GuiarStr* str) {
-    GUIARSTR_CHECK_NULL(str);
+void guiarstr_chunk_builder_free(GuiarStrChunkBuilder* builder) {
+    if (!builder) return;
     
-    str->length = 0;
-    str->data[0] = '\0';
+    guiarstr_chunk_free_list(builder->allocator, builder->first);
+    guiarstr_mem_free(builder->allocator, builder);
+}
+
+GuiarStrError guiarstr_chunk_builder_append(GuiarStrChunkBuilder* builder, const char* str) {
+    GUIARSTR_CHECK_NULL(str);
     
-    return GUIARSTR_OK;
+    return guiarstr_chunk_builder_append_len(builder, str, strlen(str));
 }
 
-// String inspection and search
-bool guiarstr_startswith(const char* str, const char* prefix) {
-    if (!str || !prefix) return false;
+GuiarStrError guiarstr_chunk_builder_append_len(GuiarStrChunkBuilder* builder, const char* str, size_t len) {
+    GUIARSTR_CHECK_NULL(builder);
+    if (!str && len > 0) {
+        return GUIARSTR_ERR_NULL;
+    }
     
-    while (*prefix) {
-        if (*str++ != *prefix++) return false;
+    while (len > 0) {
+        GuiarStrChunk* chunk = builder->last;
+        if (!chunk || chunk->used == chunk->size) {
+            chunk = guiarstr_chunk_builder_grow(builder, len);
+            if (!chunk) {
+                return GUIARSTR_ERR_MEMORY;
+            }
+        }
+        
+        size_t n = chunk->size - chunk->used;
+        if (n > len) {
+            n = len;
+        }
+        
+        memcpy(guiarstr_chunk_data(chunk) + chunk->used, str, n);
+        chunk->used += n;
+        builder->length += n;
+        str += n;
+        len -= n;
     }
     
-    return true;
+    return GUIARSTR_OK;
 }
 
-bool guiarstr_endswith(const char* str, const char* suffix) {
-    if (!str || !suffix) return false;
-    
-    size_t lenstr = strlen(str);
-    size_t lensuffix = strlen(suffix);
-    
-    if (lensuffix > lenstr) return false;
+GuiarStrError guiarstr_chunk_builder_append_view(GuiarStrChunkBuilder* builder, const GuiarStrView* view) {
+    GUIARSTR_CHECK_NULL(view);
     
-    return strcmp(str + lenstr - lensuffix, suffix) == 0;
+    return guiarstr_chunk_builder_append_len(builder, view->data, view->length);
 }
 
-bool guiarstr_startswithi(const char* str, const char* prefix) {
-    if (!str || !prefix) return false;
+GuiarStrError guiarstr_chunk_builder_append_char(GuiarStrChunkBuilder* builder, char c) {
+    return guiarstr_chunk_builder_append_len(builder, &c, 1);
+}
+
+GuiarStrError guiarstr_chunk_builder_append_fmt(GuiarStrChunkBuilder* builder, const char* fmt, ...) {
+    GUIARSTR_CHECK_NULL(builder);
+    GUIARSTR_CHECK_NULL(fmt);
     
-    while (*prefix) {
-        if (tolower((unsigned char)*str++) != tolower((unsigned char)*prefix++))
-            return false;
-    }
+    va_list args;
+    va_start(args, fmt);
+    GuiarStrError err = guiarstr_chunk_builder_append_fmt_va(builder, fmt, args);
+    va_end(args);
     
-    return true;
+    return err;
 }
 
-bool guiarstr_endswithi(const char* str, const char* suffix) {
-    if (!str || !suffix) return false;
+GuiarStrError guiarstr_chunk_builder_append_fmt_va(GuiarStrChunkBuilder* builder, const char* fmt, va_list args) {
+    GUIARSTR_CHECK_NULL(builder);
+    GUIARSTR_CHECK_NULL(fmt);
     
-    size_t lenstr = strlen(str);
-    size_t lensuffix = strlen(suffix);
+    va_list args_copy;
+    va_copy(args_copy, args);
+    int needed = vsnprintf(NULL, 0, fmt, args_copy);
+    va_end(args_copy);
     
-    if (lensuffix > lenstr) return false;
+    if (needed < 0) {
+        return GUIARSTR_ERR_INVALID;
+    }
     
-    const char* str_end = str + lenstr - lensuffix;
-    while (*suffix) {
-        if (tolower((unsigned char)*str_end++) != tolower((unsigned char)*suffix++))
-            return false;
+    // Formatted output must be contiguous, including the terminator vsnprintf writes
+    size_t required = (size_t)needed + 1;
+    GuiarStrChunk* chunk = builder->last;
+    if (!chunk || chunk->size - chunk->used < required) {
+        chunk = guiarstr_chunk_builder_grow(builder, required);
+        if (!chunk) {
+            return GUIARSTR_ERR_MEMORY;
+        }
     }
     
-    return true;
+    vsnprintf(guiarstr_chunk_data(chunk) + chunk->used, required, fmt, args);
+    chunk->used += needed;
+    builder->length += needed;
+    
+    return GUIARSTR_OK;
 }
 
-bool guiarstr_contains(const char* str, const char* substr) {
-    if (!str || !substr) return false;
-    
-    return strstr(str, substr) != NULL;
+size_t guiarstr_chunk_builder_length(const GuiarStrChunkBuilder* builder) {
+    return builder ? builder->length : 0;
 }
 
-size_t guiarstr_count(const char* str, const char* substr) {
-    if (!str || !substr || !*substr) return 0;
+size_t guiarstr_chunk_builder_views(const GuiarStrChunkBuilder* builder, GuiarStrView* views, size_t max_views) {
+    if (!builder) return 0;
     
     size_t count = 0;
-    size_t len = strlen(substr);
-    const char* p = str;
-    
-    while ((p = strstr(p, substr))) {
+    for (const GuiarStrChunk* chunk = builder->first; chunk; chunk = chunk->next) {
+        if (chunk->used == 0) {
+            continue;
+        }
+        
+        if (views && count < max_views) {
+            views[count].data = guiarstr_chunk_data(chunk);
+            views[count].length = chunk->used;
+        }
         count++;
-        p += len;
     }
     
     return count;
 }
 
-// Advanced search
-size_t guiarstr_find(const char* str, const char* substr) {
-    if (!str || !substr) return (size_t)-1;
+GuiarStr* guiarstr_chunk_builder_flatten(const GuiarStrChunkBuilder* builder) {
+    if (!builder) return NULL;
     
-    const char* found = strstr(str, substr);
-    return found ? (size_t)(found - str) : (size_t)-1;
-}
-
-size_t guiarstr_find_from(const char* str, const char* substr, size_t from_pos) {
-    if (!str || !substr) return (size_t)-1;
+    GuiarStr* result = guiarstr_alloc_str(builder->allocator, builder->length + 1);
+    if (!result) {
+        return NULL;
+    }
     
-    size_t str_len = strlen(str);
-    if (from_pos > str_len) return (size_t)-1;
+    char* dest = result->data;
+    for (const GuiarStrChunk* chunk = builder->first; chunk; chunk = chunk->next) {
+        memcpy(dest, guiarstr_chunk_data(chunk), chunk->used);
+        dest += chunk->used;
+    }
     
-    const char* found = strstr(str + from_pos, substr);
-    return found ? (size_t)(found - str) : (size_t)-1;
+    *dest = '\0';
+    result->length = builder->length;
+    
+    return result;
 }
 
-size_t guiarstr_rfind(const char* str, const char* substr) {
-    if (!str || !substr) return (size_t)-1;
+GuiarStrError guiarstr_chunk_builder_write_fd(const GuiarStrChunkBuilder* builder, int fd) {
+    GUIARSTR_CHECK_NULL(builder);
     
-    size_t substr_len = strlen(substr);
-    if (substr_len == 0) return strlen(str);
+    const GuiarStrChunk* chunk = builder->first;
+    size_t offset = 0;
     
-    size_t str_len = strlen(str);
-    if (substr_len > str_len) return (size_t)-1;
+#ifdef GUIARSTR_HAVE_WRITEV
+    struct iovec iov[GUIARSTR_IOV_BATCH];
     
-    for (size_t i = str_len - substr_len; i != (size_t)-1; i--) {
-        if (strncmp(str + i, substr, substr_len) == 0) {
-            return i;
+    while (chunk) {
+        int count = 0;
+        size_t skip = offset;
+        for (const GuiarStrChunk* c = chunk; c && count < GUIARSTR_IOV_BATCH; c = c->next) {
+            if (c->used > skip) {
+                iov[count].iov_base = guiarstr_chunk_data(c) + skip;
+                iov[count].iov_len = c->used - skip;
+                count++;
+            }
+            skip = 0;
+        }
+        
+        if (count == 0) {
+            break;
+        }
+        
+        ssize_t written = writev(fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return GUIARSTR_ERR_INVALID;
+        }
+        
+        // Short writes resume in the middle of a chunk
+        size_t left = (size_t)written;
+        while (chunk) {
+            size_t available = chunk->used - offset;
+            if (left < available) {
+                offset += left;
+                break;
+            }
+            left -= available;
+            chunk = chunk->next;
+            offset = 0;
+        }
+    }
+#else
+    for (; chunk; chunk = chunk->next) {
+        for (offset = 0; offset < chunk->used;) {
+#ifdef _WIN32
+            int written = _write(fd, guiarstr_chunk_data(chunk) + offset, (unsigned int)(chunk->used - offset));
+#else
+            int written = -1;
+#endif
+            if (written < 0) {
+                return GUIARSTR_ERR_INVALID;
+            }
+            offset += (size_t)written;
         }
     }
+#endif
     
-    return (size_t)-1;
+    return GUIARSTR_OK;
 }
 
-size_t guiarstr_find_char(const char* str, char c) {
-    if (!str) return (size_t)-1;
-    
-    const char* found = strchr(str, c);
-    return found ? (size_t)(found - str) : (size_t)-1;
+// Keeps the first chunk for reuse
+void guiarstr_chunk_builder_reset(GuiarStrChunkBuilder* builder) {
+    if (!builder || !builder->first) return;
+    
+    guiarstr_chunk_free_list(builder->allocator, builder->first->next);
+    builder->first->next = NULL;
+    builder->first->used = 0;
+    builder->last = builder->first;
+    builder->length = 0;
 }
 
-size_t guiarstr_find_char_from(const char* str, char c, size_t from_pos) {
-    if (!str) return (size_t)-1;
-    
-    size_t str_len = strlen(str);
-    if (from_pos > str_len) return (size_t)-1;
-    
-    const char* found = strchr(str + from_pos, c);
-    return found ? (size_t)(found - str) : (size_t)-1;
+// Rope (treap of text chunks keyed by position)
+struct GuiarStrRopeNode {
+    GuiarStrRopeNode* left;
+    GuiarStrRopeNode* right;
+    unsigned int priority;
+    size_t length;
+    size_t chars;
+    size_t total_length;
+    size_t total_chars;
+    char data[GUIARSTR_ROPE_CHUNK];
+};
+
+typedef void (*GuiarStrRopeVisitor)(const char* data, size_t len, void* ctx);
+
+static size_t guiarstr_rope_total_length(const GuiarStrRopeNode* node) {
+    return node ? node->total_length : 0;
 }
 
-size_t guiarstr_rfind_char(const char* str, char c) {
-    if (!str) return (size_t)-1;
-    
-    const char* found = strrchr(str, c);
-    return found ? (size_t)(found - str) : (size_t)-1;
+static size_t guiarstr_rope_total_chars(const GuiarStrRopeNode* node) {
+    return node ? node->total_chars : 0;
 }
 
-size_t guiarstr_find_any(const char* str, const char* chars) {
-    if (!str || !chars) return (size_t)-1;
-    
-    return strcspn(str, chars);
+static void guiarstr_rope_update(GuiarStrRopeNode* node) {
+    node->total_length = node->length + guiarstr_rope_total_length(node->left) + guiarstr_rope_total_length(node->right);
+    node->total_chars = node->chars + guiarstr_rope_total_chars(node->left) + guiarstr_rope_total_chars(node->right);
 }
 
-size_t guiarstr_find_any_from(const char* str, const char* chars, size_t from_pos) {
-    if (!str || !chars) return (size_t)-1;
+static unsigned int guiarstr_rope_random(GuiarStrRope* rope) {
+    unsigned int x = rope->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rope->seed = x;
+    return x;
+}
+
+static GuiarStrRopeNode* guiarstr_rope_node_alloc(GuiarStrRope* rope, const char* data, size_t len) {
+    GuiarStrRopeNode* node = guiarstr_mem_alloc(rope->allocator, sizeof(GuiarStrRopeNode));
+    if (!node) {
+        return NULL;
+    }
     
-    size_t str_len = strlen(str);
-    if (from_pos > str_len) return (size_t)-1;
+    node->left = NULL;
+    node->right = NULL;
+    node->priority = guiarstr_rope_random(rope);
+    memcpy(node->data, data, len);
+    node->length = len;
+    node->chars = guiarstr_utf8_count_chars(data, len);
+    guiarstr_rope_update(node);
     
-    size_t pos = strcspn(str + from_pos, chars);
-    return (pos == strlen(str + from_pos)) ? (size_t)-1 : from_pos + pos;
+    return node;
 }
 
-size_t guiarstr_find_not_any(const char* str, const char* chars) {
-    if (!str || !chars) return (size_t)-1;
+static void guiarstr_rope_free_nodes(const GuiarStrAllocator* allocator, GuiarStrRopeNode* node) {
+    if (!node) return;
     
-    return strspn(str, chars);
+    guiarstr_rope_free_nodes(allocator, node->left);
+    guiarstr_rope_free_nodes(allocator, node->right);
+    guiarstr_mem_free(allocator, node);
 }
 
-size_t guiarstr_find_not_any_from(const char* str, const char* chars, size_t from_pos) {
-    if (!str || !chars) return (size_t)-1;
-    
-    size_t str_len = strlen(str);
-    if (from_pos > str_len) return (size_t)-1;
+static GuiarStrRopeNode* guiarstr_rope_merge(GuiarStrRopeNode* a, GuiarStrRopeNode* b) {
+    if (!a) return b;
+    if (!b) return a;
+    
+    if (a->priority >= b->priority) {
+        a->right = guiarstr_rope_merge(a->right, b);
+        guiarstr_rope_update(a);
+        return a;
+    }
     
-    size_t pos = strspn(str + from_pos, chars);
-    return (pos == strlen(str + from_pos)) ? (size_t)-1 : from_pos + pos;
+    b->left = guiarstr_rope_merge(a, b->left);
+    guiarstr_rope_update(b);
+    return b;
 }
 
-// String modification
-char* guiarstr_reverse(const char* str) {
-    if (!str) return NULL;
-    
-    size_t len = strlen(str);
-    char* reversed = malloc(len + 1);
-    if (!reversed) return NULL;
-    
-    const char* p = str + len;
-    char* out = reversed;
+// Splits into [0, pos) and [pos, end). A chunk cut in two takes *spare as its tail, which
+// is preallocated so that the split itself cannot fail.
+static void guiarstr_rope_split(GuiarStrRopeNode* node, size_t pos, GuiarStrRopeNode** spare,
+                                GuiarStrRopeNode** left, GuiarStrRopeNode** right) {
+    if (!node) {
+        *left = NULL;
+        *right = NULL;
+        return;
+    }
     
-    while (p > str) {
-        const char* start = p - 1;
-        while (start > str && (*start & 0xC0) == 0x80) start--;
+    size_t left_len = guiarstr_rope_total_length(node->left);
+    if (pos <= left_len) {
+        guiarstr_rope_split(node->left, pos, spare, left, &node->left);
+        guiarstr_rope_update(node);
+        *right = node;
+    } else if (pos >= left_len + node->length) {
+        guiarstr_rope_split(node->right, pos - left_len - node->length, spare, &node->right, right);
+        guiarstr_rope_update(node);
+        *left = node;
+    } else {
+        size_t offset = pos - left_len;
+        GuiarStrRopeNode* tail = *spare;
+        *spare = NULL;
         
-        int char_len = p - start;
-        memcpy(out, start, char_len);
-        out += char_len;
-        p = start;
+        tail->length = node->length - offset;
+        memcpy(tail->data, node->data + offset, tail->length);
+        tail->chars = guiarstr_utf8_count_chars(tail->data, tail->length);
+        tail->priority = node->priority;
+        tail->left = NULL;
+        tail->right = node->right;
+        
+        node->length = offset;
+        node->chars -= tail->chars;
+        node->right = NULL;
+        
+        guiarstr_rope_update(node);
+        guiarstr_rope_update(tail);
+        *left = node;
+        *right = tail;
     }
-    
-    *out = '\0';
-    return reversed;
 }
 
-char* guiarstr_replace(const char* str, const char* from, const char* to) {
-    return guiarstr_replace_n(str, from, to, (size_t)-1);
-}
-
-char* guiarstr_replace_n(const char* str, const char* from, const char* to, size_t max_replacements) {
-    if (!str || !from || !to || !*from) return NULL;
-    
-    size_t from_len = strlen(from);
-    size_t to_len = strlen(to);
-    size_t count = 0;
-    size_t str_len = strlen(str);
-    
-    // Count occurrences
-    const char* tmp = str;
-    while ((tmp = strstr(tmp, from)) && (max_replacements == (size_t)-1 || count < max_replacements)) {
-        count++;
-        tmp += from_len;
+static GuiarStrError guiarstr_rope_build(GuiarStrRope* rope, const char* str, size_t len, GuiarStrRopeNode** out) {
+    GuiarStrRopeNode* tree = NULL;
+    
+    while (len > 0) {
+        size_t n = len < GUIARSTR_ROPE_FILL ? len : GUIARSTR_ROPE_FILL;
+        GuiarStrRopeNode* node = guiarstr_rope_node_alloc(rope, str, n);
+        if (!node) {
+            guiarstr_rope_free_nodes(rope->allocator, tree);
+            return GUIARSTR_ERR_MEMORY;
+        }
+        
+        tree = guiarstr_rope_merge(tree, node);
+        str += n;
+        len -= n;
     }
     
-    size_t result_len = str_len + count * (to_len - from_len);
-    char* result = malloc(result_len + 1);
-    if (!result) return NULL;
-    
-    const char* current = str;
-    char* dest = result;
-    size_t replacements = 0;
-    
-    while ((tmp = strstr(current, from)) && (max_replacements == (size_t)-1 || replacements < max_replacements)) {
-        size_t len = tmp - current;
-        memcpy(dest, current, len);
-        dest += len;
-        memcpy(dest, to, to_len);
-        dest += to_len;
-        current = tmp + from_len;
-        replacements++;
+    *out = tree;
+    return GUIARSTR_OK;
+}
+
+// Edits that stay within one chunk only touch that chunk and the totals above it
+static bool guiarstr_rope_insert_in_place(GuiarStrRopeNode* node, size_t pos, const char* str, size_t len) {
+    if (!node) return false;
+    
+    size_t left_len = guiarstr_rope_total_length(node->left);
+    bool done;
+    
+    if (pos < left_len) {
+        done = guiarstr_rope_insert_in_place(node->left, pos, str, len);
+    } else if (pos <= left_len + node->length) {
+        size_t offset = pos - left_len;
+        if (node->length + len > GUIARSTR_ROPE_CHUNK) {
+            return false;
+        }
+        
+        memmove(node->data + offset + len, node->data + offset, node->length - offset);
+        memcpy(node->data + offset, str, len);
+        node->length += len;
+        node->chars += guiarstr_utf8_count_chars(str, len);
+        done = true;
+    } else {
+        done = guiarstr_rope_insert_in_place(node->right, pos - left_len - node->length, str, len);
     }
     
-    strcpy(dest, current);
-    return result;
+    if (done) {
+        guiarstr_rope_update(node);
+    }
+    return done;
 }
 
-char* guiarstr_replace_char(const char* str, char from, char to) {
-    if (!str) return NULL;
+static bool guiarstr_rope_remove_in_place(GuiarStrRopeNode* node, size_t pos, size_t len) {
+    if (!node) return false;
     
-    size_t len = strlen(str);
-    char* result = malloc(len + 1);
-    if (!result) return NULL;
+    size_t left_len = guiarstr_rope_total_length(node->left);
+    bool done;
     
-    for (size_t i = 0; i < len; i++) {
-        result[i] = (str[i] == from) ? to : str[i];
+    if (pos < left_len) {
+        if (len > left_len - pos) {
+            return false;
+        }
+        done = guiarstr_rope_remove_in_place(node->left, pos, len);
+    } else if (pos < left_len + node->length) {
+        size_t offset = pos - left_len;
+        if (len > node->length - offset || len == node->length) {
+            return false;
+        }
+        
+        node->chars -= guiarstr_utf8_count_chars(node->data + offset, len);
+        memmove(node->data + offset, node->data + offset + len, node->length - offset - len);
+        node->length -= len;
+        done = true;
+    } else {
+        done = guiarstr_rope_remove_in_place(node->right, pos - left_len - node->length, len);
     }
     
-    result[len] = '\0';
-    return result;
+    if (done) {
+        guiarstr_rope_update(node);
+    }
+    return done;
 }
 
-char* guiarstr_remove_chars(const char* str, const char* chars_to_remove) {
-    if (!str || !chars_to_remove) return NULL;
+static void guiarstr_rope_visit(const GuiarStrRopeNode* node, size_t pos, size_t len, GuiarStrRopeVisitor visitor, void* ctx) {
+    if (!node || len == 0) return;
+    
+    size_t left_len = guiarstr_rope_total_length(node->left);
+    if (pos < left_len) {
+        size_t n = left_len - pos < len ? left_len - pos : len;
+        guiarstr_rope_visit(node->left, pos, n, visitor, ctx);
+        pos += n;
+        len -= n;
+    }
     
-    size_t len = strlen(str);
-    char* result = malloc(len + 1);
-    if (!result) return NULL;
+    size_t offset = pos - left_len;
+    if (len > 0 && offset < node->length) {
+        size_t n = node->length - offset < len ? node->length - offset : len;
+        visitor(node->data + offset, n, ctx);
+        pos += n;
+        len -= n;
+    }
     
-    size_t j = 0;
-    for (size_t i = 0; i < len; i++) {
-        if (!strchr(chars_to_remove, str[i])) {
-            result[j++] = str[i];
-        }
+    if (len > 0) {
+        guiarstr_rope_visit(node->right, pos - left_len - node->length, len, visitor, ctx);
+    }
+}
+
+static void guiarstr_rope_copy_visitor(const char* data, size_t len, void* ctx) {
+    char** dest = ctx;
+    memcpy(*dest, data, len);
+    *dest += len;
+}
+
+typedef struct {
+    GuiarStrView* views;
+    size_t max_views;
+    size_t count;
+} GuiarStrRopeViewCollector;
+
+static void guiarstr_rope_view_visitor(const char* data, size_t len, void* ctx) {
+    GuiarStrRopeViewCollector* collector = ctx;
+    if (collector->views && collector->count < collector->max_views) {
+        collector->views[collector->count].data = data;
+        collector->views[collector->count].length = len;
+    }
+    collector->count++;
+}
+
+GuiarStrRope* guiarstr_rope_create(const char* str) {
+    if (!str) {
+        return NULL;
     }
     
-    result[j] = '\0';
-    return result;
+    return guiarstr_rope_create_len(str, strlen(str));
 }
 
-// Split and join
-char** guiarstr_split(const char* str, char delimiter, size_t* count) {
-    if (!str || !count) return NULL;
+GuiarStrRope* guiarstr_rope_create_len(const char* str, size_t len) {
+    if (!str && len > 0) {
+        return NULL;
+    }
     
-    size_t capacity = 8;
-    size_t size = 0;
-    char** result = malloc(capacity * sizeof(char*));
-    if (!result) return NULL;
+    const GuiarStrAllocator* allocator = guiarstr_resolve_allocator(NULL);
+    GuiarStrRope* rope = guiarstr_mem_alloc(allocator, sizeof(GuiarStrRope));
+    if (!rope) {
+        return NULL;
+    }
     
-    const char* start = str;
-    const char* ptr = str;
+    rope->root = NULL;
+    rope->seed = 0x9E3779B9u;
+    rope->allocator = allocator;
     
-    while (*ptr) {
-        if (*ptr == delimiter) {
-            size_t len = ptr - start;
-            char* token = malloc(len + 1);
-            if (!token) goto cleanup;
-            
-            memcpy(token, start, len);
-            token[len] = '\0';
-            
-            if (size >= capacity) {
-                capacity *= 2;
-                char** temp = realloc(result, capacity * sizeof(char*));
-                if (!temp) goto cleanup;
-                result = temp;
-            }
-            
-            result[size++] = token;
-            start = ptr + 1;
-        }
-        ptr++;
+    if (guiarstr_rope_build(rope, str, len, &rope->root) != GUIARSTR_OK) {
+        guiarstr_mem_free(allocator, rope);
+        return NULL;
     }
     
-    size_t len = ptr - start;
-    char* token = malloc(len + 1);
-    if (!token) goto cleanup;
-    
-    memcpy(token, start, len);
-    token[len] = '\0';
-    result[size++] = token;
+    return rope;
+}
+
+GuiarStrRope* guiarstr_rope_from_str(const GuiarStr* str) {
+    if (!str) {
+        return NULL;
+    }
     
-    *count = size;
-    return result;
+    return guiarstr_rope_create_len(str->data, str->length);
+}
+
+void guiarstr_rope_free(GuiarStrRope* rope) {
+    if (!rope) return;
     
-cleanup:
-    for (size_t i = 0; i < size; ++i) free(result[i]);
-    free(result);
-    *count = 0;
-    return NULL;
+    guiarstr_rope_free_nodes(rope->allocator, rope->root);
+    guiarstr_mem_free(rope->allocator, rope);
 }
 
-char** guiarstr_split_str(const char* str, const char* delimiter, size_t* count) {
-    if (!str || !delimiter || !count) return NULL;
+size_t guiarstr_rope_length(const GuiarStrRope* rope) {
+    return rope ? guiarstr_rope_total_length(rope->root) : 0;
+}
+
+size_t guiarstr_rope_utf8_len(const GuiarStrRope* rope) {
+    return rope ? guiarstr_rope_total_chars(rope->root) : 0;
+}
+
+GuiarStrError guiarstr_rope_insert(GuiarStrRope* rope, size_t pos, const char* str) {
+    GUIARSTR_CHECK_NULL(str);
     
-    size_t delim_len = strlen(delimiter);
-    if (delim_len == 0) {
-        // Empty delimiter, return each character as a token
-        size_t len = strlen(str);
-        char** result = malloc(len * sizeof(char*));
-        if (!result) return NULL;
-        
-        for (size_t i = 0; i < len; i++) {
-            result[i] = malloc(2);
-            if (!result[i]) {
-                for (size_t j = 0; j < i; j++) free(result[j]);
-                free(result);
-                *count = 0;
-                return NULL;
-            }
-            result[i][0] = str[i];
-            result[i][1] = '\0';
-        }
-        
-        *count = len;
-        return result;
+    return guiarstr_rope_insert_len(rope, pos, str, strlen(str));
+}
+
+GuiarStrError guiarstr_rope_insert_len(GuiarStrRope* rope, size_t pos, const char* str, size_t len) {
+    GUIARSTR_CHECK_NULL(rope);
+    if (!str && len > 0) {
+        return GUIARSTR_ERR_NULL;
     }
     
-    size_t capacity = 8;
-    size_t size = 0;
-    char** result = malloc(capacity * sizeof(char*));
-    if (!result) return NULL;
+    if (len == 0) {
+        return GUIARSTR_OK;
+    }
     
-    const char* start = str;
-    const char* ptr = str;
+    size_t total = guiarstr_rope_total_length(rope->root);
+    if (pos > total) {
+        pos = total;
+    }
     
-    while (*ptr) {
-        if (strncmp(ptr, delimiter, delim_len) == 0) {
-            size_t len = ptr - start;
-            char* token = malloc(len + 1);
-            if (!token) goto cleanup;
-            
-            memcpy(token, start, len);
-            token[len] = '\0';
-            
-            if (size >= capacity) {
-                capacity *= 2;
-                char** temp = realloc(result, capacity * sizeof(char*));
-                if (!temp) goto cleanup;
-                result = temp;
-            }
-            
-            result[size++] = token;
-            start = ptr + delim_len;
-            ptr += delim_len - 1; // Will be incremented in the loop
-        }
-        ptr++;
+    if (guiarstr_rope_insert_in_place(rope->root, pos, str, len)) {
+        return GUIARSTR_OK;
     }
     
-    size_t len = ptr - start;
-    char* token = malloc(len + 1);
-    if (!token) goto cleanup;
+    GuiarStrRopeNode* middle;
+    GuiarStrError err = guiarstr_rope_build(rope, str, len, &middle);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
     
-    memcpy(token, start, len);
-    token[len] = '\0';
-    result[size++] = token;
+    GuiarStrRopeNode* spare = guiarstr_mem_alloc(rope->allocator, sizeof(GuiarStrRopeNode));
+    if (!spare) {
+        guiarstr_rope_free_nodes(rope->allocator, middle);
+        return GUIARSTR_ERR_MEMORY;
+    }
     
-    *count = size;
-    return result;
+    GuiarStrRopeNode* left;
+    GuiarStrRopeNode* right;
+    guiarstr_rope_split(rope->root, pos, &spare, &left, &right);
+    rope->root = guiarstr_rope_merge(guiarstr_rope_merge(left, middle), right);
     
-cleanup:
-    for (size_t i = 0; i < size; ++i) free(result[i]);
-    free(result);
-    *count = 0;
-    return NULL;
+    guiarstr_mem_free(rope->allocator, spare);
+    return GUIARSTR_OK;
 }
 
-char** guiarstr_split_any(const char* str, const char* delimiters, size_t* count) {
-    if (!str || !delimiters || !count) return NULL;
-    
-    size_t capacity = 8;
-    size_t size = 0;
-    char** result = malloc(capacity * sizeof(char*));
-    if (!result) return NULL;
+GuiarStrError guiarstr_rope_remove(GuiarStrRope* rope, size_t pos, size_t len) {
+    GUIARSTR_CHECK_NULL(rope);
     
-    const char* start = str;
-    const char* ptr = str;
+    size_t total = guiarstr_rope_total_length(rope->root);
+    if (pos >= total || len == 0) {
+        return GUIARSTR_OK;
+    }
     
-    while (*ptr) {
-        if (strchr(delimiters, *ptr)) {
-            size_t len = ptr - start;
-            char* token = malloc(len + 1);
-            if (!token) goto cleanup;
-            
-            memcpy(token, start, len);
-            token[len] = '\0';
-            
-            if (size >= capacity) {
-                capacity *= 2;
-                char** temp = realloc(result, capacity * sizeof(char*));
-                if (!temp) goto cleanup;
-                result = temp;
-            }
-            
-            result[size++] = token;
-            start = ptr + 1;
-        }
-        ptr++;
+    if (len > total - pos) {
+        len = total - pos;
     }
     
-    size_t len = ptr - start;
-    char* token = malloc(len + 1);
-    if (!token) goto cleanup;
+    if (guiarstr_rope_remove_in_place(rope->root, pos, len)) {
+        return GUIARSTR_OK;
+    }
     
-    memcpy(token, start, len);
-    token[len] = '\0';
-    result[size++] = token;
+    GuiarStrRopeNode* spares[2];
+    spares[0] = guiarstr_mem_alloc(rope->allocator, sizeof(GuiarStrRopeNode));
+    spares[1] = guiarstr_mem_alloc(rope->allocator, sizeof(GuiarStrRopeNode));
+    if (!spares[0] || !spares[1]) {
+        guiarstr_mem_free(rope->allocator, spares[0]);
+        guiarstr_mem_free(rope->allocator, spares[1]);
+        return GUIARSTR_ERR_MEMORY;
+    }
     
-    *count = size;
-    return result;
+    GuiarStrRopeNode* left;
+    GuiarStrRopeNode* middle;
+    GuiarStrRopeNode* right;
+    guiarstr_rope_split(rope->root, pos, &spares[0], &left, &right);
+    guiarstr_rope_split(right, len, &spares[1], &middle, &right);
+    rope->root = guiarstr_rope_merge(left, right);
     
-cleanup:
-    for (size_t i = 0; i < size; ++i) free(result[i]);
-    free(result);
-    *count = 0;
-    return NULL;
+    guiarstr_rope_free_nodes(rope->allocator, middle);
+    guiarstr_mem_free(rope->allocator, spares[0]);
+    guiarstr_mem_free(rope->allocator, spares[1]);
+    return GUIARSTR_OK;
 }
 
-char** guiarstr_split_lines(const char* str, size_t* count) {
-    if (!str || !count) return NULL;
-    
-    size_t capacity = 8;
-    size_t size = 0;
-    char** result = malloc(capacity * sizeof(char*));
-    if (!result) return NULL;
+size_t guiarstr_rope_utf8_byte_pos(const GuiarStrRope* rope, size_t char_pos) {
+    if (!rope) return 0;
     
-    const char* start = str;
-    const char* ptr = str;
+    const GuiarStrRopeNode* node = rope->root;
+    size_t base = 0;
     
-    while (*ptr) {
-        if (*ptr == '\n' || *ptr == '\r') {
-            size_t len = ptr - start;
-            char* token = malloc(len + 1);
-            if (!token) goto cleanup;
-            
-            memcpy(token, start, len);
-            token[len] = '\0';
-            
-            if (size >= capacity) {
-                capacity *= 2;
-                char** temp = realloc(result, capacity * sizeof(char*));
-                if (!temp) goto cleanup;
-                result = temp;
-            }
-            
-            result[size++] = token;
-            
-            // Handle CRLF
-            if (*ptr == '\r' && *(ptr + 1) == '\n') {
-                ptr++;
+    while (node) {
+        size_t left_chars = guiarstr_rope_total_chars(node->left);
+        if (char_pos < left_chars) {
+            node = node->left;
+            continue;
+        }
+        
+        char_pos -= left_chars;
+        base += guiarstr_rope_total_length(node->left);
+        
+        if (char_pos < node->chars) {
+            for (size_t i = 0; i < node->length; i++) {
+                if (((unsigned char)node->data[i] & 0xC0) != 0x80) {
+                    if (char_pos == 0) {
+                        return base + i;
+                    }
+                    char_pos--;
+                }
             }
-            
-            start = ptr + 1;
         }
-        ptr++;
+        
+        char_pos -= node->chars;
+        base += node->length;
+        node = node->right;
     }
     
-    size_t len = ptr - start;
-    char* token = malloc(len + 1);
-    if (!token) goto cleanup;
-    
-    memcpy(token, start, len);
-    token[len] = '\0';
-    result[size++] = token;
-    
-    *count = size;
-    return result;
-    
-cleanup:
-    for (size_t i = 0; i < size; ++i) free(result[i]);
-    free(result);
-    *count = 0;
-    return NULL;
+    return base;
 }
 
-void guiarstr_split_free(char** tokens, size_t count) {
-    if (!tokens) return;
+GuiarStrError guiarstr_rope_utf8_insert(GuiarStrRope* rope, size_t char_pos, const char* utf8_str) {
+    GUIARSTR_CHECK_NULL(rope);
+    GUIARSTR_CHECK_NULL(utf8_str);
+    
+    if (!guiarstr_utf8_validate(utf8_str)) {
+        return GUIARSTR_ERR_UTF8;
+    }
     
-    for (size_t i = 0; i < count; ++i) free(tokens[i]);
-    free(tokens);
+    return guiarstr_rope_insert(rope, guiarstr_rope_utf8_byte_pos(rope, char_pos), utf8_str);
 }
 
-char* guiarstr_join(char** strings, size_t count, const char* separator) {
-    if (!strings || !separator) return NULL;
-    
-    size_t sep_len = strlen(separator);
-    size_t total_length = 0;
+GuiarStrError guiarstr_rope_utf8_remove(GuiarStrRope* rope, size_t char_pos, size_t char_len) {
+    GUIARSTR_CHECK_NULL(rope);
     
-    for (size_t i = 0; i < count; ++i) {
-        if (strings[i]) {
-            total_length += strlen(strings[i]);
-            if (i < count - 1) total_length += sep_len;
-        }
+    size_t start_byte_pos = guiarstr_rope_utf8_byte_pos(rope, char_pos);
+    size_t end_byte_pos = guiarstr_rope_utf8_byte_pos(rope, char_pos + char_len);
+    if (char_pos + char_len < char_pos) {
+        end_byte_pos = guiarstr_rope_length(rope);
     }
     
-    char* result = malloc(total_length + 1);
-    if (!result) return NULL;
+    return guiarstr_rope_remove(rope, start_byte_pos, end_byte_pos - start_byte_pos);
+}
+
+GuiarStr* guiarstr_rope_substring(const GuiarStrRope* rope, size_t pos, size_t len) {
+    if (!rope) return NULL;
     
-    result[0] = '\0';
+    size_t total = guiarstr_rope_total_length(rope->root);
+    if (pos > total) {
+        pos = total;
+    }
+    if (len > total - pos) {
+        len = total - pos;
+    }
     
-    for (size_t i = 0; i < count; ++i) {
-        if (strings[i]) {
-            strcat(result, strings[i]);
-            if (i < count - 1) strcat(result, separator);
-        }
+    GuiarStr* result = guiarstr_alloc_str(rope->allocator, len + 1);
+    if (!result) {
+        return NULL;
     }
     
+    char* dest = result->data;
+    guiarstr_rope_visit(rope->root, pos, len, guiarstr_rope_copy_visitor, &dest);
+    *dest = '\0';
+    result->length = len;
+    
     return result;
 }
 
-char* guiarstr_join_views(GuiarStrView* views, size_t count, const char* separator) {
-    if (!views || !separator) return NULL;
+GuiarStr* guiarstr_rope_to_str(const GuiarStrRope* rope) {
+    return guiarstr_rope_substring(rope, 0, guiarstr_rope_length(rope));
+}
+
+size_t guiarstr_rope_views(const GuiarStrRope* rope, size_t pos, size_t len, GuiarStrView* views, size_t max_views) {
+    if (!rope) return 0;
     
-    size_t sep_len = strlen(separator);
-    size_t total_length = 0;
+    GuiarStrRopeViewCollector collector;
+    collector.views = views;
+    collector.max_views = max_views;
+    collector.count = 0;
     
-    for (size_t i = 0; i < count; ++i) {
-        total_length += views[i].length;
-        if (i < count - 1) total_length += sep_len;
+    guiarstr_rope_visit(rope->root, pos, len, guiarstr_rope_view_visitor, &collector);
+    return collector.count;
+}
+
+// Gap buffer
+static size_t guiarstr_gap_tail_length(const GuiarStrGap* gap) {
+    return gap->capacity - gap->gap_end;
+}
+
+static GuiarStrError guiarstr_gap_reserve(GuiarStrGap* gap, size_t len) {
+    if (gap->gap_end - gap->gap_start >= len) {
+        return GUIARSTR_OK;
     }
     
-    char* result = malloc(total_length + 1);
-    if (!result) return NULL;
+    size_t length = guiarstr_gap_length(gap);
+    if (len > SIZE_MAX - length) {
+        return GUIARSTR_ERR_OVERFLOW;
+    }
     
-    char* ptr = result;
+    size_t new_capacity;
+    GuiarStrError err = guiarstr_grow_capacity(guiarstr_global_growth_policy, gap->capacity, length + len, &new_capacity);
+    if (err != GUIARSTR_OK) {
+        return err;
+    }
     
-    for (size_t i = 0; i < count; ++i) {
-        memcpy(ptr, views[i].data, views[i].length);
-        ptr += views[i].length;
-        
-        if (i < count - 1) {
-            memcpy(ptr, separator, sep_len);
-            ptr += sep_len;
-        }
+    char* new_data = guiarstr_mem_realloc(gap->allocator, gap->data, gap->capacity, new_capacity);
+    if (!new_data) {
+        return GUIARSTR_ERR_MEMORY;
     }
     
-    *ptr = '\0';
-    return result;
+    // The text after the gap stays at the end of the buffer
+    size_t tail = guiarstr_gap_tail_length(gap);
+    memmove(new_data + new_capacity - tail, new_data + gap->gap_end, tail);
+    
+    gap->data = new_data;
+    gap->gap_end = new_capacity - tail;
+    gap->capacity = new_capacity;
+    return GUIARSTR_OK;
 }
 
-// String builder
-GuiarStrBuilder* guiarstr_builder_create(size_t initial_capacity) {
-    GuiarStrBuilder* builder = malloc(sizeof(GuiarStrBuilder));
-    if (!builder) return NULL;
-    
-    builder->buffer = guiarstr_create_empty(initial_capacity);
-    if (!builder->buffer) {
-        free(builder);
+GuiarStrGap* guiarstr_gap_create(const char* str) {
+    if (!str) {
         return NULL;
     }
     
-    builder->parts_count = 0;
-    builder->parts_capacity = 16;
-    builder->parts = malloc(builder->parts_capacity * sizeof(GuiarStrView));
-    if (!builder->parts) {
-        guiarstr_free(builder->buffer);
-        free(builder);
+    size_t len = strlen(str);
+    GuiarStrGap* gap = guiarstr_gap_create_empty(len);
+    if (!gap) {
         return NULL;
     }
     
-    return builder;
-}
-
-void guiarstr_builder_free(GuiarStrBuilder* builder) {
-    if (!builder) return;
-    
-    guiarstr_free(builder->buffer);
-    free(builder->parts);
-    free(builder);
+    guiarstr_gap_insert_len(gap, str, len);
+    return gap;
 }
 
-GuiarStrError guiarstr_builder_append(GuiarStrBuilder* builder, const char* str) {
-    GUIARSTR_CHECK_NULL(builder);
-    GUIARSTR_CHECK_NULL(str);
+GuiarStrGap* guiarstr_gap_create_empty(size_t initial_capacity) {
+    const GuiarStrAllocator* allocator = guiarstr_resolve_allocator(NULL);
     
-    GuiarStrView view;
-    view.data = str;
-    view.length = strlen(str);
+    if (initial_capacity < GUIARSTR_MIN_CAPACITY) {
+        initial_capacity = GUIARSTR_MIN_CAPACITY;
+    }
     
-    return guiarstr_builder_append_view(builder, &view);
-}
-
-GuiarStrError guiarstr_builder_append_view(GuiarStrBuilder* builder, const GuiarStrView* view) {
-    GUIARSTR_CHECK_NULL(builder);
-    GUIARSTR_CHECK_NULL(view);
+    GuiarStrGap* gap = guiarstr_mem_alloc(allocator, sizeof(GuiarStrGap));
+    if (!gap) {
+        return NULL;
+    }
     
-    // Add to parts array
-    if (builder->parts_count >= builder->parts_capacity) {
-        size_t new_capacity = builder->parts_capacity * 2;
-        GuiarStrView* new_parts = realloc(builder->parts, new_capacity * sizeof(GuiarStrView));
-        if (!new_parts) return GUIARSTR_ERR_MEMORY;
-        
-        builder->parts = new_parts;
-        builder->parts_capacity = new_capacity;
+    gap->data = guiarstr_mem_alloc(allocator, initial_capacity);
+    if (!gap->data) {
+        guiarstr_mem_free(allocator, gap);
+        return NULL;
     }
     
-    builder->parts[builder->parts_count++] = *view;
+    gap->capacity = initial_capacity;
+    gap->gap_start = 0;
+    gap->gap_end = initial_capacity;
+    gap->allocator = allocator;
     
-    // Also append to buffer
-    return guiarstr_append_len(builder->buffer, view->data, view->length);
+    return gap;
 }
 
-GuiarStrError guiarstr_builder_append_char(GuiarStrBuilder* builder, char c) {
-    GUIARSTR_CHECK_NULL(builder);
+void guiarstr_gap_free(GuiarStrGap* gap) {
+    if (!gap) return;
     
-    char str[2] = {c, '\0'};
-    return guiarstr_builder_append(builder, str);
+    guiarstr_mem_free(gap->allocator, gap->data);
+    guiarstr_mem_free(gap->allocator, gap);
 }
 
-GuiarStrError guiarstr_builder_append_fmt(GuiarStrBuilder* builder, const char* fmt, ...) {
-    GUIARSTR_CHECK_NULL(builder);
-    GUIARSTR_CHECK_NULL(fmt);
+size_t guiarstr_gap_length(const GuiarStrGap* gap) {
+    return gap ? gap->capacity - (gap->gap_end - gap->gap_start) : 0;
+}
+
+size_t guiarstr_gap_cursor(const GuiarStrGap* gap) {
+    return gap ? gap->gap_start : 0;
+}
+
+// Only the text between the old and the new cursor moves
+GuiarStrError guiarstr_gap_move_cursor(GuiarStrGap* gap, size_t pos) {
+    GUIARSTR_CHECK_NULL(gap);
     
-    va_list args;
-    va_start(args, fmt);
-    GuiarStrError err = guiarstr_builder_append_fmt_va(builder, fmt, args);
-    va_end(args);
+    size_t length = guiarstr_gap_length(gap);
+    if (pos > length) {
+        pos = length;
+    }
     
-    return err;
+    if (pos < gap->gap_start) {
+        size_t n = gap->gap_start - pos;
+        memmove(gap->data + gap->gap_end - n, gap->data + pos, n);
+        gap->gap_start -= n;
+        gap->gap_end -= n;
+    } else if (pos > gap->gap_start) {
+        size_t n = pos - gap->gap_start;
+        memmove(gap->data + gap->gap_start, gap->data + gap->gap_end, n);
+        gap->gap_start += n;
+        gap->gap_end += n;
+    }
+    
+    return GUIARSTR_OK;
 }
 
-GuiarStrError guiarstr_builder_append_fmt_va(GuiarStrBuilder* builder, const char* fmt, va_list args) {
-    GUIARSTR_CHECK_NULL(builder);
-    GUIARSTR_CHECK_NULL(fmt);
-    
-    // First, determine how much space we need
-    va_list args_copy;
-    va_copy(args_copy, args);
-    int needed = vsnprintf(NULL, 0, fmt, args_copy);
-    va_end(args_copy);
+GuiarStrError guiarstr_gap_insert(GuiarStrGap* gap, const char* str) {
+    GUIARSTR_CHECK_NULL(str);
     
-    if (needed < 0) {
-        return GUIARSTR_ERR_INVALID;
+    return guiarstr_gap_insert_len(gap, str, strlen(str));
+}
+
+GuiarStrError guiarstr_gap_insert_len(GuiarStrGap* gap, const char* str, size_t len) {
+    GUIARSTR_CHECK_NULL(gap);
+    if (!str && len > 0) {
+        return GUIARSTR_ERR_NULL;
     }
     
-    // Ensure we have enough space
-    GuiarStrError err = guiarstr_ensure_capacity(builder->buffer, builder->buffer->length + needed + 1);
+    GuiarStrError err = guiarstr_gap_reserve(gap, len);
     if (err != GUIARSTR_OK) {
         return err;
     }
     
-    // Format directly into the buffer
-    int written = vsnprintf(builder->buffer->data + builder->buffer->length, 
-                           builder->buffer->capacity - builder->buffer->length, 
-                           fmt, args);
+    memcpy(gap->data + gap->gap_start, str, len);
+    gap->gap_start += len;
+    return GUIARSTR_OK;
+}
+
+GuiarStrError guiarstr_gap_insert_char(GuiarStrGap* gap, char c) {
+    return guiarstr_gap_insert_len(gap, &c, 1);
+}
+
+// Backspace: removes up to len bytes before the cursor
+GuiarStrError guiarstr_gap_delete_before(GuiarStrGap* gap, size_t len) {
+    GUIARSTR_CHECK_NULL(gap);
     
-    if (written < 0) {
-        return GUIARSTR_ERR_INVALID;
+    if (len > gap->gap_start) {
+        len = gap->gap_start;
     }
     
-    builder->buffer->length += written;
-    
-    // Add to parts array
-    GuiarStrView view;
-    view.data = builder->buffer->data + builder->buffer->length - written;
-    view.length = written;
+    gap->gap_start -= len;
+    return GUIARSTR_OK;
+}
+
+// Delete: removes up to len bytes after the cursor
+GuiarStrError guiarstr_gap_delete_after(GuiarStrGap* gap, size_t len) {
+    GUIARSTR_CHECK_NULL(gap);
     
-    if (builder->parts_count >= builder->parts_capacity) {
-        size_t new_capacity = builder->parts_capacity * 2;
-        GuiarStrView* new_parts = realloc(builder->parts, new_capacity * sizeof(GuiarStrView));
-        if (!new_parts) return GUIARSTR_ERR_MEMORY;
-        
-        builder->parts = new_parts;
-        builder->parts_capacity = new_capacity;
+    size_t tail = guiarstr_gap_tail_length(gap);
+    if (len > tail) {
+        len = tail;
     }
     
-    builder->parts[builder->parts_count++] = view;
-    
+    gap->gap_end += len;
     return GUIARSTR_OK;
 }
 
-GuiarStr* guiarstr_builder_build(GuiarStrBuilder* builder) {
-    if (!builder) return NULL;
+size_t guiarstr_gap_views(const GuiarStrGap* gap, GuiarStrView views[2]) {
+    if (!gap || !views) return 0;
     
-    return guiarstr_copy(builder->buffer);
-}
-
-GuiarStrError guiarstr_builder_reset(GuiarStrBuilder* builder) {
-    GUIARSTR_CHECK_NULL(builder);
+    size_t count = 0;
+    if (gap->gap_start > 0) {
+        views[count].data = gap->data;
+        views[count].length = gap->gap_start;
+        count++;
+    }
     
-    GuiarStrError err = guiarstr_clear(builder->buffer);
-    if (err != GUIARSTR_OK) {
-        return err;
+    size_t tail = guiarstr_gap_tail_length(gap);
+    if (tail > 0) {
+        views[count].data = gap->data + gap->gap_end;
+        views[count].length = tail;
+        count++;
     }
     
-    builder->parts_count = 0;
-    return GUIARSTR_OK;
+    return count;
 }
 
-// Formatting
-char* guiarstr_printf(const char* fmt, ...) {
-    if (!fmt) return NULL;
+static char guiarstr_gap_at(const GuiarStrGap* gap, size_t pos) {
+    return pos < gap->gap_start ? gap->data[pos] : gap->data[pos + (gap->gap_end - gap->gap_start)];
+}
+
+// Searches both segments in place; only matches straddling the gap are compared bytewise
+size_t guiarstr_gap_find(const GuiarStrGap* gap, const char* substr) {
+    if (!gap || !substr) return (size_t)-1;
     
-    va_list args;
-    va_start(args, fmt);
+    size_t needle_len = strlen(substr);
+    size_t head = gap->gap_start;
+    size_t length = guiarstr_gap_length(gap);
     
-    // First, determine how much space we need
-    va_list args_copy;
-    va_copy(args_copy, args);
-    int needed = vsnprintf(NULL, 0, fmt, args_copy);
-    va_end(args_copy);
+    const char* found = guiarstr_memmem(gap->data, head, substr, needle_len);
+    if (found) {
+        return (size_t)(found - gap->data);
+    }
     
-    if (needed < 0) {
-        va_end(args);
-        return NULL;
+    if (needle_len == 0 || needle_len > length) {
+        return needle_len == 0 ? 0 : (size_t)-1;
     }
     
-    // Allocate the buffer
-    char* result = malloc(needed + 1);
-    if (!result) {
-        va_end(args);
-        return NULL;
+    size_t start = head >= needle_len - 1 ? head - (needle_len - 1) : 0;
+    for (size_t pos = start; pos < head && pos + needle_len <= length; pos++) {
+        size_t i = 0;
+        while (i < needle_len && guiarstr_gap_at(gap, pos + i) == substr[i]) {
+            i++;
+        }
+        if (i == needle_len) {
+            return pos;
+        }
     }
     
-    // Format the string
-    int written = vsnprintf(result, needed + 1, fmt, args);
-    va_end(args);
+    found = guiarstr_memmem(gap->data + gap->gap_end, guiarstr_gap_tail_length(gap), substr, needle_len);
+    return found ? head + (size_t)(found - (gap->data + gap->gap_end)) : (size_t)-1;
+}
+
+GuiarStr* guiarstr_gap_to_str(const GuiarStrGap* gap) {
+    if (!gap) return NULL;
     
-    if (written < 0) {
-        free(result);
+    size_t tail = guiarstr_gap_tail_length(gap);
+    GuiarStr* result = guiarstr_alloc_str(gap->allocator, gap->gap_start + tail + 1);
+    if (!result) {
         return NULL;
     }
     
+    memcpy(result->data, gap->data, gap->gap_start);
+    memcpy(result->data + gap->gap_start, gap->data + gap->gap_end, tail);
+    result->length = gap->gap_start + tail;
+    result->data[result->length] = '\0';
+    
     return result;
 }
 
-char* guiarstr_vprintf(const char* fmt, va_list args) {
+// Formatting
+static char* guiarstr_vprintf_impl(const GuiarStrAllocator* allocator, const char* fmt, va_list args) {
     if (!fmt) return NULL;
     
     // First, determine how much space we need
@@ -1188,7 +6073,7 @@ char* guiarstr_vprintf(const char* fmt, va_list args) {
     }
     
     // Allocate the buffer
-    char* result = malloc(needed + 1);
+    char* result = guiarstr_mem_alloc(allocator, needed + 1);
     if (!result) {
         return NULL;
     }
@@ -1197,13 +6082,45 @@ char* guiarstr_vprintf(const char* fmt, va_list args) {
     int written = vsnprintf(result, needed + 1, fmt, args);
     
     if (written < 0) {
-        free(result);
+        guiarstr_mem_free(allocator, result);
         return NULL;
     }
     
     return result;
 }
 
+char* guiarstr_printf(const char* fmt, ...) {
+    if (!fmt) return NULL;
+    
+    va_list args;
+    va_start(args, fmt);
+    char* result = guiarstr_vprintf_impl(NULL, fmt, args);
+    va_end(args);
+    
+    return result;
+}
+
+char* guiarstr_vprintf(const char* fmt, va_list args) {
+    return guiarstr_vprintf_impl(NULL, fmt, args);
+}
+
+char* guiarstr_printf_arena(GuiarStrArena* arena, const char* fmt, ...) {
+    if (!arena || !fmt) return NULL;
+    
+    va_list args;
+    va_start(args, fmt);
+    char* result = guiarstr_vprintf_impl(&arena->allocator, fmt, args);
+    va_end(args);
+    
+    return result;
+}
+
+char* guiarstr_vprintf_arena(GuiarStrArena* arena, const char* fmt, va_list args) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    
+    return guiarstr_vprintf_impl(&arena->allocator, fmt, args);
+}
+
 GuiarStrError guiarstr_append_printf(GuiarStr* str, const char* fmt, ...) {
     GUIARSTR_CHECK_NULL(str);
     GUIARSTR_CHECK_NULL(fmt);
@@ -1266,16 +6183,12 @@ size_t guiarstr_utf8_len(const char* str) {
 size_t guiarstr_utf8_char_len(const char* str, size_t byte_pos) {
     if (!str) return 0;
     
-    size_t str_len = strlen(str);
-    if (byte_pos >= str_len) return 0;
-    
-    unsigned char c = (unsigned char)str[byte_pos];
-    if ((c & 0x80) == 0x00) return 1;      // 0xxxxxxx
-    if ((c & 0xE0) == 0xC0) return 2;      // 110xxxxx
-    if ((c & 0xF0) == 0xE0) return 3;      // 1110xxxx
-    if ((c & 0xF8) == 0xF0) return 4;      // 11110xxx
+    // Only the bytes up to byte_pos need to be inside the string
+    for (size_t i = 0; i <= byte_pos; i++) {
+        if (!str[i]) return 0;
+    }
     
-    return 1; // Invalid UTF-8, treat as single byte
+    return guiarstr_utf8_lead_len((unsigned char)str[byte_pos]);
 }
 
 size_t guiarstr_utf8_byte_pos(const char* str, size_t char_pos) {
@@ -1285,11 +6198,10 @@ size_t guiarstr_utf8_byte_pos(const char* str, size_t char_pos) {
     size_t current_char = 0;
     
     while (str[byte_pos]) {
-        if (current_char == char_pos) {
-            return byte_pos;
-        }
-        
         if ((str[byte_pos] & 0xC0) != 0x80) {
+            if (current_char == char_pos) {
+                return byte_pos;
+            }
             current_char++;
         }
         
@@ -1303,27 +6215,27 @@ GuiarStrError guiarstr_utf8_append(GuiarStr* str, const char* utf8_str) {
     GUIARSTR_CHECK_NULL(str);
     GUIARSTR_CHECK_NULL(utf8_str);
     
-    // Validate UTF-8
-    if (!guiarstr_utf8_validate(utf8_str)) {
+    size_t len = strlen(utf8_str);
+    if (guiarstr_utf8_error((const unsigned char*)utf8_str, len) != (size_t)-1) {
         return GUIARSTR_ERR_UTF8;
     }
     
-    return guiarstr_append(str, utf8_str);
+    return guiarstr_append_len(str, utf8_str, len);
 }
 
 GuiarStrError guiarstr_utf8_insert(GuiarStr* str, size_t char_pos, const char* utf8_str) {
     GUIARSTR_CHECK_NULL(str);
     GUIARSTR_CHECK_NULL(utf8_str);
     
-    // Validate UTF-8
-    if (!guiarstr_utf8_validate(utf8_str)) {
+    size_t len = strlen(utf8_str);
+    if (guiarstr_utf8_error((const unsigned char*)utf8_str, len) != (size_t)-1) {
         return GUIARSTR_ERR_UTF8;
     }
     
     // Convert character position to byte position
     size_t byte_pos = guiarstr_utf8_byte_pos(str->data, char_pos);
     
-    return guiarstr_insert(str, byte_pos, utf8_str);
+    return guiarstr_insert_len(str, byte_pos, utf8_str, len);
 }
 
 GuiarStrError guiarstr_utf8_remove(GuiarStr* str, size_t char_pos, size_t char_len) {
@@ -1345,7 +6257,7 @@ char* guiarstr_utf8_substring(const char* str, size_t char_pos, size_t char_len)
     
     // Extract the substring
     size_t len = end_byte_pos - start_byte_pos;
-    char* result = malloc(len + 1);
+    char* result = guiarstr_mem_alloc(NULL, len + 1);
     if (!result) return NULL;
     
     memcpy(result, str + start_byte_pos, len);
@@ -1357,13 +6269,12 @@ char* guiarstr_utf8_substring(const char* str, size_t char_pos, size_t char_len)
 char* guiarstr_utf8_reverse(const char* str) {
     if (!str) return NULL;
     
-    // Validate UTF-8
-    if (!guiarstr_utf8_validate(str)) {
+    size_t len = strlen(str);
+    if (guiarstr_utf8_error((const unsigned char*)str, len) != (size_t)-1) {
         return NULL;
     }
     
-    size_t len = strlen(str);
-    char* reversed = malloc(len + 1);
+    char* reversed = guiarstr_mem_alloc(NULL, len + 1);
     if (!reversed) return NULL;
     
     const char* p = str + len;
@@ -1386,31 +6297,13 @@ char* guiarstr_utf8_reverse(const char* str) {
 bool guiarstr_utf8_validate(const char* str) {
     if (!str) return false;
     
-    for (; *str; ) {
-        unsigned char c = (unsigned char)*str;
-        
-        if ((c & 0x80) == 0x00) {
-            // ASCII character
-            str++;
-        } else if ((c & 0xE0) == 0xC0) {
-            // 2-byte sequence
-            if ((str[1] & 0xC0) != 0x80) return false;
-            str += 2;
-        } else if ((c & 0xF0) == 0xE0) {
-            // 3-byte sequence
-            if ((str[1] & 0xC0) != 0x80 || (str[2] & 0xC0) != 0x80) return false;
-            str += 3;
-        } else if ((c & 0xF8) == 0xF0) {
-            // 4-byte sequence
-            if ((str[1] & 0xC0) != 0x80 || (str[2] & 0xC0) != 0x80 || (str[3] & 0xC0) != 0x80) return false;
-            str += 4;
-        } else {
-            // Invalid UTF-8
-            return false;
-        }
-    }
+    return guiarstr_utf8_error((const unsigned char*)str, strlen(str)) == (size_t)-1;
+}
+
+size_t guiarstr_utf8_error_offset(const char* data, size_t len) {
+    if (!data) return len ? 0 : (size_t)-1;
     
-    return true;
+    return guiarstr_utf8_error((const unsigned char*)data, len);
 }
 
 size_t guiarstr_utf8_width(const char* str) {
@@ -1603,82 +6496,97 @@ double guiarstr_to_double(const char* str, bool* success) {
     return val;
 }
 
-char* guiarstr_from_int(int value) {
-    char* result = malloc(12); // Enough for 32-bit int
+static char* guiarstr_format_fixed(const GuiarStrAllocator* allocator, size_t size, const char* fmt, ...) {
+    char* result = guiarstr_mem_alloc(allocator, size);
     if (!result) return NULL;
     
-    snprintf(result, 12, "%d", value);
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(result, size, fmt, args);
+    va_end(args);
+    
     return result;
 }
 
-char* guiarstr_from_long(long value) {
-    char* result = malloc(24); // Enough for 64-bit long
-    if (!result) return NULL;
+static int guiarstr_float_buf_size(double value, int precision) {
+    // Calculate required buffer size
+    long long int_part = (long long)value;
+    int int_digits = 1;
+    while (int_part /= 10) int_digits++;
     
-    snprintf(result, 24, "%ld", value);
-    return result;
+    return int_digits + precision + 3; // sign, decimal point, null terminator
+}
+
+char* guiarstr_from_int(int value) {
+    return guiarstr_format_fixed(NULL, 12, "%d", value); // Enough for 32-bit int
+}
+
+char* guiarstr_from_long(long value) {
+    return guiarstr_format_fixed(NULL, 24, "%ld", value); // Enough for 64-bit long
 }
 
 char* guiarstr_from_long_long(long long value) {
-    char* result = malloc(24); // Enough for 64-bit long long
-    if (!result) return NULL;
-    
-    snprintf(result, 24, "%lld", value);
-    return result;
+    return guiarstr_format_fixed(NULL, 24, "%lld", value); // Enough for 64-bit long long
 }
 
 char* guiarstr_from_uint(unsigned int value) {
-    char* result = malloc(12); // Enough for 32-bit uint
-    if (!result) return NULL;
-    
-    snprintf(result, 12, "%u", value);
-    return result;
+    return guiarstr_format_fixed(NULL, 12, "%u", value); // Enough for 32-bit uint
 }
 
 char* guiarstr_from_ulong(unsigned long value) {
-    char* result = malloc(24); // Enough for 64-bit ulong
-    if (!result) return NULL;
-    
-    snprintf(result, 24, "%lu", value);
-    return result;
+    return guiarstr_format_fixed(NULL, 24, "%lu", value); // Enough for 64-bit ulong
 }
 
 char* guiarstr_from_ulong_long(unsigned long long value) {
-    char* result = malloc(24); // Enough for 64-bit ulong long
-    if (!result) return NULL;
-    
-    snprintf(result, 24, "%llu", value);
-    return result;
+    return guiarstr_format_fixed(NULL, 24, "%llu", value); // Enough for 64-bit ulong long
 }
 
 char* guiarstr_from_float(float value, int precision) {
-    // Calculate required buffer size
-    int int_part = (int)value;
-    int int_digits = 1;
-    while (int_part /= 10) int_digits++;
-    
-    int buf_size = int_digits + precision + 3; // sign, decimal point, null terminator
-    
-    char* result = malloc(buf_size);
-    if (!result) return NULL;
-    
-    snprintf(result, buf_size, "%.*f", precision, value);
-    return result;
+    return guiarstr_format_fixed(NULL, guiarstr_float_buf_size(value, precision), "%.*f", precision, value);
 }
 
 char* guiarstr_from_double(double value, int precision) {
-    // Calculate required buffer size
-    long long int_part = (long long)value;
-    int int_digits = 1;
-    while (int_part /= 10) int_digits++;
-    
-    int buf_size = int_digits + precision + 3; // sign, decimal point, null terminator
-    
-    char* result = malloc(buf_size);
-    if (!result) return NULL;
-    
-    snprintf(result, buf_size, "%.*f", precision, value);
-    return result;
+    return guiarstr_format_fixed(NULL, guiarstr_float_buf_size(value, precision), "%.*f", precision, value);
+}
+
+char* guiarstr_from_int_arena(GuiarStrArena* arena, int value) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    return guiarstr_format_fixed(&arena->allocator, 12, "%d", value);
+}
+
+char* guiarstr_from_long_arena(GuiarStrArena* arena, long value) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    return guiarstr_format_fixed(&arena->allocator, 24, "%ld", value);
+}
+
+char* guiarstr_from_long_long_arena(GuiarStrArena* arena, long long value) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    return guiarstr_format_fixed(&arena->allocator, 24, "%lld", value);
+}
+
+char* guiarstr_from_uint_arena(GuiarStrArena* arena, unsigned int value) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    return guiarstr_format_fixed(&arena->allocator, 12, "%u", value);
+}
+
+char* guiarstr_from_ulong_arena(GuiarStrArena* arena, unsigned long value) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    return guiarstr_format_fixed(&arena->allocator, 24, "%lu", value);
+}
+
+char* guiarstr_from_ulong_long_arena(GuiarStrArena* arena, unsigned long long value) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    return guiarstr_format_fixed(&arena->allocator, 24, "%llu", value);
+}
+
+char* guiarstr_from_float_arena(GuiarStrArena* arena, float value, int precision) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    return guiarstr_format_fixed(&arena->allocator, guiarstr_float_buf_size(value, precision), "%.*f", precision, value);
+}
+
+char* guiarstr_from_double_arena(GuiarStrArena* arena, double value, int precision) {
+    GUIARSTR_CHECK_NULL_RET_NULL(arena);
+    return guiarstr_format_fixed(&arena->allocator, guiarstr_float_buf_size(value, precision), "%.*f", precision, value);
 }
 
 // File operations
@@ -1695,18 +6603,25 @@ GuiarStr* guiarstr_read_file(const char* filename, GuiarStrError* error) {
     }
     
     // Get file size
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    long file_size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        file_size = ftell(file);
+    }
     
-    if (file_size < 0) {
+    if (file_size < 0 || fseek(file, 0, SEEK_SET) != 0) {
         fclose(file);
         if (error) *error = GUIARSTR_ERR_INVALID;
         return NULL;
     }
     
-    // Create string with capacity to hold the file
-    GuiarStr* result = guiarstr_create_empty(file_size);
+    if ((unsigned long)file_size >= SIZE_MAX) {
+        fclose(file);
+        if (error) *error = GUIARSTR_ERR_OVERFLOW;
+        return NULL;
+    }
+    
+    // Create string with capacity to hold the file and its terminator
+    GuiarStr* result = guiarstr_create_empty((size_t)file_size + 1);
     if (!result) {
         fclose(file);
         if (error) *error = GUIARSTR_ERR_MEMORY;
@@ -1771,6 +6686,15 @@ GuiarStrError guiarstr_write_file_view(const char* filename, const GuiarStrView*
     return GUIARSTR_OK;
 }
 
+GuiarStrError guiarstr_write_file_str(const char* filename, const GuiarStr* str, bool append) {
+    if (!str) {
+        return GUIARSTR_ERR_NULL;
+    }
+    
+    GuiarStrView view = guiarstr_view_from_str(str);
+    return guiarstr_write_file_view(filename, &view, append);
+}
+
 // Error handling
 const char* guiarstr_error_message(GuiarStrError error) {
     if (error < 0 || error >= sizeof(error_messages) / sizeof(error_messages[0])) {
@@ -28,6 +28,11 @@
 #include <math.h>
 #include "../include/guiarstr.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define HAVE_PTHREAD 1
+#endif
+
 // === Colors and symbols ===
 #define GREEN   "\033[1;32m"
 #define RED     "\033[1;31m"
@@ -90,6 +95,73 @@
         } \
     } while (0)
 
+// Allocator that counts calls, used by the allocator hook tests
+typedef struct {
+    size_t allocs;
+    size_t reallocs;
+    size_t frees;
+} CountingAllocatorState;
+
+static void* counting_alloc(void* ctx, size_t size) {
+    ((CountingAllocatorState*)ctx)->allocs++;
+    return malloc(size);
+}
+
+static void* counting_realloc(void* ctx, void* ptr, size_t old_size, size_t new_size) {
+    (void)old_size;
+    ((CountingAllocatorState*)ctx)->reallocs++;
+    return realloc(ptr, new_size);
+}
+
+static void counting_free(void* ctx, void* ptr) {
+    if (ptr) ((CountingAllocatorState*)ctx)->frees++;
+    free(ptr);
+}
+
+// Decodes each sequence and checks the code point, independently of the library's byte ranges
+static size_t utf8_reference_error(const unsigned char* s, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        unsigned char c = s[i];
+        size_t n;
+        unsigned long cp;
+        if (c < 0x80) {
+            i++;
+            continue;
+        } else if ((c & 0xE0) == 0xC0) {
+            n = 1;
+            cp = c & 0x1F;
+        } else if ((c & 0xF0) == 0xE0) {
+            n = 2;
+            cp = c & 0x0F;
+        } else if ((c & 0xF8) == 0xF0) {
+            n = 3;
+            cp = c & 0x07;
+        } else {
+            return i;
+        }
+        
+        if (i + n >= len) return i;
+        for (size_t k = 1; k <= n; k++) {
+            if ((s[i + k] & 0xC0) != 0x80) return i;
+            cp = cp << 6 | (s[i + k] & 0x3F);
+        }
+        if ((n == 1 && cp < 0x80) || (n == 2 && cp < 0x800) || (n == 3 && cp < 0x10000) ||
+            cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+            return i;
+        }
+        i += n + 1;
+    }
+    return (size_t)-1;
+}
+
+#ifdef HAVE_PTHREAD
+static void* pool_free_worker(void* arg) {
+    guiarstr_free((GuiarStr*)arg);
+    return NULL;
+}
+#endif
+
 int main(void) {
     printf("\n==================== GuiarStr Test Suite ====================\n");
     
@@ -100,6 +172,9 @@ int main(void) {
     char trim2[] = "   ";
     ASSERT_EQ_STR(guiarstr_trim(trim2), "");
     
+    char trim3[] = "\t\v\f\r\n caf\xC3\xA9\xC2\xA0 \n";
+    ASSERT_EQ_STR(guiarstr_trim(trim3), "caf\xC3\xA9\xC2\xA0");
+    
     SECTION("Strip Tests");
     char strip1[] = "***hello***";
     ASSERT_EQ_STR(guiarstr_strip(strip1, "*"), "hello");
@@ -119,6 +194,35 @@ int main(void) {
     guiarstr_toupper(upper);
     ASSERT_EQ_STR(upper, "GUIARSTR");
     
+    char header[] = "Content-Type: Text/HTML; charset=UTF-8 @[`{ \xC3\x89T\xC3\x89 X-Request-ID: ABC-123";
+    guiarstr_tolower(header);
+    ASSERT_EQ_STR(header, "content-type: text/html; charset=utf-8 @[`{ \xC3\x89t\xC3\x89 x-request-id: abc-123");
+    guiarstr_toupper(header);
+    ASSERT_EQ_STR(header, "CONTENT-TYPE: TEXT/HTML; CHARSET=UTF-8 @[`{ \xC3\x89T\xC3\x89 X-REQUEST-ID: ABC-123");
+    
+    // Every byte value at every offset, so each SIMD block width and the scalar tail see all of them
+    char case_bytes[300];
+    bool case_ok = true;
+    for (size_t shift = 0; shift < 40 && case_ok; shift++) {
+        for (size_t k = 0; k < 300; k++) {
+            case_bytes[k] = (char)(k + shift);
+        }
+        guiarstr_tolower_len(case_bytes + shift, 300 - shift);
+        for (size_t k = 0; k < shift; k++) {
+            case_ok = case_ok && case_bytes[k] == (char)(k + shift);
+        }
+        for (size_t k = shift; k < 300; k++) {
+            unsigned char c = (unsigned char)(k + shift);
+            case_ok = case_ok && (unsigned char)case_bytes[k] == (c >= 'A' && c <= 'Z' ? c + 32 : c);
+        }
+        guiarstr_toupper_len(case_bytes + shift, 300 - shift);
+        for (size_t k = shift; k < 300; k++) {
+            unsigned char c = (unsigned char)(k + shift);
+            case_ok = case_ok && (unsigned char)case_bytes[k] == (c >= 'a' && c <= 'z' ? c - 32 : c);
+        }
+    }
+    ASSERT_TRUE(case_ok);
+    
     SECTION("Split Tests");
     size_t count;
     char** parts = guiarstr_split("one,two,three", ',', &count);
@@ -159,6 +263,95 @@ int main(void) {
     ASSERT_EQ_STR(joined, "C is fun");
     free(joined);
     
+    SECTION("Zero-copy Split Tests");
+    const char* csv = "one,two,,three";
+    GuiarStrView views[8];
+    ASSERT_EQ_SIZE(guiarstr_split_view(csv, ',', views, 8), 4);
+    ASSERT_TRUE(views[0].data == csv && views[0].length == 3);
+    ASSERT_EQ_SIZE(views[2].length, 0);
+    ASSERT_TRUE(strncmp(views[3].data, "three", views[3].length) == 0);
+    ASSERT_EQ_SIZE(guiarstr_split_view(csv, ',', NULL, 0), 4);
+    ASSERT_EQ_SIZE(guiarstr_split_view(csv, ',', views, 2), 4);
+    
+    ASSERT_EQ_SIZE(guiarstr_split_str_view("oneXYZtwoXYZthree", "XYZ", views, 8), 3);
+    ASSERT_EQ_SIZE(views[1].length, 3);
+    ASSERT_EQ_SIZE(guiarstr_split_str_view("abc", "", views, 8), 3);
+    ASSERT_EQ_SIZE(guiarstr_split_any_view("one,two;three|four", ",;|", views, 8), 4);
+    ASSERT_EQ_SIZE(views[3].length, 4);
+    
+    size_t view_count;
+    GuiarStrView* lines_view = guiarstr_split_lines_view_alloc("line1\nline2\r\nline3\r", &view_count);
+    ASSERT_TRUE(lines_view != NULL);
+    ASSERT_EQ_SIZE(view_count, 4);
+    ASSERT_EQ_SIZE(lines_view[1].length, 5);
+    ASSERT_EQ_SIZE(lines_view[3].length, 0);
+    char* joined_views = guiarstr_join_views(lines_view, view_count, "|");
+    ASSERT_EQ_STR(joined_views, "line1|line2|line3|");
+    free(joined_views);
+    guiarstr_split_view_free(lines_view);
+    
+    SECTION("String View Tests");
+    // A slice in the middle of a buffer, not NUL-terminated
+    const char* view_buf = "  key = value; other  ";
+    GuiarStrView line = guiarstr_view_slice(guiarstr_view_from_cstr(view_buf), 2, 12);
+    ASSERT_EQ_SIZE(line.length, 12);
+    ASSERT_TRUE(guiarstr_view_equals(line, guiarstr_view_from_cstr("key = value;")));
+    ASSERT_EQ_SIZE(guiarstr_view_find(line, guiarstr_view_from_cstr("value")), 6);
+    ASSERT_EQ_SIZE(guiarstr_view_find(line, guiarstr_view_from_cstr("other")), (size_t)-1);
+    ASSERT_EQ_SIZE(guiarstr_view_rfind_char(line, 'e'), 10);
+    ASSERT_EQ_SIZE(guiarstr_view_find_any(line, guiarstr_view_from_cstr("=;")), 4);
+    ASSERT_TRUE(guiarstr_view_endswith(line, guiarstr_view_from_cstr(";")));
+    ASSERT_FALSE(guiarstr_view_endswith(line, guiarstr_view_from_cstr("other")));
+    GuiarStrView stripped = guiarstr_view_strip(line, guiarstr_view_from_cstr("k;"));
+    ASSERT_TRUE(guiarstr_view_equals(stripped, guiarstr_view_from_cstr("ey = value")));
+    GuiarStrView kv[2];
+    ASSERT_EQ_SIZE(guiarstr_view_split(line, '=', kv, 2), 2);
+    ASSERT_TRUE(guiarstr_view_equals(guiarstr_view_trim(kv[0]), guiarstr_view_from_cstr("key")));
+    ASSERT_TRUE(guiarstr_view_compare(kv[0], kv[1]) > 0);
+    ASSERT_EQ_SIZE(guiarstr_view_count(guiarstr_view_from_cstr("abababa"), guiarstr_view_from_cstr("aba")), 2);
+    ASSERT_EQ_SIZE(guiarstr_view_rfind(guiarstr_view_from_cstr("abababa"), guiarstr_view_from_cstr("aba")), 4);
+    GuiarStrView arabic = guiarstr_view_from_cstr("مرحبا بالعالم");
+    ASSERT_EQ_SIZE(guiarstr_view_utf8_len(arabic), 13);
+    ASSERT_TRUE(guiarstr_view_utf8_validate(arabic));
+    ASSERT_FALSE(guiarstr_view_utf8_validate(guiarstr_view_slice(arabic, 0, 3)));
+    ASSERT_FALSE(guiarstr_view_utf8_validate(guiarstr_view_from("\xC0\xAF", 2)));
+    GuiarStrView word = guiarstr_view_utf8_substring(arabic, 6, 7);
+    ASSERT_EQ_SIZE(word.length, 14);
+    ASSERT_EQ_SIZE(guiarstr_view_utf8_char_len(arabic, 0), 2);
+    
+    SECTION("Tokenizer Tests");
+    GuiarStrTokenizer tok;
+    GuiarStrView token;
+    const char* log_line = "GET /index.html HTTP/1.1";
+    ASSERT_EQ_ERR(guiarstr_tokenizer_init(&tok, log_line, strlen(log_line), ' '), GUIARSTR_OK);
+    ASSERT_TRUE(guiarstr_tokenizer_next(&tok, &token));
+    ASSERT_TRUE(token.data == log_line && token.length == 3);
+    ASSERT_TRUE(guiarstr_tokenizer_next(&tok, &token));
+    ASSERT_EQ_SIZE(token.length, 11);
+    ASSERT_TRUE(guiarstr_tokenizer_next(&tok, &token));
+    ASSERT_TRUE(strncmp(token.data, "HTTP/1.1", token.length) == 0);
+    ASSERT_FALSE(guiarstr_tokenizer_next(&tok, &token));
+    guiarstr_tokenizer_reset(&tok);
+    ASSERT_TRUE(guiarstr_tokenizer_next(&tok, &token));
+    ASSERT_EQ_SIZE(token.length, 3);
+    
+    // Length-bounded input: "a::b" out of a larger buffer
+    guiarstr_tokenizer_init_str(&tok, "a::b::c", 4, "::");
+    ASSERT_TRUE(guiarstr_tokenizer_next(&tok, &token));
+    ASSERT_TRUE(guiarstr_tokenizer_next(&tok, &token));
+    ASSERT_TRUE(token.length == 1 && token.data[0] == 'b');
+    ASSERT_FALSE(guiarstr_tokenizer_next(&tok, &token));
+    
+    guiarstr_tokenizer_init_any(&tok, "k=v;x", 5, "=;");
+    size_t any_tokens = 0;
+    while (guiarstr_tokenizer_next(&tok, &token)) any_tokens++;
+    ASSERT_EQ_SIZE(any_tokens, 3);
+    
+    guiarstr_tokenizer_init_lines(&tok, "a\r\nb\rc\n", 7);
+    size_t line_tokens = 0;
+    while (guiarstr_tokenizer_next(&tok, &token)) line_tokens++;
+    ASSERT_EQ_SIZE(line_tokens, 4);
+    
     SECTION("Replace Tests");
     char* replaced = guiarstr_replace("the cat sat on the mat", "the", "a");
     ASSERT_EQ_STR(replaced, "a cat sat on a mat");
@@ -168,6 +361,12 @@ int main(void) {
     char* replaced2 = guiarstr_replace_n("the cat sat on the mat", "the", "a", 1);
     ASSERT_EQ_STR(replaced2, "a cat sat on the mat");
     free(replaced2);
+    replaced2 = guiarstr_replace_n("aaaaa", "aa", "xyz", 5);
+    ASSERT_EQ_STR(replaced2, "xyzxyza");
+    free(replaced2);
+    replaced2 = guiarstr_replace("<br/><br/>text<br/>", "<br/>", "");
+    ASSERT_EQ_STR(replaced2, "text");
+    free(replaced2);
     
     // Replace character
     char* replaced3 = guiarstr_replace_char("hello world", 'l', 'x');
@@ -208,6 +407,84 @@ int main(void) {
     SECTION("Case-insensitive Tests");
     ASSERT_TRUE(guiarstr_startswithi("GuiarStr", "guiar"));
     ASSERT_TRUE(guiarstr_endswithi("GuiarStr", "str"));
+    ASSERT_FALSE(guiarstr_startswithi("Guiar", "guiarstr"));
+    ASSERT_FALSE(guiarstr_startswithi("@", "`"));
+    ASSERT_FALSE(guiarstr_endswithi("[x]", "{X}"));
+    ASSERT_TRUE(guiarstr_startswithi("ACCEPT-ENCODING: GZIP, DEFLATE, BR; Q=0.9", "accept-encoding: gzip, deflate, br;"));
+    ASSERT_FALSE(guiarstr_startswithi("ACCEPT-ENCODING: GZIP, DEFLATE, BR; Q=0.9", "accept-encoding: gzip, deflate, bz;"));
+    ASSERT_TRUE(guiarstr_endswithi("x-forwarded-for: 10.0.0.1, 10.0.0.2, PROXY.EXAMPLE", "10.0.0.1, 10.0.0.2, proxy.example"));
+    ASSERT_FALSE(guiarstr_endswithi("x-forwarded-for: 10.0.0.1, 10.0.0.2, PROXY.EXAMPLE", "10.0.0.1, 10.0.0.2, proxy.exampld"));
+    ASSERT_TRUE(guiarstr_view_equalsi(guiarstr_view_from("Host\0X", 6), guiarstr_view_from("hOST\0x", 6)));
+    ASSERT_FALSE(guiarstr_view_equalsi(guiarstr_view_from_cstr("\xC3\x89"), guiarstr_view_from_cstr("\xC3\xA9")));
+    ASSERT_TRUE(guiarstr_view_startswithi(guiarstr_view_from_cstr("Keep-Alive"), guiarstr_view_from_cstr("KEEP")));
+    ASSERT_TRUE(guiarstr_view_endswithi(guiarstr_view_from_cstr("Keep-Alive"), guiarstr_view_from_cstr("alive")));
+    ASSERT_FALSE(guiarstr_view_endswithi(guiarstr_view_from_cstr("Alive"), guiarstr_view_from_cstr("keep-alive")));
+    
+    const char* icase_headers = "Host: example.org\r\nCONTENT-TYPE: text/plain\r\ncontent-type: x\r\nX-Caf\xC3\xA9: 1\r\n";
+    ASSERT_EQ_SIZE(guiarstr_find_i(icase_headers, "content-type:"), 19);
+    ASSERT_EQ_SIZE(guiarstr_find_from_i(icase_headers, "Content-Type:", 20), 45);
+    ASSERT_EQ_SIZE(guiarstr_rfind_i(icase_headers, "CONTENT-type"), 45);
+    ASSERT_EQ_SIZE(guiarstr_count_i(icase_headers, "Content-Type"), 2);
+    ASSERT_TRUE(guiarstr_contains_i(icase_headers, "x-caf\xC3\xA9"));
+    ASSERT_FALSE(guiarstr_contains_i(icase_headers, "x-caf\xC3\x89"));
+    ASSERT_FALSE(guiarstr_contains_i(icase_headers, "host:`"));
+    ASSERT_EQ_SIZE(guiarstr_find_from_i(icase_headers, "host", 500), (size_t)-1);
+    ASSERT_EQ_SIZE(guiarstr_count_i(icase_headers, ""), 0);
+    char* icase_replaced = guiarstr_replace_i("Bearer abc, BEARER def, bearer", "bearer ", "Token ");
+    ASSERT_EQ_STR(icase_replaced, "Token abc, Token def, bearer");
+    free(icase_replaced);
+    icase_replaced = guiarstr_replace_n_i("aAaA", "a", "<b>", 3);
+    ASSERT_EQ_STR(icase_replaced, "<b><b><b>A");
+    free(icase_replaced);
+    ASSERT_TRUE(guiarstr_replace_i("abc", "", "x") == NULL);
+    GuiarStrView icase_view = guiarstr_view_from("KEY\0key\0Key", 11);
+    ASSERT_EQ_SIZE(guiarstr_view_count_i(icase_view, guiarstr_view_from_cstr("kEy")), 3);
+    ASSERT_EQ_SIZE(guiarstr_view_find_i(icase_view, guiarstr_view_from("y\0k", 3)), 2);
+    ASSERT_EQ_SIZE(guiarstr_view_rfind_i(icase_view, guiarstr_view_from("Y\0K", 3)), 6);
+    ASSERT_TRUE(guiarstr_view_contains_i(icase_view, guiarstr_view_from_cstr("KEY")));
+    
+    // Needles above the stack fold buffer, against a byte-by-byte folded comparison
+    char icase_hay[401];
+    bool icase_ok = true;
+    unsigned int icase_seed = 99;
+    for (size_t round = 0; round < 60 && icase_ok; round++) {
+        for (size_t k = 0; k < 400; k++) {
+            icase_seed = icase_seed * 1103515245u + 12345u;
+            icase_hay[k] = "aAbB@`"[(icase_seed >> 16) % (round % 2 ? 2 : 6)];
+        }
+        icase_hay[400] = '\0';
+        size_t needle_len = 1 + (round * 37) % 200;
+        size_t at = (icase_seed >> 4) % (400 - needle_len + 1);
+        char needle[201];
+        memcpy(needle, icase_hay + at, needle_len);
+        needle[needle_len] = '\0';
+        guiarstr_toupper(needle);
+        
+        size_t expected_first = (size_t)-1;
+        size_t expected_last = (size_t)-1;
+        size_t expected_count = 0;
+        size_t next_free = 0;
+        for (size_t k = 0; k + needle_len <= 400; k++) {
+            bool match = true;
+            for (size_t j = 0; j < needle_len && match; j++) {
+                unsigned char h = (unsigned char)icase_hay[k + j];
+                unsigned char n = (unsigned char)needle[j];
+                match = (h >= 'A' && h <= 'Z' ? h + 32 : h) == (n >= 'A' && n <= 'Z' ? n + 32 : n);
+            }
+            if (!match) continue;
+            if (expected_first == (size_t)-1) expected_first = k;
+            expected_last = k;
+            if (k >= next_free) {
+                expected_count++;
+                next_free = k + needle_len;
+            }
+        }
+        
+        icase_ok = guiarstr_find_i(icase_hay, needle) == expected_first &&
+                   guiarstr_rfind_i(icase_hay, needle) == expected_last &&
+                   guiarstr_count_i(icase_hay, needle) == expected_count;
+    }
+    ASSERT_TRUE(icase_ok);
     
     SECTION("Count Tests");
     ASSERT_EQ_SIZE(guiarstr_count("abababab", "ab"), 4);
@@ -224,6 +501,421 @@ int main(void) {
     ASSERT_EQ_SIZE(guiarstr_rfind_char("hello world", 'l'), 9);
     ASSERT_EQ_SIZE(guiarstr_find_any("hello world", "ow"), 4);
     ASSERT_EQ_SIZE(guiarstr_find_not_any("hello world", "helo "), 6);
+    ASSERT_EQ_SIZE(guiarstr_rfind_from("hello world hello", "hello", 11), 0);
+    ASSERT_EQ_SIZE(guiarstr_rfind_from("hello world hello", "hello", 12), 12);
+    ASSERT_EQ_SIZE(guiarstr_rfind_from("hello", "", 2), 2);
+    ASSERT_EQ_SIZE(guiarstr_rfind_from("hello", "lo", 2), (size_t)-1);
+    ASSERT_EQ_SIZE(guiarstr_rfind_any("src/lib\\guiarstr.c", "/\\"), 7);
+    ASSERT_EQ_SIZE(guiarstr_rfind_any("guiarstr.c", "/\\"), (size_t)-1);
+    // Last path separator on a line longer than the vector blocks
+    char* long_path = guiarstr_printf("/var/log/%s/%s", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+                                      "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb.log");
+    GuiarStrView long_path_view = guiarstr_view_from_cstr(long_path);
+    ASSERT_EQ_SIZE(guiarstr_view_rfind_char(long_path_view, '/'), 75);
+    ASSERT_EQ_SIZE(guiarstr_view_rfind_any(long_path_view, guiarstr_view_from_cstr("/.")), 152);
+    ASSERT_EQ_SIZE(guiarstr_view_rfind_from(long_path_view, guiarstr_view_from_cstr("/"), 74), 8);
+    ASSERT_EQ_SIZE(guiarstr_rfind(long_path, "a/b"), 74);
+    free(long_path);
+    // Cross-check the search engine against strstr across the SIMD block and Horspool cut-offs
+    char search_hay[301];
+    char search_needle[49];
+    char search_needle_long[71];
+    unsigned int search_seed = 777;
+    bool search_ok = true;
+    for (size_t round = 0; round < 400 && search_ok; round++) {
+        size_t hay_len = round % 7 == 0 ? round % 40 : 300;
+        for (size_t k = 0; k < hay_len; k++) {
+            search_seed = search_seed * 1103515245u + 12345u;
+            search_hay[k] = (search_seed >> 16) % 8 ? 'a' : 'b';
+        }
+        search_hay[hay_len] = '\0';
+        size_t needle_len = 1 + round % 48;
+        for (size_t k = 0; k < needle_len; k++) {
+            search_needle[k] = k == needle_len / 2 ? 'b' : 'a';
+        }
+        search_needle[needle_len] = '\0';
+        
+        const char* expected = strstr(search_hay, search_needle);
+        size_t expected_count = 0;
+        for (const char* p = expected; p; p = strstr(p + needle_len, search_needle)) {
+            expected_count++;
+        }
+        size_t from = (search_seed >> 4) % (hay_len + 2);
+        size_t expected_last = (size_t)-1;
+        size_t expected_before = (size_t)-1;
+        for (size_t k = hay_len >= needle_len ? hay_len - needle_len + 1 : 0; k-- > 0;) {
+            if (strncmp(search_hay + k, search_needle, needle_len) != 0) continue;
+            if (expected_last == (size_t)-1) expected_last = k;
+            if (k <= from) {
+                expected_before = k;
+                break;
+            }
+        }
+        search_ok = guiarstr_find(search_hay, search_needle) == (expected ? (size_t)(expected - search_hay) : (size_t)-1) &&
+                    guiarstr_count(search_hay, search_needle) == expected_count &&
+                    guiarstr_rfind(search_hay, search_needle) == expected_last &&
+                    guiarstr_rfind_from(search_hay, search_needle, from) == expected_before;
+    }
+    ASSERT_TRUE(search_ok);
+    // C string scans at every start alignment, across the 64-byte blocks and the long-needle windows
+    char align_buf[640];
+    char align_lower[600];
+    bool align_ok = true;
+    for (size_t round = 0; round < 700 && align_ok; round++) {
+        char* hay = align_buf + round % 64;
+        search_seed = search_seed * 1103515245u + 12345u;
+        size_t hay_len = (search_seed >> 8) % 560;
+        for (size_t k = 0; k < hay_len; k++) {
+            search_seed = search_seed * 1103515245u + 12345u;
+            char c = (search_seed >> 16) % (round % 3 ? 8 : 40) ? 'a' : 'b';
+            hay[k] = (search_seed >> 24) & 1 ? (char)(c - 'a' + 'A') : c;
+            align_lower[k] = c;
+        }
+        hay[hay_len] = align_lower[hay_len] = '\0';
+        size_t needle_len = 1 + round % 70;
+        for (size_t k = 0; k < needle_len; k++) {
+            search_needle_long[k] = k == needle_len / 2 ? 'b' : 'a';
+        }
+        search_needle_long[needle_len] = '\0';
+        
+        const char* expected = strstr(hay, search_needle_long);
+        const char* expected_i = strstr(align_lower, search_needle_long);
+        size_t expected_count = 0;
+        size_t expected_count_i = 0;
+        for (const char* p = expected; p; p = strstr(p + needle_len, search_needle_long)) expected_count++;
+        for (const char* p = expected_i; p; p = strstr(p + needle_len, search_needle_long)) expected_count_i++;
+        
+        align_ok = guiarstr_find(hay, search_needle_long) == (expected ? (size_t)(expected - hay) : (size_t)-1) &&
+                   guiarstr_count(hay, search_needle_long) == expected_count &&
+                   guiarstr_find_i(hay, search_needle_long) == (expected_i ? (size_t)(expected_i - align_lower) : (size_t)-1) &&
+                   guiarstr_count_i(hay, search_needle_long) == expected_count_i &&
+                   guiarstr_view_count(guiarstr_view_from_cstr(hay), guiarstr_view_from_cstr(search_needle_long)) == expected_count;
+    }
+    ASSERT_TRUE(align_ok);
+    // Offsets at or past the terminator, for every start alignment of the string
+    char nul_probe[64];
+    bool nul_ok = true;
+    for (size_t start = 0; start < 16; start++) {
+        for (size_t len = 0; len < 40; len++) {
+            char* probe = nul_probe + start;
+            memset(probe, 'X', len + 1);
+            probe[len] = '\0';
+            nul_ok = nul_ok && guiarstr_find_from(probe, "", len) == len &&
+                     guiarstr_find_from(probe, "X", len + 1) == (size_t)-1 &&
+                     guiarstr_find_from_i(probe, "x", len + 1) == (size_t)-1 &&
+                     guiarstr_find_any_from(probe, "X", len + 1) == (size_t)-1 &&
+                     guiarstr_startswithi(probe, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx") == false &&
+                     guiarstr_startswithi(probe, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx" + (40 - len));
+        }
+    }
+    ASSERT_TRUE(nul_ok);
+    
+    SECTION("Pattern Tests");
+    GuiarStrPattern* pat = guiarstr_pattern_create("needle", 0);
+    ASSERT_TRUE(pat != NULL);
+    GuiarStrView pat_hay = guiarstr_view_from_cstr("needle in a haystack, another needle, needles");
+    ASSERT_EQ_SIZE(guiarstr_pattern_find(pat, pat_hay), 0);
+    ASSERT_EQ_SIZE(guiarstr_pattern_find_from(pat, pat_hay, 1), 30);
+    ASSERT_EQ_SIZE(guiarstr_pattern_rfind(pat, pat_hay), 38);
+    ASSERT_EQ_SIZE(guiarstr_pattern_count(pat, pat_hay), 3);
+    size_t pat_positions[2];
+    ASSERT_EQ_SIZE(guiarstr_pattern_find_all(pat, pat_hay, pat_positions, 2), 3);
+    ASSERT_EQ_SIZE(pat_positions[1], 30);
+    ASSERT_EQ_SIZE(guiarstr_pattern_find(pat, guiarstr_view_from_cstr("haystack")), (size_t)-1);
+    char* pat_replaced = guiarstr_replace_n_pattern("needle, needle, needle", pat, "pin", 2);
+    ASSERT_EQ_STR(pat_replaced, "pin, pin, needle");
+    free(pat_replaced);
+    guiarstr_pattern_free(pat);
+    
+    pat = guiarstr_pattern_create(", ", 0);
+    size_t pat_count;
+    char** pat_parts = guiarstr_split_str_pattern("a, b, c", pat, &pat_count);
+    ASSERT_EQ_SIZE(pat_count, 3);
+    ASSERT_EQ_STR(pat_parts[2], "c");
+    guiarstr_split_free(pat_parts, pat_count);
+    GuiarStrTokenizer pat_tok;
+    GuiarStrView pat_token;
+    guiarstr_tokenizer_init_pattern(&pat_tok, "x, y", 4, pat);
+    ASSERT_TRUE(guiarstr_tokenizer_next(&pat_tok, &pat_token));
+    ASSERT_TRUE(guiarstr_view_equals(pat_token, guiarstr_view_from_cstr("x")));
+    guiarstr_pattern_free(pat);
+    
+    // Case folding applies to ASCII letters only, in the filter and in the byte-pair skips
+    pat = guiarstr_pattern_create("Content-Length:", GUIARSTR_PATTERN_IGNORE_CASE);
+    pat_hay = guiarstr_view_from_cstr("Host: x\r\nCONTENT-LENGTH: 42\r\ncontent-length: 7\r\n");
+    ASSERT_EQ_SIZE(guiarstr_pattern_find(pat, pat_hay), 9);
+    ASSERT_EQ_SIZE(guiarstr_pattern_rfind(pat, pat_hay), 29);
+    ASSERT_EQ_SIZE(guiarstr_pattern_find(pat, guiarstr_view_from_cstr("content_length:")), (size_t)-1);
+    guiarstr_pattern_free(pat);
+    const char* long_needle = "The Quick Brown Fox Jumps Over The Lazy Dog, Then Naps Under The Oak Tree";
+    pat = guiarstr_pattern_create(long_needle, GUIARSTR_PATTERN_IGNORE_CASE);
+    char* long_hay = guiarstr_printf("prefix %s / %s", "the quick brown fox jumps over the lazy dog, then naps under the oak tre",
+                                     "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG, THEN NAPS UNDER THE OAK TREE");
+    ASSERT_EQ_SIZE(guiarstr_pattern_find(pat, guiarstr_view_from_cstr(long_hay)), 82);
+    free(long_hay);
+    guiarstr_pattern_free(pat);
+    
+    // Mixed-case haystacks against strstr on the lowercase original, past the byte-pair cut-off
+    char pattern_lower[301];
+    char pattern_needle[97];
+    bool pattern_ok = true;
+    for (size_t round = 0; round < 200 && pattern_ok; round++) {
+        for (size_t k = 0; k < 300; k++) {
+            search_seed = search_seed * 1103515245u + 12345u;
+            pattern_lower[k] = (search_seed >> 16) % 8 ? 'a' : 'b';
+            search_hay[k] = (search_seed >> 8) & 1 ? (char)(pattern_lower[k] - 32) : pattern_lower[k];
+        }
+        pattern_lower[300] = search_hay[300] = '\0';
+        size_t needle_len = 1 + round % 96;
+        for (size_t k = 0; k < needle_len; k++) {
+            pattern_needle[k] = k == needle_len / 3 ? 'b' : (k % 5 ? 'a' : 'A');
+        }
+        pattern_needle[needle_len] = '\0';
+        if (round % 2) {
+            size_t at = (search_seed >> 4) % (300 - needle_len + 1);
+            for (size_t k = 0; k < needle_len; k++) {
+                pattern_lower[at + k] = (char)(pattern_needle[k] | 0x20);
+                search_hay[at + k] = k % 2 ? pattern_needle[k] : (char)(pattern_needle[k] & ~0x20);
+            }
+        }
+        
+        pat = guiarstr_pattern_create(pattern_needle, GUIARSTR_PATTERN_IGNORE_CASE);
+        size_t expected_count = 0;
+        size_t expected_last = (size_t)-1;
+        for (const char* p = strstr(pattern_lower, pat->needle); p; p = strstr(p + needle_len, pat->needle)) {
+            expected_count++;
+        }
+        for (size_t k = 300 - needle_len + 1; k-- > 0 && expected_last == (size_t)-1;) {
+            if (strncmp(pattern_lower + k, pat->needle, needle_len) == 0) expected_last = k;
+        }
+        GuiarStrView mixed = guiarstr_view_from(search_hay, 300);
+        pattern_ok = guiarstr_pattern_count(pat, mixed) == expected_count &&
+                     guiarstr_pattern_rfind(pat, mixed) == expected_last;
+        guiarstr_pattern_free(pat);
+    }
+    ASSERT_TRUE(pattern_ok);
+    
+    pat = guiarstr_pattern_create_len("\0\xFF", 2, 0);
+    ASSERT_EQ_SIZE(guiarstr_pattern_find(pat, guiarstr_view_from("ab\0\xFF", 4)), 2);
+    guiarstr_pattern_free(pat);
+    pat = guiarstr_pattern_create("", 0);
+    ASSERT_EQ_SIZE(guiarstr_pattern_find_from(pat, pat_hay, 3), 3);
+    ASSERT_EQ_SIZE(guiarstr_pattern_count(pat, pat_hay), 0);
+    ASSERT_TRUE(guiarstr_replace_n_pattern("abc", pat, "x", 1) == NULL);
+    guiarstr_pattern_free(pat);
+    
+    SECTION("Matcher Tests");
+    const char* ac_words[] = {"he", "she", "his", "hers"};
+    GuiarStrMatcher* ac = guiarstr_matcher_create_cstr(ac_words, 4, 0);
+    ASSERT_TRUE(ac != NULL);
+    ASSERT_EQ_SIZE(guiarstr_matcher_pattern_count(ac), 4);
+    GuiarStrView ac_text = guiarstr_view_from_cstr("ushers");
+    ASSERT_TRUE(guiarstr_matcher_contains(ac, ac_text));
+    ASSERT_FALSE(guiarstr_matcher_contains(ac, guiarstr_view_from_cstr("usual")));
+    GuiarStrMatch ac_match;
+    ASSERT_TRUE(guiarstr_matcher_find(ac, ac_text, &ac_match));
+    ASSERT_EQ_SIZE(ac_match.pattern, 1);
+    ASSERT_EQ_SIZE(ac_match.offset, 1);
+    ASSERT_TRUE(guiarstr_matcher_find_from(ac, ac_text, 2, &ac_match));
+    ASSERT_EQ_SIZE(ac_match.pattern, 3);
+    ASSERT_EQ_SIZE(ac_match.length, 4);
+    GuiarStrMatch ac_all[8];
+    ASSERT_EQ_SIZE(guiarstr_matcher_find_all(ac, ac_text, ac_all, 8), 3);
+    ASSERT_EQ_SIZE(ac_all[0].pattern, 1);
+    ASSERT_EQ_SIZE(ac_all[1].pattern, 0);
+    ASSERT_EQ_SIZE(ac_all[1].offset, 2);
+    ASSERT_EQ_SIZE(ac_all[2].pattern, 3);
+    unsigned char ac_bitmap[1];
+    ASSERT_EQ_SIZE(guiarstr_matcher_hits(ac, ac_text, ac_bitmap), 3);
+    ASSERT_EQ_SIZE(ac_bitmap[0], 0x0B);
+    GuiarStrView ac_to[] = {
+        guiarstr_view_from_cstr("HE"), guiarstr_view_from_cstr("SHE"),
+        guiarstr_view_from_cstr("HIS"), guiarstr_view_from_cstr("")
+    };
+    char* ac_replaced = guiarstr_matcher_replace(ac, guiarstr_view_from_cstr("she said his hers hello"), ac_to);
+    ASSERT_EQ_STR(ac_replaced, "SHE said HIS  HEllo");
+    free(ac_replaced);
+    guiarstr_matcher_free(ac);
+    
+    // Leftmost wins over shorter-first, duplicates all report, case folding and binary patterns
+    GuiarStrView ac_patterns[] = {
+        guiarstr_view_from_cstr("cat"), guiarstr_view_from_cstr("Category"),
+        guiarstr_view_from("\0x", 2), guiarstr_view_from_cstr("CAT")
+    };
+    ac = guiarstr_matcher_create(ac_patterns, 4, GUIARSTR_PATTERN_IGNORE_CASE);
+    ac_text = guiarstr_view_from("CATEGORY: cat\0x", 15);
+    ASSERT_TRUE(guiarstr_matcher_find(ac, ac_text, &ac_match));
+    ASSERT_EQ_SIZE(ac_match.pattern, 1);
+    ASSERT_EQ_SIZE(ac_match.length, 8);
+    ASSERT_EQ_SIZE(guiarstr_matcher_find_all(ac, ac_text, NULL, 0), 6);
+    ASSERT_EQ_SIZE(guiarstr_matcher_hits(ac, ac_text, ac_bitmap), 4);
+    GuiarStrView ac_to_tags[] = {
+        guiarstr_view_from_cstr("<c>"), guiarstr_view_from_cstr("<category>"),
+        guiarstr_view_from_cstr("<nul>"), guiarstr_view_from_cstr("<C>")
+    };
+    ac_replaced = guiarstr_matcher_replace(ac, ac_text, ac_to_tags);
+    ASSERT_EQ_STR(ac_replaced, "<category>: <c><nul>");
+    free(ac_replaced);
+    guiarstr_matcher_free(ac);
+    
+    const char* ac_bad[] = {"ok", ""};
+    ASSERT_TRUE(guiarstr_matcher_create_cstr(ac_bad, 2, 0) == NULL);
+    ac = guiarstr_matcher_create(NULL, 0, 0);
+    ASSERT_FALSE(guiarstr_matcher_contains(ac, ac_text));
+    ac_replaced = guiarstr_matcher_replace(ac, guiarstr_view_from_cstr("same"), NULL);
+    ASSERT_EQ_STR(ac_replaced, "same");
+    free(ac_replaced);
+    guiarstr_matcher_free(ac);
+    
+    GuiarStrView many_from[] = {
+        guiarstr_view_from_cstr("{{name}}"), guiarstr_view_from_cstr("{{n}}"), guiarstr_view_from_cstr("<")
+    };
+    GuiarStrView many_to[] = {
+        guiarstr_view_from_cstr("Ada"), guiarstr_view_from_cstr("42"), guiarstr_view_from_cstr("&lt;")
+    };
+    char* many = guiarstr_replace_many("Hi {{name}}, {{n}} <new> messages for {{name}}", many_from, many_to, 3);
+    ASSERT_EQ_STR(many, "Hi Ada, 42 &lt;new> messages for Ada");
+    free(many);
+    GuiarStrView nested_from[] = {guiarstr_view_from_cstr("a"), guiarstr_view_from_cstr("abc"), guiarstr_view_from_cstr("ab")};
+    many = guiarstr_replace_many("abcaba", nested_from, many_to, 3);
+    ASSERT_EQ_STR(many, "42&lt;Ada");
+    free(many);
+    ASSERT_TRUE(guiarstr_replace_many("abc", many_from, NULL, 3) == NULL);
+    
+    // Random pattern sets over a small alphabet against a brute-force scan
+    bool ac_ok = true;
+    char ac_words_buf[12][8];
+    GuiarStrView ac_set[12];
+    for (size_t round = 0; round < 200 && ac_ok; round++) {
+        size_t word_count = 1 + round % 12;
+        for (size_t w = 0; w < word_count; w++) {
+            search_seed = search_seed * 1103515245u + 12345u;
+            size_t len = 1 + (search_seed >> 16) % 7;
+            for (size_t k = 0; k < len; k++) {
+                search_seed = search_seed * 1103515245u + 12345u;
+                ac_words_buf[w][k] = "abc"[(search_seed >> 16) % 3];
+            }
+            ac_set[w] = guiarstr_view_from(ac_words_buf[w], len);
+        }
+        for (size_t k = 0; k < 300; k++) {
+            search_seed = search_seed * 1103515245u + 12345u;
+            search_hay[k] = "abcd"[(search_seed >> 16) % 4];
+        }
+        GuiarStrView text = guiarstr_view_from(search_hay, 300);
+        
+        size_t expected_all = 0;
+        size_t expected_offset = (size_t)-1;
+        size_t expected_length = 0;
+        for (size_t k = 0; k < 300; k++) {
+            for (size_t w = 0; w < word_count; w++) {
+                if (ac_set[w].length > 300 - k || memcmp(search_hay + k, ac_set[w].data, ac_set[w].length) != 0) continue;
+                expected_all++;
+                if (expected_offset == (size_t)-1 || (expected_offset == k && ac_set[w].length > expected_length)) {
+                    expected_offset = k;
+                    expected_length = ac_set[w].length;
+                }
+            }
+        }
+        
+        ac = guiarstr_matcher_create(ac_set, word_count, 0);
+        bool found = guiarstr_matcher_find(ac, text, &ac_match);
+        ac_ok = ac != NULL && guiarstr_matcher_find_all(ac, text, NULL, 0) == expected_all &&
+                found == (expected_offset != (size_t)-1) &&
+                (!found || (ac_match.offset == expected_offset && ac_match.length == expected_length));
+        guiarstr_matcher_free(ac);
+    }
+    ASSERT_TRUE(ac_ok);
+    
+    SECTION("Character Set Tests");
+    GuiarStrCharSet cs;
+    ASSERT_EQ_ERR(guiarstr_charset_init(&cs, " \t\r\n,;:"), GUIARSTR_OK);
+    ASSERT_TRUE(guiarstr_charset_contains(&cs, ';'));
+    ASSERT_FALSE(guiarstr_charset_contains(&cs, 'a'));
+    ASSERT_EQ_ERR(guiarstr_charset_init_len(&cs, NULL, 1), GUIARSTR_ERR_NULL);
+    ASSERT_EQ_ERR(guiarstr_charset_init(&cs, NULL), GUIARSTR_ERR_NULL);
+    ASSERT_EQ_SIZE(guiarstr_view_find_any(guiarstr_view_from_cstr("abc"), guiarstr_view_from(NULL, 3)), (size_t)-1);
+    
+    guiarstr_charset_init(&cs, " \t\r\n,;:");
+    const char* cs_text = "alpha, beta;\tgamma : delta\r\nepsilon zeta eta theta iota kappa";
+    ASSERT_EQ_SIZE(guiarstr_find_any_from_set(cs_text, &cs, 0), 5);
+    ASSERT_EQ_SIZE(guiarstr_find_any_from_set(cs_text, &cs, 7), 11);
+    ASSERT_EQ_SIZE(guiarstr_find_not_any_from_set(cs_text, &cs, 5), 7);
+    ASSERT_EQ_SIZE(guiarstr_rfind_any_set(cs_text, &cs), 55);
+    ASSERT_EQ_SIZE(guiarstr_find_any_from_set(cs_text, &cs, 56), (size_t)-1);
+    ASSERT_EQ_SIZE(guiarstr_find_any_from_set(cs_text, &cs, 500), (size_t)-1);
+    ASSERT_EQ_SIZE(guiarstr_view_find_any_set(guiarstr_view_from_cstr(cs_text), &cs), 5);
+    
+    char* cs_removed = guiarstr_remove_chars_set(cs_text, &cs);
+    ASSERT_EQ_STR(cs_removed, "alphabetagammadeltaepsilonzetaetathetaiotakappa");
+    free(cs_removed);
+    
+    char cs_strip[] = " ,;  hello world\t: ";
+    ASSERT_EQ_STR(guiarstr_strip_set(cs_strip, &cs), "hello world");
+    
+    char** cs_parts = guiarstr_split_any_set("a,b;;c d", &cs, &count);
+    ASSERT_EQ_SIZE(count, 5);
+    ASSERT_EQ_STR(cs_parts[4], "d");
+    guiarstr_split_free(cs_parts, count);
+    
+    GuiarStrView cs_views[6];
+    ASSERT_EQ_SIZE(guiarstr_view_split_any_set(guiarstr_view_from_cstr("x:y\tz"), &cs, cs_views, 6), 3);
+    ASSERT_TRUE(guiarstr_view_equals(cs_views[2], guiarstr_view_from_cstr("z")));
+    
+    // High bytes, long runs and set sizes on both sides of the small-set path
+    guiarstr_charset_init(&cs, "\xC3\xA9\xFF");
+    char cs_high[80];
+    memset(cs_high, 'x', sizeof(cs_high) - 1);
+    cs_high[sizeof(cs_high) - 1] = '\0';
+    cs_high[70] = '\xFF';
+    ASSERT_EQ_SIZE(guiarstr_find_any_from_set(cs_high, &cs, 0), 70);
+    ASSERT_EQ_SIZE(guiarstr_find_any(cs_high, "\xFF"), 70);
+    ASSERT_EQ_SIZE(guiarstr_find_not_any(cs_high, "x"), 70);
+    
+    bool cs_ok = true;
+    for (size_t round = 0; round < 120 && cs_ok; round++) {
+        size_t set_size = (size_t[]){1, 2, 4, 5, 9, 40}[round % 6];
+        char cs_chars[41];
+        for (size_t k = 0; k < set_size; k++) {
+            search_seed = search_seed * 1103515245u + 12345u;
+            cs_chars[k] = (char)(1 + (search_seed >> 16) % 255);
+        }
+        cs_chars[set_size] = '\0';
+        guiarstr_charset_init(&cs, cs_chars);
+        
+        for (size_t k = 0; k < 300; k++) {
+            search_seed = search_seed * 1103515245u + 12345u;
+            search_hay[k] = (search_seed >> 20) % 3 ? cs_chars[(search_seed >> 8) % set_size]
+                                                   : (char)(1 + (search_seed >> 12) % 255);
+        }
+        search_hay[300] = '\0';
+        
+        size_t hay_len = 1 + (search_seed >> 4) % 300;
+        search_hay[hay_len] = '\0';
+        size_t from = (search_seed >> 6) % (hay_len + 1);
+        size_t expected_any = (size_t)-1;
+        size_t expected_not = (size_t)-1;
+        size_t expected_last = (size_t)-1;
+        for (size_t k = hay_len; k > 0; k--) {
+            bool member = strchr(cs_chars, search_hay[k - 1]) != NULL;
+            if (k - 1 >= from && member) expected_any = k - 1;
+            if (k - 1 >= from && !member) expected_not = k - 1;
+            if (member && expected_last == (size_t)-1) expected_last = k - 1;
+        }
+        
+        char* removed = guiarstr_remove_chars_set(search_hay, &cs);
+        size_t kept = 0;
+        for (size_t k = 0; k < hay_len; k++) {
+            if (!strchr(cs_chars, search_hay[k]) && removed[kept++] != search_hay[k]) cs_ok = false;
+        }
+        cs_ok = cs_ok && removed[kept] == '\0' &&
+                guiarstr_find_any_from_set(search_hay, &cs, from) == expected_any &&
+                guiarstr_find_not_any_from_set(search_hay, &cs, from) == expected_not &&
+                guiarstr_rfind_any_set(search_hay, &cs) == expected_last &&
+                guiarstr_find_any(search_hay, cs_chars) == strcspn(search_hay, cs_chars) &&
+                guiarstr_find_not_any(search_hay, cs_chars) == strspn(search_hay, cs_chars);
+        free(removed);
+    }
+    ASSERT_TRUE(cs_ok);
     
     SECTION("Dynamic String Tests");
     GuiarStr* str = guiarstr_create("hello");
@@ -251,6 +943,25 @@ int main(void) {
     ASSERT_EQ_ERR(err, GUIARSTR_OK);
     ASSERT_EQ_STR(str->data, "hello world!");
     
+    // Small strings start inline and spill to the heap when they grow
+    GuiarStr* sso = guiarstr_create("tag:42");
+    ASSERT_TRUE(sso->flags & GUIARSTR_FLAG_INLINE);
+    ASSERT_TRUE(sso->data == (char*)(sso + 1));
+    err = guiarstr_insert(sso, 0, "prefix-that-is-long-enough-to-spill/");
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_FALSE(sso->flags & GUIARSTR_FLAG_INLINE);
+    ASSERT_EQ_STR(sso->data, "prefix-that-is-long-enough-to-spill/tag:42");
+    err = guiarstr_remove(sso, 0, 36);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_ERR(guiarstr_shrink_to_fit(sso), GUIARSTR_OK);
+    ASSERT_EQ_STR(sso->data, "tag:42");
+    guiarstr_free(sso);
+    
+    GuiarStr* sso_copy = guiarstr_copy(str);
+    ASSERT_TRUE(sso_copy->flags & GUIARSTR_FLAG_INLINE);
+    ASSERT_EQ_STR(sso_copy->data, "hello world!");
+    guiarstr_free(sso_copy);
+    
     // Clear
     err = guiarstr_clear(str);
     ASSERT_EQ_ERR(err, GUIARSTR_OK);
@@ -259,6 +970,342 @@ int main(void) {
     
     guiarstr_free(str);
     
+    SECTION("Binary-safe String Tests");
+    // A protocol frame with embedded NULs: C-string functions would stop at the first one
+    GuiarStr* frame = guiarstr_create_len("HDR\0\1\0BODY\0\1\0END", 16);
+    GuiarStrView sep = guiarstr_view_from("\0\1\0", 3);
+    ASSERT_EQ_SIZE(guiarstr_str_find(frame, sep), 3);
+    ASSERT_EQ_SIZE(guiarstr_str_rfind(frame, sep), 10);
+    ASSERT_EQ_SIZE(guiarstr_str_find_from(frame, sep, 4), 10);
+    ASSERT_EQ_SIZE(guiarstr_str_count(frame, sep), 2);
+    ASSERT_TRUE(guiarstr_str_contains(frame, guiarstr_view_from_cstr("END")));
+    GuiarStrView fields[4];
+    ASSERT_EQ_SIZE(guiarstr_str_split(frame, sep, fields, 4), 3);
+    ASSERT_TRUE(guiarstr_view_equals(fields[1], guiarstr_view_from_cstr("BODY")));
+    ASSERT_TRUE(guiarstr_view_equals(fields[2], guiarstr_view_from_cstr("END")));
+    
+    GuiarStr* frame_copy = guiarstr_copy(frame);
+    ASSERT_TRUE(guiarstr_str_equals(frame, frame_copy));
+    ASSERT_TRUE(guiarstr_str_hash(frame) == guiarstr_str_hash(frame_copy));
+    guiarstr_resize(frame_copy, 15, '\0');
+    ASSERT_FALSE(guiarstr_str_equals(frame, frame_copy));
+    ASSERT_TRUE(guiarstr_str_compare(frame_copy, frame) < 0);
+    ASSERT_TRUE(guiarstr_str_hash(frame) != guiarstr_str_hash(frame_copy));
+    
+    err = guiarstr_str_replace(frame, sep, guiarstr_view_from("|", 1), (size_t)-1);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_SIZE(frame->length, 12);
+    ASSERT_EQ_STR(frame->data, "HDR|BODY|END");
+    err = guiarstr_str_replace(frame, guiarstr_view_from("|", 1), guiarstr_view_from("\0\0", 2), 1);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_SIZE(frame->length, 13);
+    ASSERT_EQ_SIZE(guiarstr_str_find(frame, guiarstr_view_from("\0\0B", 3)), 3);
+    ASSERT_EQ_ERR(guiarstr_str_replace(frame, guiarstr_view_from(NULL, 0), sep, 1), GUIARSTR_ERR_INVALID);
+    
+    // In place: shrinking never reallocates, growing within capacity neither, and matches stay
+    // the forward non-overlapping ones even for a self-overlapping needle
+    GuiarStr* edit = guiarstr_create("aaaaa-aaaaa");
+    ASSERT_EQ_ERR(guiarstr_reserve(edit, 64), GUIARSTR_OK);
+    const char* edit_data = edit->data;
+    err = guiarstr_str_replace(edit, guiarstr_view_from_cstr("aa"), guiarstr_view_from_cstr("xyz"), 3);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(edit->data, "xyzxyza-xyzaaa");
+    ASSERT_TRUE(edit->data == edit_data);
+    err = guiarstr_str_replace(edit, guiarstr_view_from_cstr("xyz"), guiarstr_view_from_cstr("b"), (size_t)-1);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(edit->data, "bba-baaa");
+    ASSERT_TRUE(edit->data == edit_data);
+    err = guiarstr_str_replace(edit, guiarstr_view_from_cstr("a"), guiarstr_view_from_cstr("[a]"), (size_t)-1);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(edit->data, "bb[a]-b[a][a][a]");
+    err = guiarstr_str_replace(edit, guiarstr_view_slice(guiarstr_view_from_str(edit), 2, 3), guiarstr_view_from_cstr("a"), (size_t)-1);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(edit->data, "bba-baaa");
+    GuiarStr* edit_shared = guiarstr_create_shared("k=v");
+    GuiarStr* edit_other = guiarstr_copy(edit_shared);
+    err = guiarstr_str_replace(edit_other, guiarstr_view_from_cstr("="), guiarstr_view_from_cstr(": "), 1);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(edit_other->data, "k: v");
+    ASSERT_EQ_STR(edit_shared->data, "k=v");
+    guiarstr_free(edit_other);
+    guiarstr_free(edit_shared);
+    guiarstr_free(edit);
+    
+    GuiarStr* norm = guiarstr_create_len(" \t X-Trace\0ID: AbC \r\n", 21);
+    err = guiarstr_str_trim(norm);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_SIZE(norm->length, 15);
+    GuiarStr* norm_other = guiarstr_copy(norm);
+    err = guiarstr_str_tolower(norm);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_TRUE(guiarstr_view_equals(guiarstr_view_from_str(norm), guiarstr_view_from("x-trace\0id: abc", 15)));
+    err = guiarstr_str_toupper(norm_other);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_TRUE(guiarstr_view_equals(guiarstr_view_from_str(norm_other), guiarstr_view_from("X-TRACE\0ID: ABC", 15)));
+    err = guiarstr_str_tolower(NULL);
+    ASSERT_EQ_ERR(err, GUIARSTR_ERR_NULL);
+    guiarstr_free(norm_other);
+    guiarstr_free(norm);
+    GuiarStr* norm_shared = guiarstr_create_shared("  Mixed Case  ");
+    GuiarStr* norm_copy = guiarstr_copy(norm_shared);
+    err = guiarstr_str_trim(norm_copy);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    err = guiarstr_str_toupper(norm_copy);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(norm_copy->data, "MIXED CASE");
+    ASSERT_EQ_STR(norm_shared->data, "  Mixed Case  ");
+    guiarstr_free(norm_copy);
+    guiarstr_free(norm_shared);
+    
+    GuiarStr* icase_str = guiarstr_create("Set-Cookie: a=1\r\nSET-COOKIE: b=2\r\n");
+    ASSERT_EQ_SIZE(guiarstr_str_find_i(icase_str, guiarstr_view_from_cstr("set-cookie")), 0);
+    ASSERT_EQ_SIZE(guiarstr_str_count_i(icase_str, guiarstr_view_from_cstr("SET-cookie")), 2);
+    err = guiarstr_str_replace_i(icase_str, guiarstr_view_from_cstr("set-cookie: "), guiarstr_view_from_cstr("Cookie: "), (size_t)-1);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(icase_str->data, "Cookie: a=1\r\nCookie: b=2\r\n");
+    err = guiarstr_str_replace_i(icase_str, guiarstr_view_slice(guiarstr_view_from_str(icase_str), 0, 6), guiarstr_view_from_cstr("[c]"), (size_t)-1);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(icase_str->data, "[c]: a=1\r\n[c]: b=2\r\n");
+    err = guiarstr_str_replace_i(icase_str, guiarstr_view_from_cstr("[C]"), guiarstr_view_from_cstr("cookie-header"), 1);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(icase_str->data, "cookie-header: a=1\r\n[c]: b=2\r\n");
+    err = guiarstr_str_replace_i(icase_str, guiarstr_view_from(NULL, 0), guiarstr_view_from_cstr("x"), 1);
+    ASSERT_EQ_ERR(err, GUIARSTR_ERR_INVALID);
+    guiarstr_free(icase_str);
+    
+    err = guiarstr_append_str(frame_copy, frame_copy);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_SIZE(frame_copy->length, 30);
+    ASSERT_EQ_SIZE(guiarstr_str_rfind(frame_copy, guiarstr_view_from("HDR", 3)), 15);
+    GuiarStr* mid = guiarstr_create("ab");
+    err = guiarstr_insert_str(mid, 1, mid);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(mid->data, "aabb");
+    GuiarStr* nul_piece = guiarstr_create_len("\0", 1);
+    err = guiarstr_insert_str(mid, 2, nul_piece);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_SIZE(mid->length, 5);
+    ASSERT_EQ_SIZE(guiarstr_str_find(mid, guiarstr_view_from("\0bb", 3)), 2);
+    
+    const char* bin_path = "guiarstr_binary_test.bin";
+    ASSERT_EQ_ERR(guiarstr_write_file_str(bin_path, frame_copy, false), GUIARSTR_OK);
+    GuiarStr* reloaded = guiarstr_read_file(bin_path, &err);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_TRUE(guiarstr_str_equals(reloaded, frame_copy));
+    ASSERT_EQ_SIZE(reloaded->data[reloaded->length], 0);
+    remove(bin_path);
+    
+    // Shrinking replacements compact in place; growing or self-referencing ones get one new buffer
+    GuiarStr* scrub = guiarstr_create("password=hunter2 token=abc123");
+    GuiarStrView secrets[] = {guiarstr_view_from_cstr("hunter2"), guiarstr_view_from_cstr("abc123")};
+    GuiarStrView masks[] = {guiarstr_view_from_cstr("***"), guiarstr_view_from_cstr("***")};
+    const char* scrub_data = scrub->data;
+    err = guiarstr_str_replace_many(scrub, secrets, masks, 2);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(scrub->data, "password=*** token=***");
+    ASSERT_TRUE(scrub->data == scrub_data);
+    GuiarStrView redacted = guiarstr_view_from_cstr("[redacted]");
+    err = guiarstr_str_replace_many(scrub, masks, &redacted, 1);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(scrub->data, "password=[redacted] token=[redacted]");
+    ASSERT_EQ_SIZE(scrub->length, 36);
+    GuiarStrView own_word = guiarstr_view_slice(guiarstr_view_from_str(scrub), 20, 5);
+    GuiarStrView password = guiarstr_view_from_cstr("password");
+    err = guiarstr_str_replace_many(scrub, &password, &own_word, 1);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(scrub->data, "token=[redacted] token=[redacted]");
+    GuiarStr* scrub_shared = guiarstr_create_shared("key=1 key=2");
+    GuiarStr* scrub_other = guiarstr_copy(scrub_shared);
+    GuiarStrView key = guiarstr_view_from_cstr("key=");
+    err = guiarstr_str_replace_many(scrub_other, &key, &masks[0], 1);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(scrub_other->data, "***1 ***2");
+    ASSERT_EQ_STR(scrub_shared->data, "key=1 key=2");
+    GuiarStrView no_from = guiarstr_view_from(NULL, 0);
+    ASSERT_EQ_ERR(guiarstr_str_replace_many(scrub, &no_from, &key, 1), GUIARSTR_ERR_INVALID);
+    guiarstr_free(scrub_other);
+    guiarstr_free(scrub_shared);
+    guiarstr_free(scrub);
+    guiarstr_free(reloaded);
+    guiarstr_free(nul_piece);
+    guiarstr_free(mid);
+    guiarstr_free(frame_copy);
+    guiarstr_free(frame);
+    
+    SECTION("Embedded String Tests");
+    GuiarStr embedded;
+    err = guiarstr_init(&embedded, "on the stack");
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    err = guiarstr_append(&embedded, "!");
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(embedded.data, "on the stack!");
+    guiarstr_deinit(&embedded);
+    
+    char stack_buf[8];
+    GuiarStr buffered;
+    err = guiarstr_init_with_buffer(&buffered, stack_buf, sizeof(stack_buf));
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    guiarstr_append(&buffered, "1234567");
+    ASSERT_TRUE(buffered.data == stack_buf);
+    err = guiarstr_append_char(&buffered, '8');
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_TRUE(buffered.data != stack_buf);
+    ASSERT_EQ_STR(buffered.data, "12345678");
+    guiarstr_deinit(&buffered);
+    err = guiarstr_init_with_buffer(&buffered, stack_buf, 0);
+    ASSERT_EQ_ERR(err, GUIARSTR_ERR_INVALID);
+    
+    GuiarStrBuilder embedded_builder;
+    err = guiarstr_builder_init(&embedded_builder, 16);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    guiarstr_builder_append(&embedded_builder, "embedded");
+    ASSERT_EQ_STR(embedded_builder.buffer->data, "embedded");
+    guiarstr_builder_deinit(&embedded_builder);
+    
+    SECTION("Growth Policy Tests");
+    GuiarStr regrown;
+    guiarstr_init(&regrown, "x");
+    guiarstr_deinit(&regrown);
+    err = guiarstr_append(&regrown, "grows from zero capacity");
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(regrown.data, "grows from zero capacity");
+    guiarstr_deinit(&regrown);
+    
+    GuiarStrGrowthPolicy bad_policy = { 1.0, 0, 0, false };
+    err = guiarstr_set_growth_policy(&bad_policy);
+    ASSERT_EQ_ERR(err, GUIARSTR_ERR_INVALID);
+    
+    GuiarStrGrowthPolicy mapped_policy = { 2.0, 4096, 64 * 1024, false };
+    GuiarStr* mapped = guiarstr_create("");
+    guiarstr_set_str_growth_policy(mapped, &mapped_policy);
+    char block[1000];
+    memset(block, 'm', sizeof(block));
+    for (int i = 0; i < 1000; i++) {
+        guiarstr_append_len(mapped, block, sizeof(block));
+    }
+    ASSERT_EQ_SIZE(mapped->length, 1000000);
+    ASSERT_EQ_SIZE(mapped->capacity % 4096, 0);
+#if defined(__unix__) || defined(__APPLE__)
+    ASSERT_TRUE(mapped->flags & GUIARSTR_FLAG_MAPPED);
+#endif
+    ASSERT_TRUE(mapped->data[999999] == 'm' && mapped->data[1000000] == '\0');
+    guiarstr_resize(mapped, 10, ' ');
+    guiarstr_shrink_to_fit(mapped);
+    ASSERT_FALSE(mapped->flags & GUIARSTR_FLAG_MAPPED);
+    ASSERT_EQ_STR(mapped->data, "mmmmmmmmmm");
+    guiarstr_free(mapped);
+    
+    SECTION("Shared String Tests");
+    GuiarStr* shared = guiarstr_create_shared("Content-Type: text/plain");
+    ASSERT_TRUE(shared != NULL);
+    ASSERT_FALSE(guiarstr_is_shared(shared));
+    GuiarStr* shared_copy = guiarstr_copy(shared);
+    ASSERT_TRUE(shared_copy->data == shared->data);
+    ASSERT_TRUE(guiarstr_is_shared(shared));
+    err = guiarstr_append(shared_copy, "; charset=utf-8");
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_TRUE(shared_copy->data != shared->data);
+    ASSERT_EQ_STR(shared->data, "Content-Type: text/plain");
+    ASSERT_EQ_STR(shared_copy->data, "Content-Type: text/plain; charset=utf-8");
+    ASSERT_FALSE(guiarstr_is_shared(shared));
+    GuiarStr* shared_copy2 = guiarstr_copy(shared);
+    guiarstr_free(shared);
+    guiarstr_clear(shared_copy2);
+    ASSERT_EQ_STR(shared_copy2->data, "");
+    guiarstr_free(shared_copy2);
+    guiarstr_free(shared_copy);
+    
+    SECTION("Arena Tests");
+    GuiarStrArena* arena = guiarstr_arena_create(64);
+    ASSERT_TRUE(arena != NULL);
+    
+    GuiarStr* arena_str = guiarstr_create_arena(arena, "key");
+    ASSERT_TRUE(arena_str != NULL && arena_str->allocator == guiarstr_arena_allocator(arena));
+    err = guiarstr_append(arena_str, "=a-value-long-enough-to-leave-the-first-block");
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_STR(arena_str->data, "key=a-value-long-enough-to-leave-the-first-block");
+    guiarstr_free(arena_str); // no-op for arena strings
+    
+    GuiarStrArenaMark mark = guiarstr_arena_mark(arena);
+    char* arena_fmt = guiarstr_printf_arena(arena, "%s-%d", "req", 7);
+    ASSERT_EQ_STR(arena_fmt, "req-7");
+    char* arena_rep = guiarstr_replace_arena(arena, "a.b.c", ".", "::");
+    ASSERT_EQ_STR(arena_rep, "a::b::c");
+    char* arena_num = guiarstr_from_int_arena(arena, -42);
+    ASSERT_EQ_STR(arena_num, "-42");
+    char** arena_parts = guiarstr_split_arena(arena, "x,y,z", ',', &count);
+    ASSERT_EQ_SIZE(count, 3);
+    ASSERT_EQ_STR(arena_parts[2], "z");
+    
+    guiarstr_arena_rewind(arena, mark);
+    char* after_rewind = guiarstr_printf_arena(arena, "%s", "reused");
+    ASSERT_TRUE(after_rewind == arena_fmt);
+    ASSERT_EQ_STR(after_rewind, "reused");
+    
+    guiarstr_arena_reset(arena);
+    GuiarStr* big = guiarstr_create_empty_arena(arena, 1000);
+    ASSERT_TRUE(big != NULL && big->capacity == 1000);
+    guiarstr_arena_free(arena);
+    
+    SECTION("Allocator Hook Tests");
+    CountingAllocatorState counting_state = {0, 0, 0};
+    GuiarStrAllocator counting = {counting_alloc, counting_realloc, counting_free, &counting_state};
+    
+    GuiarStr* hooked = guiarstr_create_with_allocator("hooked", &counting);
+    ASSERT_TRUE(hooked != NULL && hooked->allocator == &counting);
+    ASSERT_EQ_SIZE(counting_state.allocs, 1);
+    err = guiarstr_append(hooked, " string that outgrows the initial buffer");
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_SIZE(counting_state.allocs, 2);
+    err = guiarstr_append(hooked, " and then grows once more on the heap");
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_SIZE(counting_state.reallocs, 1);
+    guiarstr_free(hooked);
+    ASSERT_EQ_SIZE(counting_state.frees, 2);
+    
+    GuiarStrBuilder* hooked_builder = guiarstr_builder_create_with_allocator(16, &counting);
+    guiarstr_builder_append(hooked_builder, "abc");
+    guiarstr_builder_free(hooked_builder);
+    ASSERT_EQ_SIZE(counting_state.allocs, counting_state.frees);
+    
+    guiarstr_set_allocator(&counting);
+    ASSERT_TRUE(guiarstr_get_allocator() == &counting);
+    char* hooked_rep = guiarstr_replace("a-b", "-", "+");
+    ASSERT_EQ_STR(hooked_rep, "a+b");
+    guiarstr_dealloc(hooked_rep);
+    guiarstr_set_allocator(NULL);
+    ASSERT_EQ_SIZE(counting_state.allocs, counting_state.frees);
+    
+    SECTION("Pool Tests");
+    guiarstr_set_allocator(guiarstr_pool_allocator());
+    GuiarStr* pooled = guiarstr_create("pooled");
+    guiarstr_free(pooled);
+    pooled = guiarstr_create("pooled again");
+    GuiarStrPoolStats pool_stats;
+    guiarstr_pool_stats(&pool_stats);
+#ifdef HAVE_PTHREAD
+    ASSERT_TRUE(pool_stats.hits >= 1);
+    
+    // Freed on another thread, recycled by this one
+    pthread_t pool_thread;
+    pthread_create(&pool_thread, NULL, pool_free_worker, pooled);
+    pthread_join(pool_thread, NULL);
+    pooled = guiarstr_create("after remote free");
+    guiarstr_pool_stats(&pool_stats);
+    ASSERT_EQ_SIZE(pool_stats.remote_frees, 1);
+#else
+    guiarstr_free(pooled);
+    pooled = guiarstr_create("after remote free");
+#endif
+    guiarstr_append(pooled, " and grown past the small size classes of the pool");
+    guiarstr_shrink_to_fit(pooled);
+    ASSERT_EQ_STR(pooled->data, "after remote free and grown past the small size classes of the pool");
+    guiarstr_free(pooled);
+    guiarstr_pool_trim();
+    guiarstr_pool_stats(&pool_stats);
+    ASSERT_EQ_SIZE(pool_stats.cached_blocks, 0);
+    guiarstr_set_allocator(NULL);
+    
     SECTION("String Builder Tests");
     GuiarStrBuilder* builder = guiarstr_builder_create(16);
     ASSERT_TRUE(builder != NULL);
@@ -277,8 +1324,112 @@ int main(void) {
     ASSERT_EQ_STR(built->data, "hello world");
     
     guiarstr_free(built);
+    
+    char* buffer_data = builder->buffer->data;
+    GuiarStr* taken = guiarstr_builder_take(builder, false);
+    ASSERT_TRUE(taken != NULL);
+    ASSERT_TRUE(taken->data == buffer_data);
+    ASSERT_EQ_STR(taken->data, "hello world");
+    ASSERT_EQ_SIZE(builder->buffer->length, 0);
+    guiarstr_builder_append(builder, "reused");
+    ASSERT_EQ_STR(builder->buffer->data, "reused");
+    guiarstr_free(taken);
     guiarstr_builder_free(builder);
     
+    SECTION("Chunked Builder Tests");
+    GuiarStrChunkBuilder* chunks = guiarstr_chunk_builder_create(8);
+    ASSERT_TRUE(chunks != NULL);
+    guiarstr_chunk_builder_append(chunks, "hello ");
+    GuiarStrChunk* first_chunk = chunks->first;
+    guiarstr_chunk_builder_append(chunks, "chunked world");
+    err = guiarstr_chunk_builder_append_fmt(chunks, " %d", 42);
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_TRUE(chunks->first == first_chunk);
+    ASSERT_EQ_SIZE(guiarstr_chunk_builder_length(chunks), 22);
+    GuiarStrView chunk_views[8];
+    size_t chunk_count = guiarstr_chunk_builder_views(chunks, chunk_views, 8);
+    ASSERT_EQ_SIZE(chunk_count, 3);
+    ASSERT_EQ_SIZE(chunk_views[0].length, 8);
+    GuiarStr* flat = guiarstr_chunk_builder_flatten(chunks);
+    ASSERT_EQ_STR(flat->data, "hello chunked world 42");
+    guiarstr_free(flat);
+    guiarstr_chunk_builder_reset(chunks);
+    ASSERT_EQ_SIZE(guiarstr_chunk_builder_views(chunks, NULL, 0), 0);
+    guiarstr_chunk_builder_free(chunks);
+    
+    SECTION("Rope Tests");
+    GuiarStrRope* rope = guiarstr_rope_create("hello world");
+    ASSERT_TRUE(rope != NULL);
+    guiarstr_rope_insert(rope, 5, ",");
+    guiarstr_rope_remove(rope, 0, 1);
+    guiarstr_rope_insert(rope, 0, "H");
+    GuiarStr* rope_str = guiarstr_rope_to_str(rope);
+    ASSERT_EQ_STR(rope_str->data, "Hello, world");
+    guiarstr_free(rope_str);
+    
+    err = guiarstr_rope_utf8_insert(rope, 7, "مرحبا ");
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    ASSERT_EQ_SIZE(guiarstr_rope_utf8_len(rope), 18);
+    guiarstr_rope_utf8_remove(rope, 7, 6);
+    rope_str = guiarstr_rope_substring(rope, 7, 5);
+    ASSERT_EQ_STR(rope_str->data, "world");
+    guiarstr_free(rope_str);
+    guiarstr_rope_free(rope);
+    
+    // Random edits across many chunks must match the flat string
+    GuiarStr* rope_ref = guiarstr_create_empty(0);
+    rope = guiarstr_rope_create("");
+    unsigned int rope_seed = 12345;
+    for (int i = 0; i < 3000; i++) {
+        rope_seed = rope_seed * 1103515245u + 12345u;
+        size_t pos = rope_ref->length ? (rope_seed >> 8) % (rope_ref->length + 1) : 0;
+        if (i % 4 == 3) {
+            size_t len = (rope_seed >> 4) % 700;
+            guiarstr_remove(rope_ref, pos, len);
+            guiarstr_rope_remove(rope, pos, len);
+        } else {
+            char text[600];
+            size_t len = (rope_seed >> 12) % sizeof(text);
+            memset(text, 'a' + (char)(i % 26), len);
+            guiarstr_insert_len(rope_ref, pos, text, len);
+            guiarstr_rope_insert_len(rope, pos, text, len);
+        }
+    }
+    rope_str = guiarstr_rope_to_str(rope);
+    ASSERT_EQ_SIZE(rope_str->length, rope_ref->length);
+    ASSERT_TRUE(memcmp(rope_str->data, rope_ref->data, rope_ref->length) == 0);
+    size_t rope_views = guiarstr_rope_views(rope, 0, guiarstr_rope_length(rope), NULL, 0);
+    ASSERT_TRUE(rope_views > 1);
+    guiarstr_free(rope_str);
+    guiarstr_free(rope_ref);
+    guiarstr_rope_free(rope);
+    
+    SECTION("Gap Buffer Tests");
+    GuiarStrGap* gap = guiarstr_gap_create("hello world");
+    ASSERT_TRUE(gap != NULL);
+    ASSERT_EQ_SIZE(guiarstr_gap_cursor(gap), 11);
+    guiarstr_gap_move_cursor(gap, 5);
+    guiarstr_gap_insert(gap, ", dear");
+    guiarstr_gap_delete_before(gap, 5);
+    guiarstr_gap_insert_char(gap, '!');
+    guiarstr_gap_delete_after(gap, 1);
+    GuiarStrView gap_views[2];
+    ASSERT_EQ_SIZE(guiarstr_gap_views(gap, gap_views), 2);
+    ASSERT_EQ_SIZE(gap_views[0].length, 7);
+    ASSERT_EQ_SIZE(guiarstr_gap_find(gap, "!w"), 6);
+    ASSERT_EQ_SIZE(guiarstr_gap_find(gap, "world"), 7);
+    ASSERT_EQ_SIZE(guiarstr_gap_find(gap, "xyz"), (size_t)-1);
+    for (int i = 0; i < 100; i++) {
+        guiarstr_gap_insert_char(gap, '.');
+    }
+    guiarstr_gap_move_cursor(gap, 0);
+    GuiarStr* gap_str = guiarstr_gap_to_str(gap);
+    ASSERT_EQ_SIZE(gap_str->length, 112);
+    ASSERT_TRUE(guiarstr_startswith(gap_str->data, "hello,!..."));
+    ASSERT_TRUE(guiarstr_endswith(gap_str->data, "...world"));
+    guiarstr_free(gap_str);
+    guiarstr_gap_free(gap);
+    
     SECTION("Formatting Tests");
     char* formatted = guiarstr_printf("%s %d %.2f", "test", 42, 3.14159);
     ASSERT_EQ_STR(formatted, "test 42 3.14");
@@ -298,6 +1449,84 @@ int main(void) {
     ASSERT_TRUE(guiarstr_utf8_validate("مرحبا"));
     ASSERT_TRUE(guiarstr_utf8_validate("😊"));
     ASSERT_FALSE(guiarstr_utf8_validate("\xff"));
+    ASSERT_FALSE(guiarstr_utf8_validate("\xE2"));
+    ASSERT_FALSE(guiarstr_utf8_validate("\xF0\x9F\x98"));
+    ASSERT_FALSE(guiarstr_utf8_validate("\xED\xA0\x80"));
+    ASSERT_TRUE(guiarstr_utf8_validate("\xF4\x8F\xBF\xBF\xED\x9F\xBF\xEE\x80\x80"));
+    
+    ASSERT_EQ_SIZE(guiarstr_utf8_error_offset("\xC0\xAF", 2), 0);
+    ASSERT_EQ_SIZE(guiarstr_utf8_error_offset("ab\xE0\x80\xAF", 5), 2);
+    ASSERT_EQ_SIZE(guiarstr_utf8_error_offset("\xF0\x8F\xBF\xBF", 4), 0);
+    ASSERT_EQ_SIZE(guiarstr_utf8_error_offset("x\xED\xA0\x80", 4), 1);
+    ASSERT_EQ_SIZE(guiarstr_utf8_error_offset("\xF4\x90\x80\x80", 4), 0);
+    ASSERT_EQ_SIZE(guiarstr_utf8_error_offset("\xF5\x80\x80\x80", 4), 0);
+    ASSERT_EQ_SIZE(guiarstr_utf8_error_offset("abc\x80", 4), 3);
+    ASSERT_EQ_SIZE(guiarstr_utf8_error_offset("\xE2\x82z", 3), 0);
+    ASSERT_EQ_SIZE(guiarstr_utf8_error_offset("\xF0\x9F\x98\x8A\x80", 5), 4);
+    ASSERT_EQ_SIZE(guiarstr_utf8_error_offset("\xE2\x82\xAC", 2), 0);
+    ASSERT_EQ_SIZE(guiarstr_utf8_error_offset("a\0\xC3\xA9", 4), (size_t)-1);
+    ASSERT_EQ_SIZE(guiarstr_utf8_error_offset(NULL, 0), (size_t)-1);
+    ASSERT_EQ_SIZE(guiarstr_view_utf8_error_offset(guiarstr_view_from_cstr("caf\xC3\xA9 \xC3")), 6);
+    
+    GuiarStr* utf8_target = guiarstr_create("caf");
+    err = guiarstr_utf8_append(utf8_target, "\xC3");
+    ASSERT_EQ_ERR(err, GUIARSTR_ERR_UTF8);
+    err = guiarstr_utf8_append(utf8_target, "\xC3\xA9");
+    ASSERT_EQ_ERR(err, GUIARSTR_OK);
+    err = guiarstr_utf8_insert(utf8_target, 0, "\xED\xBF\xBF");
+    ASSERT_EQ_ERR(err, GUIARSTR_ERR_UTF8);
+    ASSERT_EQ_STR(utf8_target->data, "caf\xC3\xA9");
+    guiarstr_free(utf8_target);
+    ASSERT_TRUE(guiarstr_utf8_reverse("ab\xF4\x90\x80\x80") == NULL);
+    
+    // Random text across the 64-byte vector blocks, damaged or cut short, against a plain decoder
+    unsigned char utf8_buf[520];
+    bool utf8_ok = true;
+    unsigned int utf8_seed = 2025;
+    for (size_t round = 0; round < 3000 && utf8_ok; round++) {
+        size_t len = 0;
+        while (len < 512) {
+            utf8_seed = utf8_seed * 1103515245u + 12345u;
+            unsigned int pick = utf8_seed >> 16;
+            unsigned long cp;
+            switch (pick % 5) {
+                case 0: cp = 0x80 + pick % 0x780; break;
+                case 1: cp = 0x800 + (pick * 7u) % 0xF800; break;
+                case 2: cp = 0x10000 + (unsigned long)pick * 16u % 0x100000; break;
+                default: cp = 0x20 + pick % 0x5F; break;
+            }
+            if (cp >= 0xD800 && cp <= 0xDFFF) cp = 'x';
+            
+            size_t runs = (pick % 5) >= 3 ? 1 + (pick >> 8) % 48 : 1;
+            for (size_t r = 0; r < runs && len < 512; r++) {
+                if (cp < 0x80) {
+                    utf8_buf[len++] = (unsigned char)cp;
+                } else if (cp < 0x800) {
+                    utf8_buf[len++] = (unsigned char)(0xC0 | cp >> 6);
+                    utf8_buf[len++] = (unsigned char)(0x80 | (cp & 0x3F));
+                } else if (cp < 0x10000) {
+                    utf8_buf[len++] = (unsigned char)(0xE0 | cp >> 12);
+                    utf8_buf[len++] = (unsigned char)(0x80 | (cp >> 6 & 0x3F));
+                    utf8_buf[len++] = (unsigned char)(0x80 | (cp & 0x3F));
+                } else {
+                    utf8_buf[len++] = (unsigned char)(0xF0 | cp >> 18);
+                    utf8_buf[len++] = (unsigned char)(0x80 | (cp >> 12 & 0x3F));
+                    utf8_buf[len++] = (unsigned char)(0x80 | (cp >> 6 & 0x3F));
+                    utf8_buf[len++] = (unsigned char)(0x80 | (cp & 0x3F));
+                }
+            }
+        }
+        
+        utf8_seed = utf8_seed * 1103515245u + 12345u;
+        if (round % 4 == 1) {
+            len = (utf8_seed >> 8) % (len + 1);
+        } else if (round % 4 != 0) {
+            utf8_buf[(utf8_seed >> 8) % len] = (unsigned char)(utf8_seed >> 20);
+        }
+        
+        utf8_ok = guiarstr_utf8_error_offset((const char*)utf8_buf, len) == utf8_reference_error(utf8_buf, len);
+    }
+    ASSERT_TRUE(utf8_ok);
     
     ASSERT_EQ_SIZE(guiarstr_utf8_width("hello"), 5);
     ASSERT_EQ_SIZE(guiarstr_utf8_width("مرحبا"), 5);